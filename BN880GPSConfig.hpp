@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2024 Mikhail Sapozhnikov
+ * Copyright (C) 2024 - 2026 Mikhail Sapozhnikov
  *
  * This file is part of ship-position.
  *
@@ -22,6 +22,7 @@
 #define BN880GPSCONFIG_HPP
 
 #include <string>
+#include <vector>
 #include <cstdint>
 
 namespace ship_position
@@ -30,10 +31,35 @@ namespace ship_position
 struct BN880GPSConfig
 {
     std::string devPath;
-    uint64_t bufferSize;
-    int maxRetries;
+    uint64_t bufferSize = 4096;
+    int maxRetries = 3;
+    // raw receiver output is recorded into numbered segments <rawOutput>.000001, ...
     std::string rawOutput;
-    uint64_t maxRawFileSize;
+    // segment size limit, 0 records into a single segment
+    uint64_t maxRawFileSize = 1048576;
+    // number of newest segments kept, 0 keeps all; on tmpfs, such as /var/run, they take up RAM
+    uint32_t rawSegments = 1;
+    // records every read with its CLOCK_MONOTONIC time, so that replay keeps the original timing
+    bool rawTimestamps = false;
+    // file recorded with rawOutput to replay instead of reading the receiver, "" reads the receiver
+    std::string replayFile;
+    // 1 replays in real time, N - N times faster, 0 - as fast as possible
+    double replaySpeed = 1.0;
+    // "nmea" keeps the factory output, "ubx" switches to UBX NAV-PVT and NAV-DOP only
+    std::string protocol = "nmea";
+    // navigation solutions per second, up to 1000, 0 keeps the current rate
+    uint32_t measurementRate = 0;
+    // receiver and local port speed, 0 keeps the current speed
+    uint32_t baudRate = 0;
+    // speed the port is opened at (9600 for BN-880 factory settings), 0 keeps the tty's speed
+    uint32_t portBaudRate = 0;
+    // termios VMIN (up to 64) and VTIME, tenths of a second
+    uint32_t vmin = 1;
+    uint32_t vtime = 0;
+    // ASYNC_LOW_LATENCY on the serial driver, if supported
+    bool lowLatency = false;
+    // GGA, GLL, GSA, GSV, RMC, VTG, ZDA, NAV-DOP, NAV-PVT; empty list keeps the receiver's settings
+    std::vector<std::string> messages;
 };
 
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2024 Mikhail Sapozhnikov
+ * Copyright (C) 2024 - 2026 Mikhail Sapozhnikov
  *
  * This file is part of ship-position.
  *
@@ -19,30 +19,162 @@
  */
 
 #include "BN880GPSReader.hpp"
+#include "MethodWrapper.hpp"
+#include "Clock.hpp"
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <fcntl.h>
 #include <errno.h>
 #include <termios.h>
 #include <unistd.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <linux/serial.h>
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <cstdint>
 #include <exception>
 
 namespace ship_position
 {
 
+namespace
+{
+
+struct BaudRate
+{
+    speed_t speed;
+    uint32_t baud;
+};
+
+constexpr BaudRate BAUD_RATES[] = {
+    {B4800, 4800}, {B9600, 9600}, {B19200, 19200}, {B38400, 38400},
+    {B57600, 57600}, {B115200, 115200}, {B230400, 230400}, {B460800, 460800}
+};
+
+// BN-880 defaults to 9600 baud
+uint32_t speedToBaud(speed_t speed)
+{
+    for (const BaudRate &rate : BAUD_RATES)
+    {
+        if (rate.speed == speed)
+        {
+            return rate.baud;
+        }
+    }
+    return 9600;
+}
+
+// returns B0 for unsupported rates
+speed_t baudToSpeed(uint32_t baud)
+{
+    for (const BaudRate &rate : BAUD_RATES)
+    {
+        if (rate.baud == baud)
+        {
+            return rate.speed;
+        }
+    }
+    return B0;
+}
+
+struct ReceiverMessage
+{
+    const char *name;
+    uint8_t msgClass;
+    uint8_t msgId;
+    // typical size on the wire, for the bandwidth estimate
+    uint32_t bytes;
+};
+
+// messages which can be enabled with BN880GPSConfig::messages, all others are disabled
+constexpr ReceiverMessage RECEIVER_MESSAGES[] = {
+    {"GGA", UBXParser::CLASS_NMEA, 0x00, 75},
+    {"GLL", UBXParser::CLASS_NMEA, 0x01, 52},
+    {"GSA", UBXParser::CLASS_NMEA, 0x02, 66},
+    // 3-4 sentences per system
+    {"GSV", UBXParser::CLASS_NMEA, 0x03, 560},
+    {"RMC", UBXParser::CLASS_NMEA, 0x04, 72},
+    {"VTG", UBXParser::CLASS_NMEA, 0x05, 40},
+    {"ZDA", UBXParser::CLASS_NMEA, 0x08, 38},
+    {"NAV-DOP", UBXParser::CLASS_NAV, UBXParser::ID_NAV_DOP, 26},
+    {"NAV-PVT", UBXParser::CLASS_NAV, UBXParser::ID_NAV_PVT, 100}
+};
+
+void putU2(std::vector<uint8_t> &payload, uint16_t value)
+{
+    payload.push_back(value & 0xff);
+    payload.push_back(value >> 8);
+}
+
+void putU4(std::vector<uint8_t> &payload, uint32_t value)
+{
+    putU2(payload, value & 0xffff);
+    putU2(payload, value >> 16);
+}
+
+// hands the next NMEA or UBX frame to its parser, returns number of bytes consumed
+inline size_t feedParsers(NMEAStreamParser &streamParser, UBXParser &ubxParser, const char *data, size_t length)
+{
+    if (!ubxParser.idle())
+    {
+        return ubxParser.feed(data, length);
+    }
+    else if (!streamParser.idle() || (data[0] == '$'))
+    {
+        return streamParser.feed(data, length);
+    }
+    else if (static_cast<uint8_t>(data[0]) == UBXParser::SYNC_CHAR_1)
+    {
+        return ubxParser.feed(data, length);
+    }
+    // line terminators and noise between frames
+    return 1;
+}
+
+}
+
 BN880GPSReader::BN880GPSReader(const BN880GPSConfig &config) :
-    _readErrors(0),
     _config(config),
     _fd(-1),
-    _rawfd(-1)
+    _recorder(nullptr),
+    _recordBuffer(nullptr),
+    _eventfd(-1),
+    _streamParser(methodWrapper<BN880GPSReader, void, std::string_view, NMEAStreamParser::Status>(this,
+        &BN880GPSReader::onSentence)),
+    _ubxParser(methodWrapper<BN880GPSReader, void, uint8_t, uint8_t, const uint8_t*, size_t>(this,
+        &BN880GPSReader::onUBXMessage)),
+    _readErrors(0),
+    _numReads(0),
+    _arrivalNs(0),
+    _gpsInfoUpdated(false),
+    _sentencesParsed(false),
+    _satellitesUpdated(false),
+    _lastSentenceNs(0),
+    _satellitesArrivalNs(0)
 {
     _log = Log::getInstance();
     _log->write(LogLevel::DEBUG, "BN880GPSReader ctor\n");
     _readbuf = new char[config.bufferSize];
+    _eventfd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (_eventfd == -1)
+    {
+        _log->write(LogLevel::ERROR, "BN880GPSReader failed to create eventfd, error=%d\n", errno);
+    }
+    if (config.replayFile != "")
+    {
+        // the receiver is neither opened nor recorded while replaying
+        _log->write(LogLevel::NOTICE, "BN880GPSReader: replaying %s\n", config.replayFile.c_str());
+        return;
+    }
     init(config.devPath);
     if (config.rawOutput != "")
     {
-        setupRawOutput(config.rawOutput);
+        _recorder = new RawRecorder(config.rawOutput, config.bufferSize, config.maxRawFileSize, config.rawSegments,
+            config.rawTimestamps);
     }
 }
 
@@ -52,11 +184,13 @@ BN880GPSReader::~BN880GPSReader()
     {
         close(_fd);
     }
-    delete _readbuf;
+    delete[] _readbuf;
+
+    delete _recorder;
 
-    if (_rawfd!= -1)
+    if (_eventfd != -1)
     {
-        close(_rawfd);
+        close(_eventfd);
     }
 
     Log::release();
@@ -66,15 +200,12 @@ void BN880GPSReader::init(const std::string &devPath)
 {
     _log->write(LogLevel::DEBUG, "BN880GPSReader::init(), devPath=%s\n", devPath.c_str());
 
-    _fd = open(devPath.c_str(), O_RDWR, 0);
+    _fd = open(devPath.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK, 0);
 
     if (_fd != -1)
     {
-        struct termios options;
-        tcgetattr(_fd, &options);
-        options.c_lflag &= ~(ECHO | ECHONL | ICANON | ISIG | IEXTEN);
-        options.c_oflag &= ~(ONLCR | OCRNL);
-        tcsetattr(_fd, TCSANOW, &options);
+        setupSerialPort();
+        configureReceiver();
     }
     else
     {
@@ -82,17 +213,98 @@ void BN880GPSReader::init(const std::string &devPath)
     }
 }
 
+void BN880GPSReader::setupSerialPort()
+{
+    struct termios options;
+    if (tcgetattr(_fd, &options) == -1)
+    {
+        _log->write(LogLevel::ERROR, "BN880GPSReader failed to get serial port attributes, error=%d\n", errno);
+        return;
+    }
+
+    // raw 8N1 without flow control, UBX is binary
+    cfmakeraw(&options);
+    options.c_cflag |= CLOCAL | CREAD;
+    options.c_cflag &= ~(CSTOPB | CRTSCTS);
+    options.c_iflag &= ~(IXON | IXOFF | IXANY);
+
+    // n_tty applies VMIN to each 64 byte piece, a larger VMIN would wait for VTIME
+    cc_t vmin = static_cast<cc_t>(std::min<uint32_t>(_config.vmin, MAX_VMIN));
+    if ((vmin > 1) && (_config.vtime == 0))
+    {
+        // the reader would block until vmin bytes arrive, stop() included
+        _log->write(LogLevel::ERROR, "BN880GPSReader: vmin %u requires vtime, using vmin 1\n", vmin);
+        vmin = 1;
+    }
+    options.c_cc[VMIN] = vmin;
+    options.c_cc[VTIME] = static_cast<cc_t>(std::min<uint32_t>(_config.vtime, 255));
+
+    if (_config.portBaudRate != 0)
+    {
+        speed_t speed = baudToSpeed(_config.portBaudRate);
+        if (speed != B0)
+        {
+            cfsetispeed(&options, speed);
+            cfsetospeed(&options, speed);
+        }
+        else
+        {
+            _log->write(LogLevel::ERROR, "BN880GPSReader: unsupported baud rate %u\n", _config.portBaudRate);
+        }
+    }
+
+    if (tcsetattr(_fd, TCSANOW, &options) == -1)
+    {
+        _log->write(LogLevel::ERROR, "BN880GPSReader failed to set serial port attributes, error=%d\n", errno);
+    }
+    tcflush(_fd, TCIFLUSH);
+
+    // opened non-blocking to skip waiting for carrier, VMIN/VTIME need blocking reads
+    int flags = fcntl(_fd, F_GETFL);
+    if ((flags == -1) || (fcntl(_fd, F_SETFL, flags & ~O_NONBLOCK) == -1))
+    {
+        _log->write(LogLevel::ERROR, "BN880GPSReader failed to clear O_NONBLOCK, error=%d\n", errno);
+    }
+
+    if (_config.lowLatency)
+    {
+        // not every driver supports it (ptys and many USB adapters don't)
+        struct serial_struct serial;
+        int result = ioctl(_fd, TIOCGSERIAL, &serial);
+        if (result != -1)
+        {
+            serial.flags |= ASYNC_LOW_LATENCY;
+            result = ioctl(_fd, TIOCSSERIAL, &serial);
+        }
+        if (result == -1)
+        {
+            _log->write(LogLevel::NOTICE, "BN880GPSReader: low latency mode not supported, error=%d\n", errno);
+        }
+    }
+}
+
 void BN880GPSReader::run()
 {
     _log->write(LogLevel::DEBUG, "BN880GPSReader::run()\n");
 
-    if (_fd == -1)
+    if (_config.replayFile != "")
+    {
+        runReplay();
+        return;
+    }
+
+    if ((_fd == -1) || (_eventfd == -1))
     {
         _log->write(LogLevel::ERROR, "bn880 gps device not initialized, run() quitting\n");
         return;
     }
 
-    NMEAParser nmeaParser;
+    // wait for either serial data or a stop request, data is processed as soon as it arrives
+    struct pollfd fds[2];
+    fds[0].fd = _fd;
+    fds[0].events = POLLIN;
+    fds[1].fd = _eventfd;
+    fds[1].events = POLLIN;
 
     while (true)
     {
@@ -102,76 +314,531 @@ void BN880GPSReader::run()
             break;
         }
 
-        int numRead = read(_fd, _readbuf, _config.bufferSize);
-        if (numRead == -1)
+        fds[0].revents = 0;
+        fds[1].revents = 0;
+        if (poll(fds, 2, -1) == -1)
+        {
+            if (errno != EINTR)
+            {
+                _log->write(LogLevel::ERROR, "BN880GPSReader failed to poll bn880 gps device, error=%d\n", errno);
+                break;
+            }
+            continue;
+        }
+
+        if (fds[1].revents & POLLIN)
+        {
+            _log->write(LogLevel::DEBUG, "BN880GPSReader::run() stopping\n");
+            break;
+        }
+
+        if (fds[0].revents == 0)
+        {
+            continue;
+        }
+
+        // read straight into a recorder buffer, handed over to the writer thread by pointer
+        if ((_recorder != nullptr) && (_recordBuffer == nullptr))
+        {
+            _recordBuffer = _recorder->acquire();
+        }
+        char *readbuf = (_recordBuffer != nullptr) ? _recordBuffer->data : _readbuf;
+
+        // hangup or error without data, e.g. the USB adapter was unplugged
+        int numRead = -1;
+        int error = EIO;
+        if (fds[0].revents & POLLIN)
         {
-            _log->write(LogLevel::ERROR, "failed to read from bn880 gps device, error=%d\n", errno);
+            numRead = read(_fd, readbuf, _config.bufferSize);
+            error = (numRead == 0) ? EIO : errno;
+        }
+        if (numRead <= 0)
+        {
+            if ((numRead == -1) && ((error == EAGAIN) || (error == EINTR)))
+            {
+                continue;
+            }
+
+            // end of file is an error too, the descriptor stays readable and would keep poll() spinning
+            _log->write(LogLevel::ERROR, "failed to read from bn880 gps device, error=%d, revents=0x%x\n", error,
+                fds[0].revents);
             _readErrors++;
             if ((_config.maxRetries != 0) && (_readErrors == _config.maxRetries))
             {
                 _log->write(LogLevel::ERROR, "bn880gps reader: too many read errors, quitting\n");
                 return;
             }
+            // the device stays readable while in error state, so back off before retrying
+            if (waitForStop(RETRY_TIMEOUT_MS))
+            {
+                break;
+            }
             continue;
         }
-        else
+
+        _log->write(LogLevel::DEBUG, "read %d bytes from bn880 gps device\n", numRead);
+        _readErrors = 0;
+        _numReads++;
+        // sentences split between reads are completed by the stream parser on the next read
+        processInput(readbuf, numRead, monotonicNs());
+
+        if (_recordBuffer != nullptr)
+        {
+            _recorder->submit(_recordBuffer, numRead);
+            _recordBuffer = nullptr;
+        }
+        else if (_recorder != nullptr)
         {
-            _log->write(LogLevel::DEBUG, "read %d bytes from bn880 gps device\n", numRead);
-            _readErrors = 0;
-            std::string nmeaData(_readbuf, numRead);
-            std::unique_lock<std::shared_mutex> lock(_gpsInfoMutex);
-            nmeaParser.parse(nmeaData, _gpsInfo);
-            writeRawOutput(nmeaData);
+            // the writer fell behind
+            _recorder->drop(numRead);
         }
+    }
+}
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+void BN880GPSReader::start()
+{
+    if (_recorder != nullptr)
+    {
+        _recorder->start();
     }
+    SingleThread::start();
 }
 
-void BN880GPSReader::getGPSInfo(GPSInfo &gpsInfo)
+void BN880GPSReader::stop()
 {
-    std::shared_lock<std::shared_mutex> lock(_gpsInfoMutex);
-    gpsInfo = _gpsInfo;
+    if (_eventfd != -1)
+    {
+        uint64_t value = 1;
+        if (write(_eventfd, &value, sizeof(value)) == -1)
+        {
+            _log->write(LogLevel::ERROR, "BN880GPSReader failed to signal eventfd, error=%d\n", errno);
+        }
+    }
+
+    SingleThread::stop();
+
+    // the reader is gone, so everything it submitted gets flushed
+    if (_recorder != nullptr)
+    {
+        _recorder->stop();
+    }
+
+    // drain the eventfd, so that the reader can be started again
+    if (_eventfd != -1)
+    {
+        uint64_t value;
+        if ((read(_eventfd, &value, sizeof(value)) == -1) && (errno != EAGAIN))
+        {
+            _log->write(LogLevel::ERROR, "BN880GPSReader failed to drain eventfd, error=%d\n", errno);
+        }
+    }
+}
+
+bool BN880GPSReader::waitForStop(int timeoutMs)
+{
+    struct pollfd pfd;
+    pfd.fd = _eventfd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    return (poll(&pfd, 1, timeoutMs) > 0) && (pfd.revents & POLLIN);
 }
 
-void BN880GPSReader::setupRawOutput(const std::string &rawOutputPath)
+bool BN880GPSReader::waitForStopUntil(uint64_t deadlineNs)
 {
-    _rawfd = open(rawOutputPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0664);
-    if (_rawfd == -1)
+    uint64_t now = monotonicNs();
+    if (now >= deadlineNs)
     {
-        _log->write(LogLevel::ERROR, "failed to open raw output file %s, error=%d\n", rawOutputPath.c_str(), errno);
+        return false;
     }
+
+    struct pollfd pfd;
+    pfd.fd = _eventfd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    struct timespec timeout;
+    timeout.tv_sec = (deadlineNs - now) / 1000000000ULL;
+    timeout.tv_nsec = (deadlineNs - now) % 1000000000ULL;
+
+    return (ppoll(&pfd, 1, &timeout, nullptr) > 0) && (pfd.revents & POLLIN);
 }
 
-void BN880GPSReader::writeRawOutput(const std::string &rawData)
+void BN880GPSReader::runReplay()
 {
-    if (_rawfd != -1)
+    int fd = open(_config.replayFile.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        _log->write(LogLevel::ERROR, "BN880GPSReader failed to open replay file %s, error=%d\n",
+            _config.replayFile.c_str(), errno);
+        return;
+    }
+
+    struct stat st;
+    if ((fstat(fd, &st) == -1) || (st.st_size == 0))
     {
-        // check raw output file size and truncate if necessary
-        if (_config.maxRawFileSize != 0)
+        _log->write(LogLevel::ERROR, "BN880GPSReader: replay file %s is empty or unreadable\n",
+            _config.replayFile.c_str());
+        close(fd);
+        return;
+    }
+
+    // the file is parsed in place, without copying it into read buffers
+    size_t size = st.st_size;
+    void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        _log->write(LogLevel::ERROR, "BN880GPSReader failed to map replay file, error=%d\n", errno);
+        return;
+    }
+    madvise(mapping, size, MADV_SEQUENTIAL);
+    const char *data = static_cast<const char*>(mapping);
+
+    // timestamped recordings keep their original timing, plain ones go at the configured speed
+    const size_t magicSize = sizeof(RawRecorder::TIMESTAMPED_MAGIC);
+    bool timestamped = (size >= magicSize) && (memcmp(data, RawRecorder::TIMESTAMPED_MAGIC, magicSize) == 0);
+    uint32_t baud = (_config.baudRate != 0) ? _config.baudRate :
+        ((_config.portBaudRate != 0) ? _config.portBaudRate : 9600);
+    double speed = _config.replaySpeed;
+
+    uint64_t start = monotonicNs();
+    uint64_t firstTimestamp = 0;
+    ReplayStatistics statistics;
+    size_t pos = timestamped ? magicSize : 0;
+    bool stopped = false;
+
+    while (pos < size)
+    {
+        const char *chunk;
+        size_t length;
+        uint64_t offsetNs;
+        if (timestamped)
         {
-            struct stat st;
-            if (fstat(_rawfd, &st) == -1)
+            RawRecorder::RecordHeader header;
+            if (size - pos < sizeof(header))
             {
-                _log->write(LogLevel::ERROR, "BN880GPSReader failed to stat raw output file, error=%d\n", errno);
-                return;
+                break;
             }
-            if (st.st_size > _config.maxRawFileSize)
+            memcpy(&header, data + pos, sizeof(header));
+            pos += sizeof(header);
+            if (size - pos < header.length)
             {
-                _log->write(LogLevel::DEBUG, "BN880GPSReader: raw output file size exceeded, truncating\n");
-                if (ftruncate(_rawfd, 0) == -1)
-                {
-                    _log->write(LogLevel::ERROR, "BN880GPSReader failed to truncate raw output file, error=%d\n", errno);
-                    return;
-                }
+                _log->write(LogLevel::ERROR, "BN880GPSReader: replay file ends in the middle of a record\n");
+                break;
             }
+            if (statistics.records == 0)
+            {
+                firstTimestamp = header.timestamp;
+            }
+            chunk = data + pos;
+            length = header.length;
+            offsetNs = header.timestamp - firstTimestamp;
+        }
+        else
+        {
+            chunk = data + pos;
+            length = std::min<size_t>(_config.bufferSize, size - pos);
+            // 10 bits per byte with 8N1, the chunk is available once its last byte arrived
+            offsetNs = (pos + length) * 10ULL * 1000000000ULL / baud;
         }
+        pos += length;
 
-        if (write(_rawfd, rawData.c_str(), rawData.length()) == -1)
+        if ((speed > 0.0) && waitForStopUntil(start + static_cast<uint64_t>(offsetNs / speed)))
         {
-            _log->write(LogLevel::ERROR, "BN880GPSReader failed to write to raw output file, error=%d\n", errno);
+            stopped = true;
+            break;
         }
+
+        processInput(chunk, length, monotonicNs());
+        statistics.records++;
+        statistics.bytes += length;
+        statistics.elapsedNs = monotonicNs() - start;
+        _replayStatistics.store(statistics);
+    }
+
+    munmap(mapping, size);
+
+    statistics.finished = !stopped;
+    _replayStatistics.store(statistics);
+    double seconds = statistics.elapsedNs / 1e9;
+    _log->write(LogLevel::NOTICE, "BN880GPSReader: replayed %llu bytes in %llu reads, %.3f s, %.2f MB/s\n",
+        static_cast<unsigned long long>(statistics.bytes), static_cast<unsigned long long>(statistics.records),
+        seconds, (seconds > 0.0) ? statistics.bytes / seconds / 1e6 : 0.0);
+}
+
+void BN880GPSReader::getReplayStatistics(ReplayStatistics &statistics)
+{
+    _replayStatistics.load(statistics);
+}
+
+void BN880GPSReader::configureReceiver()
+{
+    _log->write(LogLevel::DEBUG, "BN880GPSReader::configureReceiver()\n");
+
+    bool ubxOnly = (_config.protocol == "ubx");
+    std::vector<std::string> messages = _config.messages;
+    if (messages.empty() && ubxOnly)
+    {
+        messages = {"NAV-PVT", "NAV-DOP"};
     }
+
+    if (_config.measurementRate > MAX_MEASUREMENT_RATE)
+    {
+        _log->write(LogLevel::ERROR, "BN880GPSReader: measurement rate %u Hz out of range 1-%u, keeping current\n",
+            _config.measurementRate, MAX_MEASUREMENT_RATE);
+    }
+
+    struct termios options;
+    if (tcgetattr(_fd, &options) == -1)
+    {
+        _log->write(LogLevel::ERROR, "BN880GPSReader failed to get serial port attributes, receiver not configured, "
+            "error=%d\n", errno);
+        return;
+    }
+    uint32_t portBaud = speedToBaud(cfgetospeed(&options));
+    uint32_t baud = (_config.baudRate != 0) ? _config.baudRate : portBaud;
+    if (baudToSpeed(baud) == B0)
+    {
+        _log->write(LogLevel::ERROR, "BN880GPSReader: unsupported baud rate %u\n", baud);
+        return;
+    }
+
+    // the receiver keeps CFG-PRT while powered, so it may already talk at the configured speed
+    if (baud != portBaud)
+    {
+        if (setPortBaud(baud) && receiverTalks())
+        {
+            _log->write(LogLevel::NOTICE, "BN880GPSReader: receiver already at %u baud\n", baud);
+            portBaud = baud;
+        }
+        else if (!setPortBaud(portBaud))
+        {
+            return;
+        }
+    }
+
+    // CFG-MSG class, id, rate per navigation solution, an empty list keeps the receiver's messages
+    uint32_t bytesPerSolution = 0;
+    if (!messages.empty())
+    {
+        for (const ReceiverMessage &message : RECEIVER_MESSAGES)
+        {
+            bool enabled = std::find(messages.begin(), messages.end(), message.name) != messages.end();
+            if (enabled)
+            {
+                bytesPerSolution += message.bytes;
+            }
+            sendUBX(UBXParser::CLASS_CFG, UBXParser::ID_CFG_MSG,
+                {message.msgClass, message.msgId, static_cast<uint8_t>(enabled ? 1 : 0)});
+        }
+    }
+
+    if ((_config.measurementRate != 0) && (_config.measurementRate <= MAX_MEASUREMENT_RATE))
+    {
+        // CFG-RATE: measurement period in ms, one navigation solution per measurement, UTC time reference
+        std::vector<uint8_t> payload;
+        putU2(payload, 1000 / _config.measurementRate);
+        putU2(payload, 1);
+        putU2(payload, 0);
+        sendUBX(UBXParser::CLASS_CFG, UBXParser::ID_CFG_RATE, payload);
+
+        // 10 bits per byte with 8N1
+        uint32_t rate = _config.measurementRate;
+        if (bytesPerSolution * rate * 10 > baud)
+        {
+            _log->write(LogLevel::ERROR, "BN880GPSReader: %u bytes at %u Hz won't fit into %u baud\n",
+                bytesPerSolution, rate, baud);
+        }
+    }
+
+    if ((_config.baudRate == 0) && !ubxOnly)
+    {
+        return;
+    }
+
+    // CFG-PRT: UART1, 8N1, UBX and NMEA in, UBX only or both out
+    std::vector<uint8_t> payload;
+    putU4(payload, 1);
+    putU4(payload, 0x000008d0);
+    putU4(payload, baud);
+    putU2(payload, 0x0003);
+    putU2(payload, ubxOnly ? 0x0001 : 0x0003);
+    putU4(payload, 0);
+    sendUBX(UBXParser::CLASS_CFG, UBXParser::ID_CFG_PRT, payload);
+
+    // the receiver switches right after the message, so let it go out at the old speed first
+    tcdrain(_fd);
+    if (baud != portBaud)
+    {
+        setPortBaud(baud);
+    }
+}
+
+bool BN880GPSReader::setPortBaud(uint32_t baud)
+{
+    struct termios options;
+    speed_t speed = baudToSpeed(baud);
+    if ((speed == B0) || (tcgetattr(_fd, &options) == -1))
+    {
+        _log->write(LogLevel::ERROR, "BN880GPSReader failed to set baud rate %u, error=%d\n", baud, errno);
+        return false;
+    }
+    cfsetispeed(&options, speed);
+    cfsetospeed(&options, speed);
+    if (tcsetattr(_fd, TCSANOW, &options) == -1)
+    {
+        _log->write(LogLevel::ERROR, "BN880GPSReader failed to set baud rate %u, error=%d\n", baud, errno);
+        return false;
+    }
+    return true;
+}
+
+bool BN880GPSReader::receiverTalks()
+{
+    // whatever came in at the previous speed is garbage
+    tcflush(_fd, TCIFLUSH);
+
+    bool valid = false;
+    NMEAStreamParser streamParser([&valid](std::string_view, NMEAStreamParser::Status status)
+    {
+        valid = valid || (status == NMEAStreamParser::Status::VALID);
+    });
+    UBXParser ubxParser([&valid](uint8_t, uint8_t, const uint8_t*, size_t)
+    {
+        valid = true;
+    });
+
+    struct pollfd fds;
+    fds.fd = _fd;
+    fds.events = POLLIN;
+    char buf[256];
+    uint64_t deadline = monotonicNs() + PROBE_TIMEOUT_MS * 1000000ULL;
+    uint64_t now;
+    while (!valid && ((now = monotonicNs()) < deadline))
+    {
+        int timeoutMs = static_cast<int>((deadline - now + 999999) / 1000000);
+        if ((poll(&fds, 1, timeoutMs) <= 0) || !(fds.revents & POLLIN))
+        {
+            continue;
+        }
+        ssize_t numRead = read(_fd, buf, sizeof(buf));
+        if (numRead <= 0)
+        {
+            // the main loop deals with a broken device
+            break;
+        }
+        for (ssize_t pos = 0; !valid && (pos < numRead); )
+        {
+            pos += feedParsers(streamParser, ubxParser, buf + pos, numRead - pos);
+        }
+    }
+    return valid;
+}
+
+void BN880GPSReader::sendUBX(uint8_t msgClass, uint8_t msgId, const std::vector<uint8_t> &payload)
+{
+    std::vector<uint8_t> frame = UBXParser::makeFrame(msgClass, msgId, payload);
+    if (write(_fd, frame.data(), frame.size()) != static_cast<ssize_t>(frame.size()))
+    {
+        _log->write(LogLevel::ERROR, "BN880GPSReader failed to send UBX message %02x %02x, error=%d\n",
+            msgClass, msgId, errno);
+    }
+}
+
+void BN880GPSReader::processInput(const char *data, size_t length, uint64_t arrivalNs)
+{
+    _arrivalNs = arrivalNs;
+    _gpsInfoUpdated = false;
+    _sentencesParsed = false;
+    _satellitesUpdated = false;
+    size_t pos = 0;
+    while (pos < length)
+    {
+        pos += feedParsers(_streamParser, _ubxParser, data + pos, length - pos);
+    }
+
+    publish();
+}
+
+void BN880GPSReader::publish()
+{
+    if (_gpsInfoUpdated)
+    {
+        _gpsInfo.publishNs = monotonicNs();
+        _gpsInfoSnapshot.store(_gpsInfo);
+    }
+
+    if (_sentencesParsed)
+    {
+        NMEAStatistics statistics = _nmeaParser.getStatistics();
+        statistics.lastArrivalNs = _lastSentenceNs;
+        _statisticsSnapshot.store(statistics);
+    }
+
+    if (_satellitesUpdated)
+    {
+        SatelliteTable satellites = _nmeaParser.getSatellites();
+        satellites.arrivalNs = _satellitesArrivalNs;
+        _satellitesSnapshot.store(satellites);
+    }
+}
+
+void BN880GPSReader::onSentence(std::string_view sentence, NMEAStreamParser::Status status)
+{
+    _lastSentenceNs = _arrivalNs;
+    _sentencesParsed = true;
+    bool valid = (status == NMEAStreamParser::Status::VALID);
+    // satellites in view are timed separately, they don't change the fix
+    bool satellites = valid &&
+        (std::string_view(NMEAStatistics::TYPES[NMEAStatistics::typeIndex(sentence)]) == "GSV");
+    if (valid && !satellites)
+    {
+        // stamped before parsing, so that the parser stamps a position in the sentence with it too
+        _gpsInfo.arrivalNs = _arrivalNs;
+        _gpsInfoUpdated = true;
+    }
+
+    _nmeaParser.parseSentence(sentence, status, _gpsInfo);
+    if (satellites)
+    {
+        _satellitesArrivalNs = _arrivalNs;
+        _satellitesUpdated = true;
+    }
+}
+
+void BN880GPSReader::onUBXMessage(uint8_t msgClass, uint8_t msgId, const uint8_t *payload, size_t length)
+{
+    if ((msgClass != UBXParser::CLASS_NAV) || ((msgId != UBXParser::ID_NAV_PVT) && (msgId != UBXParser::ID_NAV_DOP)))
+    {
+        return;
+    }
+
+    // stamped before decoding, like NMEA sentences
+    _gpsInfo.arrivalNs = _arrivalNs;
+    _gpsInfoUpdated = true;
+    if (msgId == UBXParser::ID_NAV_PVT)
+    {
+        UBXParser::decodeNavPVT(payload, length, _gpsInfo);
+    }
+    else
+    {
+        UBXParser::decodeNavDOP(payload, length, _gpsInfo);
+    }
+}
+
+void BN880GPSReader::getGPSInfo(GPSInfo &gpsInfo)
+{
+    _gpsInfoSnapshot.load(gpsInfo);
+}
+
+void BN880GPSReader::getNMEAStatistics(NMEAStatistics &statistics)
+{
+    _statisticsSnapshot.load(statistics);
+}
+
+void BN880GPSReader::getSatellites(SatelliteTable &satellites)
+{
+    _satellitesSnapshot.load(satellites);
 }
 
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2024 Mikhail Sapozhnikov
+ * Copyright (C) 2024 - 2026 Mikhail Sapozhnikov
  *
  * This file is part of ship-position.
  *
@@ -26,11 +26,33 @@
 #include "GPSReader.hpp"
 #include "Log.hpp"
 #include "NMEAParser.hpp"
-#include <shared_mutex>
+#include "NMEAStreamParser.hpp"
+#include "UBXParser.hpp"
+#include "RawRecorder.hpp"
+#include "Seqlock.hpp"
+#include <atomic>
 
 namespace ship_position
 {
 
+struct ReplayStatistics
+{
+    uint64_t records;
+    uint64_t bytes;
+    // since the replay started
+    uint64_t elapsedNs;
+    // true once the whole file was replayed
+    bool finished;
+
+    ReplayStatistics()
+    {
+        records = 0;
+        bytes = 0;
+        elapsedNs = 0;
+        finished = false;
+    }
+};
+
 class BN880GPSReader : public SingleThread, public GPSReader
 {
 public:
@@ -38,21 +60,77 @@ public:
     virtual ~BN880GPSReader();
 
     virtual void run();
+    virtual void start();
+    virtual void stop();
 
     virtual void getGPSInfo(GPSInfo &gpsInfo);
+    virtual void getNMEAStatistics(NMEAStatistics &statistics);
+    virtual void getSatellites(SatelliteTable &satellites);
+    void getReplayStatistics(ReplayStatistics &statistics);
+
+    // delay between retries after a failed read, in milliseconds
+    static constexpr int RETRY_TIMEOUT_MS = 1000;
+    // largest VMIN that still returns a whole burst from one read()
+    static constexpr uint32_t MAX_VMIN = 64;
+    // how long to listen for the receiver at the configured baud rate, it outputs at least once a second
+    static constexpr int PROBE_TIMEOUT_MS = 1200;
+    // the receiver's limit for CFG-RATE, one measurement per millisecond
+    static constexpr uint32_t MAX_MEASUREMENT_RATE = 1000;
 protected:
     void init(const std::string &devPath);
-    void setupRawOutput(const std::string &rawOutputPath);
-    void writeRawOutput(const std::string &rawData);
+    // raw mode, speed, VMIN/VTIME and low latency flag from the config
+    void setupSerialPort();
+    // returns true if stop was requested within timeoutMs
+    bool waitForStop(int timeoutMs);
+    // same with an absolute CLOCK_MONOTONIC deadline
+    bool waitForStopUntil(uint64_t deadlineNs);
+    // feeds the recorded replayFile through the parsers instead of the receiver
+    void runReplay();
+    // pushes messages, measurement rate and port settings to the receiver
+    void configureReceiver();
+    // switches the local port to baud, returns false if it can't
+    bool setPortBaud(uint32_t baud);
+    // returns true if a valid NMEA sentence or UBX message arrives within PROBE_TIMEOUT_MS
+    bool receiverTalks();
+    void sendUBX(uint8_t msgClass, uint8_t msgId, const std::vector<uint8_t> &payload);
+    // hands serial data over to NMEA and UBX parsers
+    void processInput(const char *data, size_t length, uint64_t arrivalNs);
+    // copies what the last input changed into the snapshots read by other threads
+    void publish();
+    void onSentence(std::string_view sentence, NMEAStreamParser::Status status);
+    void onUBXMessage(uint8_t msgClass, uint8_t msgId, const uint8_t *payload, size_t length);
 
     const BN880GPSConfig &_config;
     int _fd;
-    int _rawfd;
+    // nullptr unless rawOutput is configured
+    RawRecorder *_recorder;
+    // buffer the next read goes to, owned by the reader thread until submitted
+    RawRecorder::Buffer *_recordBuffer;
+    // used to wake up the reader thread on stop()
+    int _eventfd;
     Log *_log;
     char *_readbuf;
+    NMEAParser _nmeaParser;
+    NMEAStreamParser _streamParser;
+    UBXParser _ubxParser;
     int _readErrors;
+    // successful read() calls
+    std::atomic<uint64_t> _numReads;
+    // CLOCK_MONOTONIC time the data being parsed was read
+    uint64_t _arrivalNs;
+    // what processInput() changed, to be published
+    bool _gpsInfoUpdated;
+    bool _sentencesParsed;
+    bool _satellitesUpdated;
+    uint64_t _lastSentenceNs;
+    uint64_t _satellitesArrivalNs;
+    // updated in place by the parsers, owned by the reader thread
     GPSInfo _gpsInfo;
-    std::shared_mutex _gpsInfoMutex;
+    // published once per read, getters copy from these without locking
+    Seqlock<GPSInfo> _gpsInfoSnapshot;
+    Seqlock<NMEAStatistics> _statisticsSnapshot;
+    Seqlock<SatelliteTable> _satellitesSnapshot;
+    Seqlock<ReplayStatistics> _replayStatistics;
 };
 
 }
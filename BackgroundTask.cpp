@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "BackgroundTask.hpp"
+#include <errno.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <cstdint>
+
+namespace ship_position
+{
+
+BackgroundTask::BackgroundTask(Task task) :
+    _task(task),
+    _eventfd(-1),
+    _triggered(false),
+    _stopRequested(false)
+{
+    _log = Log::getInstance();
+    _eventfd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (_eventfd == -1)
+    {
+        _log->write(LogLevel::ERROR, "BackgroundTask failed to create eventfd, error=%d\n", errno);
+    }
+}
+
+BackgroundTask::~BackgroundTask()
+{
+    stop();
+    if (_eventfd != -1)
+    {
+        close(_eventfd);
+    }
+    Log::release();
+}
+
+void BackgroundTask::run()
+{
+    if (_eventfd == -1)
+    {
+        _log->write(LogLevel::ERROR, "BackgroundTask has no eventfd, run() quitting\n");
+        return;
+    }
+
+    struct pollfd pfd;
+    pfd.fd = _eventfd;
+    pfd.events = POLLIN;
+
+    while (true)
+    {
+        pfd.revents = 0;
+        if ((poll(&pfd, 1, -1) == -1) && (errno != EINTR))
+        {
+            _log->write(LogLevel::ERROR, "BackgroundTask failed to poll eventfd, error=%d\n", errno);
+            break;
+        }
+
+        uint64_t value;
+        if (read(_eventfd, &value, sizeof(value)) == -1)
+        {
+            // EAGAIN: woken up by a signal
+            continue;
+        }
+
+        // the flag is cleared first, so that a trigger during the run is not lost
+        if (_triggered.exchange(false))
+        {
+            _task();
+        }
+        if (_stopRequested)
+        {
+            break;
+        }
+    }
+}
+
+void BackgroundTask::stop()
+{
+    _stopRequested = true;
+    uint64_t value = 1;
+    if ((_eventfd != -1) && (write(_eventfd, &value, sizeof(value)) == -1))
+    {
+        _log->write(LogLevel::ERROR, "BackgroundTask failed to signal eventfd, error=%d\n", errno);
+    }
+    SingleThread::stop();
+    _stopRequested = false;
+
+    // drain the eventfd, so that the task can be started again
+    if (_eventfd != -1)
+    {
+        uint64_t value;
+        if ((read(_eventfd, &value, sizeof(value)) == -1) && (errno != EAGAIN))
+        {
+            _log->write(LogLevel::ERROR, "BackgroundTask failed to drain eventfd, error=%d\n", errno);
+        }
+    }
+}
+
+void BackgroundTask::trigger()
+{
+    if (!_triggered.exchange(true))
+    {
+        uint64_t value = 1;
+        if ((_eventfd != -1) && (write(_eventfd, &value, sizeof(value)) == -1))
+        {
+            _log->write(LogLevel::ERROR, "BackgroundTask failed to signal eventfd, error=%d\n", errno);
+        }
+    }
+}
+
+}
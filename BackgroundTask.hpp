@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef BACKGROUNDTASK_HPP
+#define BACKGROUNDTASK_HPP
+
+#include "SingleThread.hpp"
+#include "Log.hpp"
+#include <atomic>
+#include <functional>
+
+namespace ship_position
+{
+
+// runs a task on its own thread whenever triggered, triggers while it is pending are merged
+class BackgroundTask : public SingleThread
+{
+public:
+    typedef std::function<void()> Task;
+
+    BackgroundTask(Task task);
+    virtual ~BackgroundTask();
+
+    virtual void run();
+    // a task triggered before stop() still runs
+    virtual void stop();
+
+    // never blocks: sets a flag and, if it wasn't set yet, wakes up the thread
+    void trigger();
+
+protected:
+    Task _task;
+    Log *_log;
+    // wakes up the thread on trigger() and stop()
+    int _eventfd;
+    std::atomic<bool> _triggered;
+    std::atomic<bool> _stopRequested;
+};
+
+}
+
+#endif // BACKGROUNDTASK_HPP
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "CalibrationCollector.hpp"
+#include "Heading.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ship_position
+{
+
+CalibrationCollector::CalibrationCollector(double minCoverage, double maxResidual) :
+_minCoverage(minCoverage),
+_maxResidual(maxResidual)
+{
+    reset();
+}
+
+void CalibrationCollector::reset()
+{
+    _fit.reset();
+    for (size_t sector = 0; sector < HEADING_SECTORS; sector++)
+    {
+        for (size_t band = 0; band < ELEVATION_BANDS; band++)
+        {
+            _cells[sector][band] = 0;
+        }
+    }
+    for (size_t i = 0; i < 3; i++)
+    {
+        _min[i] = 0;
+        _max[i] = 0;
+    }
+    _seen = false;
+    _snapshot = CalibrationSnapshot();
+    _snapshot.status.calibrating = true;
+}
+
+bool CalibrationCollector::add(int32_t x, int32_t y, int32_t z, double temperature)
+{
+    int32_t raw[3] = {x, y, z};
+    for (size_t i = 0; i < 3; i++)
+    {
+        _min[i] = _seen ? std::min(_min[i], raw[i]) : raw[i];
+        _max[i] = _seen ? std::max(_max[i], raw[i]) : raw[i];
+    }
+    _seen = true;
+
+    double dx = x - (_min[0] + _max[0]) / 2.0;
+    double dy = y - (_min[1] + _max[1]) / 2.0;
+    double dz = z - (_min[2] + _max[2]) / 2.0;
+    double norm = std::sqrt(dx * dx + dy * dy + dz * dz);
+    if (norm == 0.0)
+    {
+        return false;
+    }
+
+    // sectors of heading, and bands of equal height on the unit sphere, which have equal areas
+    size_t sector = static_cast<size_t>((fastAtan2(dy, dx) + M_PI) / (2.0 * M_PI) * HEADING_SECTORS);
+    size_t band = static_cast<size_t>((dz / norm + 1.0) / 2.0 * ELEVATION_BANDS);
+    sector = std::min(sector, HEADING_SECTORS - 1);
+    band = std::min(band, ELEVATION_BANDS - 1);
+
+    if (_cells[sector][band] >= CELL_CAPACITY)
+    {
+        return false;
+    }
+    _cells[sector][band]++;
+    _fit.add(x, y, z, temperature);
+    updateCoverage();
+    return true;
+}
+
+void CalibrationCollector::updateCoverage()
+{
+    CalibrationStatus &status = _snapshot.status;
+    status.samples = _fit.samples();
+    status.temperatureSpan = _fit.temperatureSpan();
+
+    size_t coveredCells = 0;
+    size_t coveredSectors = 0;
+    for (size_t sector = 0; sector < HEADING_SECTORS; sector++)
+    {
+        uint32_t sectorSamples = 0;
+        for (size_t band = 0; band < ELEVATION_BANDS; band++)
+        {
+            if (_cells[sector][band] >= COVERED_SAMPLES)
+            {
+                coveredCells++;
+            }
+            sectorSamples += _cells[sector][band];
+        }
+        if (sectorSamples >= COVERED_SAMPLES)
+        {
+            coveredSectors++;
+        }
+    }
+    status.coverage = static_cast<double>(coveredCells) / NUM_CELLS;
+    status.headingCoverage = static_cast<double>(coveredSectors) / HEADING_SECTORS;
+}
+
+void CalibrationCollector::solve(const EllipsoidFit &fit, CalibrationSnapshot &snapshot) const
+{
+    CalibrationStatus &status = snapshot.status;
+    double residual = 0.0;
+    MagnetometerCalibration calibration;
+    if (fit.solve(calibration, residual))
+    {
+        snapshot.fitValid = true;
+        snapshot.temperatureFitted = fit.fitsTemperature();
+        snapshot.horizontalFit = fit.isHorizontal();
+        snapshot.calibration = calibration;
+        status.residual = residual;
+    }
+    else
+    {
+        // a previous fit would be stale now
+        snapshot.fitValid = false;
+        snapshot.temperatureFitted = false;
+        snapshot.horizontalFit = false;
+        status.residual = -1.0;
+    }
+
+    status.complete = snapshot.fitValid && (status.headingCoverage >= _minCoverage) &&
+        (status.residual <= _maxResidual);
+}
+
+}
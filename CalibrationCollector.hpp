@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef CALIBRATIONCOLLECTOR_HPP
+#define CALIBRATIONCOLLECTOR_HPP
+
+#include "MagnetometerCalibration.hpp"
+#include "MagnetometerReader.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace ship_position
+{
+
+// progress of a calibration together with the ellipsoid fitted so far
+struct CalibrationSnapshot
+{
+    CalibrationStatus status;
+    // false until the samples determine an ellipsoid
+    bool fitValid;
+    MagnetometerCalibration calibration;
+    // the temperature changed enough for the thermal drift to be part of the fit
+    bool temperatureFitted;
+    // the sensor was only turned level, the fit corrects the horizontal components
+    bool horizontalFit;
+    // calibration run the snapshot belongs to, left to the owner of the collector
+    uint64_t generation;
+
+    CalibrationSnapshot() : fitValid(false), temperatureFitted(false), horizontalFit(false), generation(0) {}
+};
+
+// collects raw samples for calibration in fixed memory, at most CELL_CAPACITY per direction cell
+class CalibrationCollector
+{
+public:
+    static constexpr size_t HEADING_SECTORS = 12;
+    // bands of equal area from straight down to straight up
+    static constexpr size_t ELEVATION_BANDS = 6;
+    static constexpr size_t NUM_CELLS = HEADING_SECTORS * ELEVATION_BANDS;
+    static constexpr uint32_t CELL_CAPACITY = 32;
+    // a cell or sector with this many samples counts as covered
+    static constexpr uint32_t COVERED_SAMPLES = 3;
+
+    // minCoverage: fraction of heading sectors to cover, maxResidual: relative RMS residual to reach
+    CalibrationCollector(double minCoverage, double maxResidual);
+
+    void reset();
+    // returns true if the sample was accepted; updates samples and coverage of the snapshot
+    bool add(int32_t x, int32_t y, int32_t z, double temperature);
+    // fits the samples collected so far, completing the snapshot
+    void solve() { solve(_fit, _snapshot); }
+    // fits a copy of the sums, may run on another thread than add()
+    void solve(const EllipsoidFit &fit, CalibrationSnapshot &snapshot) const;
+    const CalibrationSnapshot &snapshot() const { return _snapshot; }
+    const EllipsoidFit &fit() const { return _fit; }
+
+protected:
+    void updateCoverage();
+
+    const double _minCoverage;
+    const double _maxResidual;
+    EllipsoidFit _fit;
+    uint32_t _cells[HEADING_SECTORS][ELEVATION_BANDS];
+    // raw extremes, their middle is the centre samples are binned around
+    int32_t _min[3];
+    int32_t _max[3];
+    bool _seen;
+    CalibrationSnapshot _snapshot;
+};
+
+}
+
+#endif // CALIBRATIONCOLLECTOR_HPP
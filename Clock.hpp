@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef CLOCK_HPP
+#define CLOCK_HPP
+
+#include <cstdint>
+#include <ctime>
+
+namespace ship_position
+{
+
+// CLOCK_MONOTONIC time in nanoseconds, the time base of all sample timestamps
+inline uint64_t monotonicNs()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+}
+
+#endif // CLOCK_HPP
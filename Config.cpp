@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2024 Mikhail Sapozhnikov
+ * Copyright (C) 2024 - 2026 Mikhail Sapozhnikov
  *
  * This file is part of ship-position.
  *
@@ -38,9 +38,16 @@ Config::Config(const std::string &configFile)
         return;
     }
 
-    in >> j;
-
-    _configData = j.get<ConfigData>();
+    try
+    {
+        in >> j;
+        _configData = j.get<ConfigData>();
+    }
+    catch (const nlohmann::json::exception &e)
+    {
+        _log->write(LogLevel::ERROR, "Failed to parse config file %s: %s\n", configFile.c_str(), e.what());
+        return;
+    }
 
     _ok = true;
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2024 - 2025 Mikhail Sapozhnikov
+ * Copyright (C) 2024 - 2026 Mikhail Sapozhnikov
  *
  * This file is part of ship-position.
  *
@@ -24,6 +24,7 @@
 #include "BN880GPSConfig.hpp"
 #include "IPCConfig.hpp"
 #include "QMC5883LConfig.hpp"
+#include "FusionConfig.hpp"
 #include "Log.hpp"
 #include "json.hpp"
 
@@ -32,9 +33,16 @@ using json = nlohmann::json;
 namespace ship_position
 {
 
-NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(BN880GPSConfig, bufferSize, devPath, maxRetries, rawOutput, maxRawFileSize)
-NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(QMC5883LConfig, devPath, pollTimeout, calibrationPollTimeout)
-NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(IPCConfig, bufSize, socketPath)
+// keys missing from the file keep the defaults of the config structs, so that older configs still load
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(BN880GPSConfig, bufferSize, devPath, maxRetries, rawOutput,
+    maxRawFileSize, rawSegments, rawTimestamps, replayFile, replaySpeed, protocol,
+    measurementRate, baudRate, messages, portBaudRate, vmin, vtime, lowLatency)
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(QMC5883LConfig, devPath, pollTimeout, outputDataRate, fieldRange,
+    oversampling, filter, filterWindow, filterAlpha, mountingRotation, mountingFlipped, declination,
+    calibrationFile, calibrationMinCoverage, calibrationMaxResidual)
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(FusionConfig, publishRate, gpsTimeout, maxDeadReckoning, useCompass,
+    positionNoise, velocityNoise, headingNoise, accelerationNoise, turnNoise, currentNoise)
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(IPCConfig, bufSize, socketPath)
 
 class Config
 {
@@ -43,6 +51,7 @@ public:
 
     void getBN880GPSConfig(BN880GPSConfig &config) const { config = _configData.bn880GPSConfig; }
     void getQMC5883LConfig(QMC5883LConfig &config) const { config = _configData.qmc5883LConfig; }
+    void getFusionConfig(FusionConfig &config) const { config = _configData.fusionConfig; }
     void getIPCConfig(IPCConfig &config) const { config = _configData.ipcConfig;}
     LogLevel getLogLevel() const;
     bool isSyslogEnabled() const;
@@ -54,10 +63,12 @@ protected:
     {
         BN880GPSConfig bn880GPSConfig;
         QMC5883LConfig qmc5883LConfig;
+        FusionConfig fusionConfig;
         IPCConfig ipcConfig;
         std::string logLevel;
         std::vector<std::string> logBackends;
-        NLOHMANN_DEFINE_TYPE_INTRUSIVE(ConfigData, bn880GPSConfig, qmc5883LConfig, ipcConfig, logLevel, logBackends)
+        NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(ConfigData, bn880GPSConfig, qmc5883LConfig, fusionConfig, ipcConfig,
+            logLevel, logBackends)
     };
 
     ConfigData _configData;
@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef FUSIONCONFIG_HPP
+#define FUSIONCONFIG_HPP
+
+namespace ship_position
+{
+
+struct FusionConfig
+{
+    // fused states published per second
+    double publishRate = 10.0;
+    // seconds without a GPS fix after which the position is flagged as dead reckoned
+    double gpsTimeout = 2.5;
+    // seconds of dead reckoning after which the position is reported invalid
+    double maxDeadReckoning = 60.0;
+    // fuse the true heading of the magnetometer, otherwise heading follows course over ground
+    bool useCompass = true;
+    // 1 sigma: position at HDOP 1, meters, velocity, m/s, compass heading, degrees
+    double positionNoise = 3.0;
+    double velocityNoise = 0.2;
+    double headingNoise = 3.0;
+    // random walk densities: speed through water, m/s^2, turn rate, degrees/s^2, current, m/s^2
+    double accelerationNoise = 0.2;
+    double turnNoise = 2.0;
+    double currentNoise = 0.01;
+};
+
+}
+
+#endif // FUSIONCONFIG_HPP
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef FUSIONREADER_HPP
+#define FUSIONREADER_HPP
+
+#include <cstdint>
+
+namespace ship_position
+{
+
+// GPS and compass combined, propagated to the time it was published
+struct FusedState
+{
+    // a fix has been fused and dead reckoning hasn't gone on for longer than allowed
+    bool valid;
+    // no fix for longer than the GPS timeout, position is carried on by speed, heading and current
+    bool deadReckoning;
+    double latitude;
+    double longitude;
+    // over ground
+    double speedKnots;
+    // degrees true
+    double courseOverGround;
+    // where the bow points, degrees true
+    double heading;
+    // degrees per second, positive turns starboard
+    double turnRate;
+    // current and leeway, knots, and the direction it sets to, degrees true
+    double currentKnots;
+    double currentDirection;
+    // 1 sigma: radial position error, meters, and heading error, degrees
+    double positionError;
+    double headingError;
+    // CLOCK_MONOTONIC nanoseconds of the last fused fix, of the state and of publishing it
+    uint64_t fixArrivalNs;
+    uint64_t arrivalNs;
+    uint64_t publishNs;
+
+    FusedState()
+    {
+        valid = false;
+        deadReckoning = false;
+        latitude = 0.0;
+        longitude = 0.0;
+        speedKnots = 0.0;
+        courseOverGround = 0.0;
+        heading = 0.0;
+        turnRate = 0.0;
+        currentKnots = 0.0;
+        currentDirection = 0.0;
+        positionError = 0.0;
+        headingError = 0.0;
+        fixArrivalNs = 0;
+        arrivalNs = 0;
+        publishNs = 0;
+    }
+};
+
+struct FusionStatistics
+{
+    uint64_t fixes;
+    uint64_t headings;
+    // fixes whose position was too far from the prediction to be believed
+    uint64_t rejectedFixes;
+    // the filter started over after dead reckoning for too long
+    uint64_t resets;
+    // CLOCK_MONOTONIC nanoseconds the last fused fix or heading arrived, 0 before the first one
+    uint64_t lastArrivalNs;
+
+    FusionStatistics() : fixes(0), headings(0), rejectedFixes(0), resets(0), lastArrivalNs(0) {}
+};
+
+class FusionReader
+{
+public:
+    virtual void getFusedState(FusedState &state) = 0;
+    virtual void getFusionStatistics(FusionStatistics &statistics) = 0;
+};
+
+}
+
+#endif // FUSIONREADER_HPP
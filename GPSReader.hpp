@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2024 Mikhail Sapozhnikov
+ * Copyright (C) 2024 - 2026 Mikhail Sapozhnikov
  *
  * This file is part of ship-position.
  *
@@ -21,6 +21,10 @@
 #ifndef GPSREADER_HPP
 #define GPSREADER_HPP
 
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
 namespace ship_position
 {
 
@@ -31,6 +35,29 @@ struct GPSInfo
     double longitude;
     double speedKnots;
     double speedKm;
+    // course over ground, degrees true
+    double courseOverGround;
+    // altitude above mean sea level, meters
+    double altitude;
+    // GGA fix quality: 0 - invalid, 1 - GPS fix, 2 - DGPS fix, ...
+    int fixQuality;
+    // GSA fix mode: 1 - no fix, 2 - 2D, 3 - 3D
+    int fixMode;
+    double pdop;
+    double hdop;
+    double vdop;
+    // receiver UTC date and time
+    int utcYear;
+    int utcMonth;
+    int utcDay;
+    int utcHours;
+    int utcMinutes;
+    double utcSeconds;
+    // CLOCK_MONOTONIC nanoseconds when read from the receiver and when published, 0 before the first update
+    uint64_t arrivalNs;
+    uint64_t publishNs;
+    // arrivalNs of the last valid position, tells a new fix from a republished one
+    uint64_t positionArrivalNs;
 
     GPSInfo()
     {
@@ -39,6 +66,107 @@ struct GPSInfo
         longitude = 0.0;
         speedKnots = 0.0;
         speedKm = 0.0;
+        courseOverGround = 0.0;
+        altitude = 0.0;
+        fixQuality = 0;
+        fixMode = 0;
+        pdop = 0.0;
+        hdop = 0.0;
+        vdop = 0.0;
+        utcYear = 0;
+        utcMonth = 0;
+        utcDay = 0;
+        utcHours = 0;
+        utcMinutes = 0;
+        utcSeconds = 0.0;
+        arrivalNs = 0;
+        publishNs = 0;
+        positionArrivalNs = 0;
+    }
+};
+
+enum class GNSSSystem : uint8_t
+{
+    GPS,
+    GLONASS,
+    GALILEO,
+    BEIDOU,
+    QZSS,
+    UNKNOWN
+};
+
+inline const char *gnssSystemName(GNSSSystem system)
+{
+    switch (system)
+    {
+        case GNSSSystem::GPS: return "GPS";
+        case GNSSSystem::GLONASS: return "GLONASS";
+        case GNSSSystem::GALILEO: return "Galileo";
+        case GNSSSystem::BEIDOU: return "BeiDou";
+        case GNSSSystem::QZSS: return "QZSS";
+        default: return "unknown";
+    }
+}
+
+// satellites in view, stored as fixed size struct of arrays, so that updating it never allocates
+struct SatelliteTable
+{
+    static constexpr size_t MAX_SATELLITES = 64;
+
+    size_t count;
+    GNSSSystem system[MAX_SATELLITES];
+    uint16_t prn[MAX_SATELLITES];
+    // degrees, -1 if unknown
+    int16_t elevation[MAX_SATELLITES];
+    // degrees true, -1 if unknown
+    int16_t azimuth[MAX_SATELLITES];
+    // dB-Hz, -1 if the satellite is not tracked
+    int16_t snr[MAX_SATELLITES];
+    // CLOCK_MONOTONIC nanoseconds of the last GSV sentence, 0 if none
+    uint64_t arrivalNs;
+
+    SatelliteTable() : count(0), arrivalNs(0) {}
+};
+
+struct NMEASentenceCounters
+{
+    uint64_t valid;
+    // checksum mismatch
+    uint64_t invalid;
+    // cut short or too long
+    uint64_t truncated;
+
+    NMEASentenceCounters() : valid(0), invalid(0), truncated(0) {}
+};
+
+// received sentence counters per sentence type
+struct NMEAStatistics
+{
+    static constexpr size_t NUM_TYPES = 8;
+    static constexpr const char *TYPES[NUM_TYPES] = {"GGA", "VTG", "RMC", "GSA", "GLL", "ZDA", "GSV", "other"};
+
+    NMEASentenceCounters counters[NUM_TYPES];
+    // CLOCK_MONOTONIC nanoseconds of the last sentence of any type, 0 if none
+    uint64_t lastArrivalNs;
+
+    NMEAStatistics() : lastArrivalNs(0) {}
+
+    // index into counters for a sentence, based on the last three characters of its address field
+    static size_t typeIndex(std::string_view sentence)
+    {
+        std::string_view address = sentence.substr(0, sentence.find_first_of(",*"));
+        if (address.size() >= 3)
+        {
+            std::string_view type = address.substr(address.size() - 3);
+            for (size_t i = 0; i < NUM_TYPES - 1; i++)
+            {
+                if (type == TYPES[i])
+                {
+                    return i;
+                }
+            }
+        }
+        return NUM_TYPES - 1;
     }
 };
 
@@ -46,6 +174,8 @@ class GPSReader
 {
 public:
     virtual void getGPSInfo(GPSInfo &gpsInfo) = 0;
+    virtual void getNMEAStatistics(NMEAStatistics &statistics) = 0;
+    virtual void getSatellites(SatelliteTable &satellites) = 0;
 };
 
 }
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Heading.hpp"
+#include <cmath>
+
+namespace ship_position
+{
+
+namespace
+{
+
+constexpr double PI = 3.14159265358979323846;
+
+// degrees in [0, 360)
+double normalizeDegrees(double degrees)
+{
+    degrees = std::fmod(degrees, 360.0);
+    return (degrees < 0.0) ? degrees + 360.0 : degrees;
+}
+
+}
+
+double fastAtan2(double y, double x)
+{
+    double ax = std::fabs(x);
+    double ay = std::fabs(y);
+    if ((ax == 0.0) && (ay == 0.0))
+    {
+        return 0.0;
+    }
+
+    // atan(z) for z in [0, 1], Abramowitz and Stegun 4.4.49, |error| <= 2e-8
+    double z = (ay <= ax) ? ay / ax : ax / ay;
+    double z2 = z * z;
+    double angle = z * (1.0 + z2 * (-0.3333314528 + z2 * (0.1999355085 + z2 * (-0.1420889944 +
+        z2 * (0.1065626393 + z2 * (-0.0752896400 + z2 * (0.0429096138 + z2 * (-0.0161657367 +
+        z2 * 0.0028662257))))))));
+
+    // back from the first octant
+    if (ay > ax)
+    {
+        angle = PI / 2.0 - angle;
+    }
+    if (x < 0.0)
+    {
+        angle = PI - angle;
+    }
+    return (y < 0.0) ? -angle : angle;
+}
+
+HeadingCalculator::HeadingCalculator(double mountingRotation, bool mountingFlipped, double declination) :
+    _mountingRotation(mountingRotation),
+    _mountingFlipped(mountingFlipped),
+    _declination(declination)
+{
+}
+
+HeadingData HeadingCalculator::compute(const MagnetometerData &data) const
+{
+    // turned over around X, the Y axis points to starboard
+    double y = _mountingFlipped ? -data.y : data.y;
+    double sensorHeading = fastAtan2(y, data.x) * 180.0 / PI;
+
+    HeadingData heading;
+    heading.magneticHeading = normalizeDegrees(sensorHeading - _mountingRotation);
+    heading.trueHeading = normalizeDegrees(heading.magneticHeading + _declination);
+    heading.arrivalNs = data.arrivalNs;
+    heading.publishNs = data.publishNs;
+    return heading;
+}
+
+}
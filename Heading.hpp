@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef HEADING_HPP
+#define HEADING_HPP
+
+#include "MagnetometerReader.hpp"
+
+namespace ship_position
+{
+
+// atan2() by a polynomial on the first octant, absolute error is below 1e-7 rad
+double fastAtan2(double y, double x);
+
+// heading of a level sensor from its calibrated X and Y, X axis pointing forward and Y to port
+class HeadingCalculator
+{
+public:
+    // mountingRotation: degrees clockwise from the bow to sensor X, declination: degrees east positive
+    HeadingCalculator(double mountingRotation, bool mountingFlipped, double declination);
+
+    HeadingData compute(const MagnetometerData &data) const;
+
+protected:
+    double _mountingRotation;
+    bool _mountingFlipped;
+    double _declination;
+};
+
+}
+
+#endif // HEADING_HPP
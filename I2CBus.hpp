@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef I2CBUS_HPP
+#define I2CBUS_HPP
+
+#include <cstdint>
+
+namespace ship_position
+{
+
+// register access to one device on an I2C bus, failures set errno like the SMBus calls
+class I2CBus
+{
+public:
+    virtual ~I2CBus() {}
+
+    // returns false on failure
+    virtual bool writeRegister(uint8_t reg, uint8_t value) = 0;
+    // reads length registers in one transaction, returns the number of bytes read or -1
+    virtual int readRegisters(uint8_t reg, uint8_t length, uint8_t *data) = 0;
+};
+
+}
+
+#endif // I2CBUS_HPP
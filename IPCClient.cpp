@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2024 - 2025 Mikhail Sapozhnikov
+ * Copyright (C) 2024 - 2026 Mikhail Sapozhnikov
  *
  * This file is part of ship-position.
  *
@@ -20,6 +20,7 @@
 
 #include "IPCClient.hpp"
 #include "IPCMessages.hpp"
+#include "Clock.hpp"
 #include <unistd.h>
 
 using json = nlohmann::json;
@@ -28,12 +29,13 @@ namespace ship_position
 {
 
 IPCClient::IPCClient(int id, int fd, const IPCConfig &config, GPSReader &gpsReader,
-    MagnetometerReader &magnetometerReader, std::function<void(int)> stopCb)
+    MagnetometerReader &magnetometerReader, FusionReader &fusionReader, std::function<void(int)> stopCb)
 : _id(id),
 _fd(fd),
 _config(config),
 _gpsReader(gpsReader),
 _magnetometerReader(magnetometerReader),
+_fusionReader(fusionReader),
 _stopCb(stopCb)
 {
     _buf = static_cast<char *>(new char[_config.bufSize]);
@@ -106,7 +108,27 @@ std::string IPCClient::handleRequest(const std::string &rq)
         {
             GPSInfo gpsInfo;
             _gpsReader.getGPSInfo(gpsInfo);
-            GPSInfoResponse resp(gpsInfo);
+            GPSInfoResponse resp(gpsInfo, monotonicNs());
+            json json_resp = resp;
+            std::string respStr = json_resp.dump();
+            _log->write(LogLevel::DEBUG, "IPCClient %d sending response %s\n", _id, respStr.c_str());
+            return respStr;
+        }
+        else if (ipcRq.cmd == ipcRq.cmdGetNMEAStatistics)
+        {
+            NMEAStatistics statistics;
+            _gpsReader.getNMEAStatistics(statistics);
+            NMEAStatisticsResponse resp(statistics, monotonicNs());
+            json json_resp = resp;
+            std::string respStr = json_resp.dump();
+            _log->write(LogLevel::DEBUG, "IPCClient %d sending response %s\n", _id, respStr.c_str());
+            return respStr;
+        }
+        else if (ipcRq.cmd == ipcRq.cmdGetSatellites)
+        {
+            SatelliteTable satellites;
+            _gpsReader.getSatellites(satellites);
+            SatellitesResponse resp(satellites, monotonicNs());
             json json_resp = resp;
             std::string respStr = json_resp.dump();
             _log->write(LogLevel::DEBUG, "IPCClient %d sending response %s\n", _id, respStr.c_str());
@@ -116,7 +138,77 @@ std::string IPCClient::handleRequest(const std::string &rq)
         {
             MagnetometerData magnetometerData;
             _magnetometerReader.getMagnetometerData(magnetometerData);
-            MagnetometerInfoResponse resp(magnetometerData);
+            MagnetometerInfoResponse resp(magnetometerData, monotonicNs());
+            json json_resp = resp;
+            std::string respStr = json_resp.dump();
+            _log->write(LogLevel::DEBUG, "IPCClient %d sending response %s\n", _id, respStr.c_str());
+            return respStr;
+        }
+        else if (ipcRq.cmd == ipcRq.cmdGetMagnetometerSamples)
+        {
+            std::vector<MagnetometerData> samples;
+            _magnetometerReader.getMagnetometerSamples(ipcRq.count, samples);
+            MagnetometerSamplesResponse resp(samples, monotonicNs());
+            json json_resp = resp;
+            std::string respStr = json_resp.dump();
+            _log->write(LogLevel::DEBUG, "IPCClient %d sending response %s\n", _id, respStr.c_str());
+            return respStr;
+        }
+        else if (ipcRq.cmd == ipcRq.cmdGetHeading)
+        {
+            HeadingData heading;
+            _magnetometerReader.getHeading(heading);
+            HeadingResponse resp(heading, monotonicNs());
+            json json_resp = resp;
+            std::string respStr = json_resp.dump();
+            _log->write(LogLevel::DEBUG, "IPCClient %d sending response %s\n", _id, respStr.c_str());
+            return respStr;
+        }
+        else if (ipcRq.cmd == ipcRq.cmdGetMagnetometerStatistics)
+        {
+            MagnetometerStatistics statistics;
+            _magnetometerReader.getMagnetometerStatistics(statistics);
+            MagnetometerStatisticsResponse resp(statistics, monotonicNs());
+            json json_resp = resp;
+            std::string respStr = json_resp.dump();
+            _log->write(LogLevel::DEBUG, "IPCClient %d sending response %s\n", _id, respStr.c_str());
+            return respStr;
+        }
+        else if (ipcRq.cmd == ipcRq.cmdGetCalibrationStatus)
+        {
+            CalibrationStatus status;
+            _magnetometerReader.getCalibrationStatus(status);
+            CalibrationStatusResponse resp(status, monotonicNs());
+            json json_resp = resp;
+            std::string respStr = json_resp.dump();
+            _log->write(LogLevel::DEBUG, "IPCClient %d sending response %s\n", _id, respStr.c_str());
+            return respStr;
+        }
+        else if (ipcRq.cmd == ipcRq.cmdGetTemperatureCompensation)
+        {
+            TemperatureCompensation compensation;
+            _magnetometerReader.getTemperatureCompensation(compensation);
+            TemperatureCompensationResponse resp(compensation, monotonicNs());
+            json json_resp = resp;
+            std::string respStr = json_resp.dump();
+            _log->write(LogLevel::DEBUG, "IPCClient %d sending response %s\n", _id, respStr.c_str());
+            return respStr;
+        }
+        else if (ipcRq.cmd == ipcRq.cmdGetFusedPosition)
+        {
+            FusedState state;
+            _fusionReader.getFusedState(state);
+            FusedPositionResponse resp(state, monotonicNs());
+            json json_resp = resp;
+            std::string respStr = json_resp.dump();
+            _log->write(LogLevel::DEBUG, "IPCClient %d sending response %s\n", _id, respStr.c_str());
+            return respStr;
+        }
+        else if (ipcRq.cmd == ipcRq.cmdGetFusionStatistics)
+        {
+            FusionStatistics statistics;
+            _fusionReader.getFusionStatistics(statistics);
+            FusionStatisticsResponse resp(statistics, monotonicNs());
             json json_resp = resp;
             std::string respStr = json_resp.dump();
             _log->write(LogLevel::DEBUG, "IPCClient %d sending response %s\n", _id, respStr.c_str());
@@ -135,8 +227,7 @@ std::string IPCClient::handleRequest(const std::string &rq)
         else if (ipcRq.cmd == ipcRq.cmdStopCalibration)
         {
             CalibrationResponse resp;
-            _magnetometerReader.stopCalibration();
-            resp.success = true;
+            resp.success = _magnetometerReader.stopCalibration();
             json json_resp = resp;
             std::string respStr = json_resp.dump();
             _log->write(LogLevel::DEBUG, "IPCClient %d sending response %s\n", _id, respStr.c_str());
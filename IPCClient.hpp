@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2024 - 2025 Mikhail Sapozhnikov
+ * Copyright (C) 2024 - 2026 Mikhail Sapozhnikov
  *
  * This file is part of ship-position.
  *
@@ -26,6 +26,7 @@
 #include "IPCConfig.hpp"
 #include "GPSReader.hpp"
 #include "MagnetometerReader.hpp"
+#include "FusionReader.hpp"
 #include <functional>
 
 namespace ship_position
@@ -35,7 +36,7 @@ class IPCClient : public SingleThread
 {
 public:
     IPCClient(int id, int fd, const IPCConfig &config, GPSReader &gpsReader,
-        MagnetometerReader &magnetometerReader, std::function<void(int)> stopCb);
+        MagnetometerReader &magnetometerReader, FusionReader &fusionReader, std::function<void(int)> stopCb);
     IPCClient(const IPCClient &other) = delete;
     virtual ~IPCClient();
 
@@ -50,6 +51,7 @@ protected:
     const IPCConfig &_config;
     GPSReader &_gpsReader;
     MagnetometerReader &_magnetometerReader;
+    FusionReader &_fusionReader;
     char *_buf;
     Log *_log;
     std::function<void(int)> _stopCb;
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2024 Mikhail Sapozhnikov
+ * Copyright (C) 2024 - 2026 Mikhail Sapozhnikov
  *
  * This file is part of ship-position.
  *
@@ -28,8 +28,8 @@ namespace ship_position
 
 struct IPCConfig
 {
-    int bufSize;
-    std::string socketPath;
+    int bufSize = 5120;
+    std::string socketPath = "/tmp/ship_position.sock";
 };
 
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2024 - 2025 Mikhail Sapozhnikov
+ * Copyright (C) 2024 - 2026 Mikhail Sapozhnikov
  *
  * This file is part of ship-position.
  *
@@ -23,35 +23,75 @@
 
 #include "GPSReader.hpp"
 #include "MagnetometerReader.hpp"
+#include "FusionReader.hpp"
 #include "json.hpp"
+#include <map>
 #include <string>
+#include <vector>
 
 namespace ship_position
 {
 
+// milliseconds since a sample stamped at arrivalNs was read, -1 if there is no sample yet
+inline double dataAgeMs(uint64_t arrivalNs, uint64_t nowNs)
+{
+    if (arrivalNs == 0)
+    {
+        return -1.0;
+    }
+    return (nowNs > arrivalNs) ? (nowNs - arrivalNs) / 1e6 : 0.0;
+}
+
 struct IPCRequest
 {
     const std::string cmdGetGPS = "GetGPSData";
     const std::string cmdGetMagnetometer = "GetMagnetometerData";
     const std::string cmdStartCalibration = "StartCalibration";
     const std::string cmdStopCalibration = "StopCalibration";
+    const std::string cmdGetNMEAStatistics = "GetNMEAStatistics";
+    const std::string cmdGetSatellites = "GetSatellites";
+    const std::string cmdGetMagnetometerStatistics = "GetMagnetometerStatistics";
+    const std::string cmdGetMagnetometerSamples = "GetMagnetometerSamples";
+    const std::string cmdGetHeading = "GetHeading";
+    const std::string cmdGetCalibrationStatus = "GetCalibrationStatus";
+    const std::string cmdGetTemperatureCompensation = "GetTemperatureCompensation";
+    const std::string cmdGetFusedPosition = "GetFusedPosition";
+    const std::string cmdGetFusionStatistics = "GetFusionStatistics";
 
     std::string cmd;
+    // number of samples for GetMagnetometerSamples, may be omitted otherwise
+    size_t count = 0;
 
-    NLOHMANN_DEFINE_TYPE_INTRUSIVE(IPCRequest, cmd)
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(IPCRequest, cmd, count)
 };
 
 struct GPSInfoResponse
 {
     GPSInfoResponse() = default;
 
-    GPSInfoResponse(const GPSInfo &gpsInfo)
+    GPSInfoResponse(const GPSInfo &gpsInfo, uint64_t nowNs)
     {
         numSatellites = gpsInfo.numSatellites;
         latitude = gpsInfo.latitude;
         longitude = gpsInfo.longitude;
         speedKnots = gpsInfo.speedKnots;
         speedKm = gpsInfo.speedKm;
+        courseOverGround = gpsInfo.courseOverGround;
+        altitude = gpsInfo.altitude;
+        fixQuality = gpsInfo.fixQuality;
+        fixMode = gpsInfo.fixMode;
+        pdop = gpsInfo.pdop;
+        hdop = gpsInfo.hdop;
+        vdop = gpsInfo.vdop;
+        utcYear = gpsInfo.utcYear;
+        utcMonth = gpsInfo.utcMonth;
+        utcDay = gpsInfo.utcDay;
+        utcHours = gpsInfo.utcHours;
+        utcMinutes = gpsInfo.utcMinutes;
+        utcSeconds = gpsInfo.utcSeconds;
+        arrivalNs = gpsInfo.arrivalNs;
+        publishNs = gpsInfo.publishNs;
+        ageMs = dataAgeMs(gpsInfo.arrivalNs, nowNs);
     }
 
     int numSatellites;
@@ -59,8 +99,98 @@ struct GPSInfoResponse
     double longitude;
     double speedKnots;
     double speedKm;
+    double courseOverGround;
+    double altitude;
+    int fixQuality;
+    int fixMode;
+    double pdop;
+    double hdop;
+    double vdop;
+    int utcYear;
+    int utcMonth;
+    int utcDay;
+    int utcHours;
+    int utcMinutes;
+    double utcSeconds;
+    // CLOCK_MONOTONIC nanoseconds
+    uint64_t arrivalNs;
+    uint64_t publishNs;
+    // age of the data when the response was made
+    double ageMs;
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(GPSInfoResponse, numSatellites, latitude, longitude, speedKnots, speedKm,
+        courseOverGround, altitude, fixQuality, fixMode, pdop, hdop, vdop, utcYear, utcMonth, utcDay, utcHours,
+        utcMinutes, utcSeconds, arrivalNs, publishNs, ageMs)
+};
+
+struct NMEASentenceCountersResponse
+{
+    uint64_t valid;
+    uint64_t invalid;
+    uint64_t truncated;
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(NMEASentenceCountersResponse, valid, invalid, truncated)
+};
+
+struct NMEAStatisticsResponse
+{
+    NMEAStatisticsResponse() = default;
+
+    NMEAStatisticsResponse(const NMEAStatistics &statistics, uint64_t nowNs)
+    {
+        for (size_t i = 0; i < NMEAStatistics::NUM_TYPES; i++)
+        {
+            NMEASentenceCountersResponse counters;
+            counters.valid = statistics.counters[i].valid;
+            counters.invalid = statistics.counters[i].invalid;
+            counters.truncated = statistics.counters[i].truncated;
+            sentences[NMEAStatistics::TYPES[i]] = counters;
+        }
+        ageMs = dataAgeMs(statistics.lastArrivalNs, nowNs);
+    }
+
+    // counters by sentence type
+    std::map<std::string, NMEASentenceCountersResponse> sentences;
+    // since the last sentence
+    double ageMs;
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(NMEAStatisticsResponse, sentences, ageMs)
+};
+
+struct SatelliteInfoResponse
+{
+    std::string system;
+    int prn;
+    int elevation;
+    int azimuth;
+    int snr;
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(SatelliteInfoResponse, system, prn, elevation, azimuth, snr)
+};
+
+struct SatellitesResponse
+{
+    SatellitesResponse() = default;
+
+    SatellitesResponse(const SatelliteTable &table, uint64_t nowNs)
+    {
+        for (size_t i = 0; i < table.count; i++)
+        {
+            SatelliteInfoResponse satellite;
+            satellite.system = gnssSystemName(table.system[i]);
+            satellite.prn = table.prn[i];
+            satellite.elevation = table.elevation[i];
+            satellite.azimuth = table.azimuth[i];
+            satellite.snr = table.snr[i];
+            satellites.push_back(satellite);
+        }
+        ageMs = dataAgeMs(table.arrivalNs, nowNs);
+    }
 
-    NLOHMANN_DEFINE_TYPE_INTRUSIVE(GPSInfoResponse, numSatellites, latitude, longitude, speedKnots, speedKm)
+    std::vector<SatelliteInfoResponse> satellites;
+    double ageMs;
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(SatellitesResponse, satellites, ageMs)
 };
 
 struct MagnetometerInfoResponse
@@ -68,17 +198,92 @@ struct MagnetometerInfoResponse
     int32_t x;
     int32_t y;
     int32_t z;
+    double temperature;
+    // CLOCK_MONOTONIC nanoseconds
+    uint64_t arrivalNs;
+    uint64_t publishNs;
+    double ageMs;
 
     MagnetometerInfoResponse() = default;
 
-    MagnetometerInfoResponse(const MagnetometerData &data)
+    MagnetometerInfoResponse(const MagnetometerData &data, uint64_t nowNs)
     {
         x = data.x;
         y = data.y;
         z = data.z;
+        temperature = data.temperature;
+        arrivalNs = data.arrivalNs;
+        publishNs = data.publishNs;
+        ageMs = dataAgeMs(data.arrivalNs, nowNs);
+    }
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(MagnetometerInfoResponse, x, y, z, temperature, arrivalNs, publishNs, ageMs)
+};
+
+struct MagnetometerSamplesResponse
+{
+    MagnetometerSamplesResponse() = default;
+
+    MagnetometerSamplesResponse(const std::vector<MagnetometerData> &data, uint64_t nowNs)
+    {
+        for (const MagnetometerData &sample : data)
+        {
+            samples.push_back(MagnetometerInfoResponse(sample, nowNs));
+        }
+        ageMs = dataAgeMs(data.empty() ? 0 : data.back().arrivalNs, nowNs);
+    }
+
+    // oldest first
+    std::vector<MagnetometerInfoResponse> samples;
+    // of the newest sample
+    double ageMs;
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(MagnetometerSamplesResponse, samples, ageMs)
+};
+
+struct HeadingResponse
+{
+    HeadingResponse() = default;
+
+    HeadingResponse(const HeadingData &heading, uint64_t nowNs)
+    {
+        magneticHeading = heading.magneticHeading;
+        trueHeading = heading.trueHeading;
+        arrivalNs = heading.arrivalNs;
+        publishNs = heading.publishNs;
+        ageMs = dataAgeMs(heading.arrivalNs, nowNs);
     }
 
-    NLOHMANN_DEFINE_TYPE_INTRUSIVE(MagnetometerInfoResponse, x, y, z)
+    double magneticHeading;
+    double trueHeading;
+    uint64_t arrivalNs;
+    uint64_t publishNs;
+    double ageMs;
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(HeadingResponse, magneticHeading, trueHeading, arrivalNs, publishNs, ageMs)
+};
+
+struct MagnetometerStatisticsResponse
+{
+    uint64_t samples;
+    uint64_t dropped;
+    uint64_t duplicates;
+    uint64_t readErrors;
+    // since the last new measurement
+    double ageMs;
+
+    MagnetometerStatisticsResponse() = default;
+
+    MagnetometerStatisticsResponse(const MagnetometerStatistics &statistics, uint64_t nowNs)
+    {
+        samples = statistics.samples;
+        dropped = statistics.dropped;
+        duplicates = statistics.duplicates;
+        readErrors = statistics.readErrors;
+        ageMs = dataAgeMs(statistics.lastArrivalNs, nowNs);
+    }
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(MagnetometerStatisticsResponse, samples, dropped, duplicates, readErrors, ageMs)
 };
 
 struct CalibrationResponse
@@ -88,6 +293,131 @@ struct CalibrationResponse
     NLOHMANN_DEFINE_TYPE_INTRUSIVE(CalibrationResponse, success)
 };
 
+struct CalibrationStatusResponse
+{
+    bool calibrating;
+    bool complete;
+    uint64_t samples;
+    double coverage;
+    double headingCoverage;
+    double residual;
+    double temperatureSpan;
+    // since the last accepted sample
+    double ageMs;
+
+    CalibrationStatusResponse() = default;
+
+    CalibrationStatusResponse(const CalibrationStatus &status, uint64_t nowNs)
+    {
+        calibrating = status.calibrating;
+        complete = status.complete;
+        samples = status.samples;
+        coverage = status.coverage;
+        headingCoverage = status.headingCoverage;
+        residual = status.residual;
+        temperatureSpan = status.temperatureSpan;
+        ageMs = dataAgeMs(status.arrivalNs, nowNs);
+    }
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(CalibrationStatusResponse, calibrating, complete, samples, coverage,
+        headingCoverage, residual, temperatureSpan, ageMs)
+};
+
+struct TemperatureCompensationResponse
+{
+    double temperature;
+    std::vector<double> coefficients;
+    double referenceTemperature;
+    std::vector<double> correction;
+    // of the temperature reading
+    double ageMs;
+
+    TemperatureCompensationResponse() = default;
+
+    TemperatureCompensationResponse(const TemperatureCompensation &compensation, uint64_t nowNs)
+    {
+        temperature = compensation.temperature;
+        coefficients.assign(compensation.coefficients, compensation.coefficients + 3);
+        referenceTemperature = compensation.referenceTemperature;
+        correction.assign(compensation.correction, compensation.correction + 3);
+        ageMs = dataAgeMs(compensation.arrivalNs, nowNs);
+    }
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(TemperatureCompensationResponse, temperature, coefficients,
+        referenceTemperature, correction, ageMs)
+};
+
+struct FusedPositionResponse
+{
+    bool valid;
+    bool deadReckoning;
+    double latitude;
+    double longitude;
+    double speedKnots;
+    double courseOverGround;
+    double heading;
+    double turnRate;
+    double currentKnots;
+    double currentDirection;
+    double positionError;
+    double headingError;
+    // since the last fused fix, -1 if there was none
+    double fixAgeMs;
+    // CLOCK_MONOTONIC nanoseconds
+    uint64_t arrivalNs;
+    uint64_t publishNs;
+    double ageMs;
+
+    FusedPositionResponse() = default;
+
+    FusedPositionResponse(const FusedState &state, uint64_t nowNs)
+    {
+        valid = state.valid;
+        deadReckoning = state.deadReckoning;
+        latitude = state.latitude;
+        longitude = state.longitude;
+        speedKnots = state.speedKnots;
+        courseOverGround = state.courseOverGround;
+        heading = state.heading;
+        turnRate = state.turnRate;
+        currentKnots = state.currentKnots;
+        currentDirection = state.currentDirection;
+        positionError = state.positionError;
+        headingError = state.headingError;
+        fixAgeMs = dataAgeMs(state.fixArrivalNs, nowNs);
+        arrivalNs = state.arrivalNs;
+        publishNs = state.publishNs;
+        ageMs = dataAgeMs(state.arrivalNs, nowNs);
+    }
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(FusedPositionResponse, valid, deadReckoning, latitude, longitude, speedKnots,
+        courseOverGround, heading, turnRate, currentKnots, currentDirection, positionError, headingError, fixAgeMs,
+        arrivalNs, publishNs, ageMs)
+};
+
+struct FusionStatisticsResponse
+{
+    uint64_t fixes;
+    uint64_t headings;
+    uint64_t rejectedFixes;
+    uint64_t resets;
+    // since the last fused fix or heading
+    double ageMs;
+
+    FusionStatisticsResponse() = default;
+
+    FusionStatisticsResponse(const FusionStatistics &statistics, uint64_t nowNs)
+    {
+        fixes = statistics.fixes;
+        headings = statistics.headings;
+        rejectedFixes = statistics.rejectedFixes;
+        resets = statistics.resets;
+        ageMs = dataAgeMs(statistics.lastArrivalNs, nowNs);
+    }
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(FusionStatisticsResponse, fixes, headings, rejectedFixes, resets, ageMs)
+};
+
 struct ErrorResponse
 {
     std::string errorMessage;
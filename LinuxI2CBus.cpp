@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "LinuxI2CBus.hpp"
+
+extern "C"
+{
+    #include <linux/i2c-dev.h>
+    #include <i2c/smbus.h>
+}
+
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace ship_position
+{
+
+LinuxI2CBus::LinuxI2CBus(const std::string &devPath, uint8_t address) :
+_fd(-1)
+{
+    _log = Log::getInstance();
+
+    _fd = open(devPath.c_str(), O_RDWR | O_CLOEXEC);
+    if (_fd == -1)
+    {
+        _log->write(LogLevel::ERROR, "error opening i2c device %s, error = %d\n", devPath.c_str(), errno);
+        return;
+    }
+
+    if (ioctl(_fd, I2C_SLAVE, address) == -1)
+    {
+        _log->write(LogLevel::ERROR, "error specifying i2c address 0x%02x to communicate with, error = %d\n",
+            address, errno);
+        close(_fd);
+        _fd = -1;
+    }
+}
+
+LinuxI2CBus::~LinuxI2CBus()
+{
+    Log::release();
+
+    if (_fd != -1)
+    {
+        close(_fd);
+    }
+}
+
+bool LinuxI2CBus::writeRegister(uint8_t reg, uint8_t value)
+{
+    if (_fd == -1)
+    {
+        errno = EBADF;
+        return false;
+    }
+    return i2c_smbus_write_byte_data(_fd, reg, value) >= 0;
+}
+
+int LinuxI2CBus::readRegisters(uint8_t reg, uint8_t length, uint8_t *data)
+{
+    if (_fd == -1)
+    {
+        errno = EBADF;
+        return -1;
+    }
+    __s32 res = i2c_smbus_read_i2c_block_data(_fd, reg, length, data);
+    return (res < 0) ? -1 : res;
+}
+
+}
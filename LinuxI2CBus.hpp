@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef LINUXI2CBUS_HPP
+#define LINUXI2CBUS_HPP
+
+#include "I2CBus.hpp"
+#include "Log.hpp"
+#include <string>
+
+namespace ship_position
+{
+
+// device on a /dev/i2c-N bus, accessed through i2c-dev SMBus transfers
+class LinuxI2CBus : public I2CBus
+{
+public:
+    LinuxI2CBus(const std::string &devPath, uint8_t address);
+    virtual ~LinuxI2CBus();
+
+    bool isOpen() const { return _fd != -1; }
+
+    virtual bool writeRegister(uint8_t reg, uint8_t value);
+    virtual int readRegisters(uint8_t reg, uint8_t length, uint8_t *data);
+
+protected:
+    int _fd;
+    Log *_log;
+};
+
+}
+
+#endif // LINUXI2CBUS_HPP
@@ -0,0 +1,600 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "MagnetometerCalibration.hpp"
+#include "json.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+using json = nlohmann::json;
+
+namespace ship_position
+{
+
+namespace
+{
+
+constexpr size_t NUM_PARAMS = EllipsoidFit::NUM_PARAMS;
+// samples are scaled to [-1, 1] to keep the normal equations well conditioned
+constexpr double SAMPLE_SCALE = 32768.0;
+// temperatures relative to the first sample are scaled by this many degrees C for the same reason
+constexpr double TEMPERATURE_SCALE = 10.0;
+constexpr double PIVOT_EPSILON = 1e-12;
+// vertical to horizontal spread below which samples are fitted in the horizontal plane only
+constexpr double HORIZONTAL_SPREAD = 0.3;
+
+// unknowns of the full fit, the first NUM_SHAPE_PARAMS of them without the thermal drift
+constexpr size_t ELLIPSOID_UNKNOWNS[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13};
+// x², y², 2xy, 2x, 2y, then 2tx, 2ty, 2t, t² with the thermal drift
+constexpr size_t ELLIPSE_UNKNOWNS[] = {0, 1, 5, 6, 7, 9, 10, 12, 13};
+constexpr size_t NUM_ELLIPSE_SHAPE_PARAMS = 5;
+constexpr int JACOBI_SWEEPS = 50;
+constexpr double JACOBI_EPSILON = 1e-15;
+
+// solves a * x = b in place by Gaussian elimination with partial pivoting, x is left in b
+bool solveLinear(double (&a)[NUM_PARAMS][NUM_PARAMS], double (&b)[NUM_PARAMS], size_t n)
+{
+    double scale = 0.0;
+    for (size_t i = 0; i < n; i++)
+    {
+        scale = std::max(scale, std::fabs(a[i][i]));
+    }
+
+    for (size_t col = 0; col < n; col++)
+    {
+        size_t pivot = col;
+        for (size_t row = col + 1; row < n; row++)
+        {
+            if (std::fabs(a[row][col]) > std::fabs(a[pivot][col]))
+            {
+                pivot = row;
+            }
+        }
+        if (std::fabs(a[pivot][col]) <= PIVOT_EPSILON * scale)
+        {
+            return false;
+        }
+        std::swap(a[pivot], a[col]);
+        std::swap(b[pivot], b[col]);
+
+        for (size_t row = col + 1; row < n; row++)
+        {
+            double factor = a[row][col] / a[col][col];
+            for (size_t k = col; k < n; k++)
+            {
+                a[row][k] -= factor * a[col][k];
+            }
+            b[row] -= factor * b[col];
+        }
+    }
+
+    for (size_t i = n; i-- > 0;)
+    {
+        for (size_t k = i + 1; k < n; k++)
+        {
+            b[i] -= a[i][k] * b[k];
+        }
+        b[i] /= a[i][i];
+    }
+    return true;
+}
+
+// eigenvalues and eigenvectors (columns of v) of a symmetric matrix by Jacobi rotations
+void symmetricEigen(double (&a)[3][3], double (&values)[3], double (&v)[3][3])
+{
+    for (size_t i = 0; i < 3; i++)
+    {
+        for (size_t j = 0; j < 3; j++)
+        {
+            v[i][j] = (i == j) ? 1.0 : 0.0;
+        }
+    }
+
+    for (int sweep = 0; sweep < JACOBI_SWEEPS; sweep++)
+    {
+        double off = std::fabs(a[0][1]) + std::fabs(a[0][2]) + std::fabs(a[1][2]);
+        double diagonal = std::fabs(a[0][0]) + std::fabs(a[1][1]) + std::fabs(a[2][2]);
+        if (off <= JACOBI_EPSILON * diagonal)
+        {
+            break;
+        }
+        for (size_t p = 0; p < 2; p++)
+        {
+            for (size_t q = p + 1; q < 3; q++)
+            {
+                if (a[p][q] == 0.0)
+                {
+                    continue;
+                }
+                double theta = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+                double t = std::copysign(1.0, theta) / (std::fabs(theta) + std::sqrt(theta * theta + 1.0));
+                double c = 1.0 / std::sqrt(t * t + 1.0);
+                double s = t * c;
+                for (size_t k = 0; k < 3; k++)
+                {
+                    double akp = a[k][p];
+                    double akq = a[k][q];
+                    a[k][p] = c * akp - s * akq;
+                    a[k][q] = s * akp + c * akq;
+                }
+                for (size_t k = 0; k < 3; k++)
+                {
+                    double apk = a[p][k];
+                    double aqk = a[q][k];
+                    a[p][k] = c * apk - s * aqk;
+                    a[q][k] = s * apk + c * aqk;
+                }
+                for (size_t k = 0; k < 3; k++)
+                {
+                    double vkp = v[k][p];
+                    double vkq = v[k][q];
+                    v[k][p] = c * vkp - s * vkq;
+                    v[k][q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+
+    for (size_t i = 0; i < 3; i++)
+    {
+        values[i] = a[i][i];
+    }
+}
+
+// solves the normal equations for the first n of the unknowns, params[i] being the value of unknowns[i]
+bool solveUnknowns(const double (&normal)[NUM_PARAMS][NUM_PARAMS], const double (&rhs)[NUM_PARAMS],
+    const size_t *unknowns, size_t n, double (&params)[NUM_PARAMS])
+{
+    double a[NUM_PARAMS][NUM_PARAMS];
+    for (size_t i = 0; i < n; i++)
+    {
+        for (size_t j = 0; j < n; j++)
+        {
+            size_t row = std::min(unknowns[i], unknowns[j]);
+            size_t col = std::max(unknowns[i], unknowns[j]);
+            a[i][j] = normal[row][col];
+        }
+        params[i] = rhs[unknowns[i]];
+    }
+    return solveLinear(a, params, n);
+}
+
+// sum of squared algebraic errors (dᵀθ - 1)² of the solution, which is θᵀNθ - 2θᵀr + number of samples
+double squaredErrors(const double (&normal)[NUM_PARAMS][NUM_PARAMS], const double (&rhs)[NUM_PARAMS],
+    const size_t *unknowns, size_t n, const double (&params)[NUM_PARAMS], size_t samples)
+{
+    double squares = static_cast<double>(samples);
+    for (size_t i = 0; i < n; i++)
+    {
+        double row = 0.0;
+        for (size_t j = 0; j < n; j++)
+        {
+            row += normal[std::min(unknowns[i], unknowns[j])][std::max(unknowns[i], unknowns[j])] * params[j];
+        }
+        squares += params[i] * row - 2.0 * params[i] * rhs[unknowns[i]];
+    }
+    return squares;
+}
+
+bool invert3(const double (&a)[3][3], double (&inverse)[3][3])
+{
+    double det = a[0][0] * (a[1][1] * a[2][2] - a[1][2] * a[2][1])
+        - a[0][1] * (a[1][0] * a[2][2] - a[1][2] * a[2][0])
+        + a[0][2] * (a[1][0] * a[2][1] - a[1][1] * a[2][0]);
+    if (std::fabs(det) < PIVOT_EPSILON)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < 3; i++)
+    {
+        for (size_t j = 0; j < 3; j++)
+        {
+            // cofactor of a[j][i]
+            size_t r0 = (j + 1) % 3;
+            size_t r1 = (j + 2) % 3;
+            size_t c0 = (i + 1) % 3;
+            size_t c1 = (i + 2) % 3;
+            inverse[i][j] = (a[r0][c0] * a[r1][c1] - a[r0][c1] * a[r1][c0]) / det;
+        }
+    }
+    return true;
+}
+
+}
+
+EllipsoidFit::EllipsoidFit()
+{
+    reset();
+}
+
+void EllipsoidFit::reset()
+{
+    for (size_t i = 0; i < NUM_PARAMS; i++)
+    {
+        for (size_t j = 0; j < NUM_PARAMS; j++)
+        {
+            _normal[i][j] = 0.0;
+        }
+        _rhs[i] = 0.0;
+    }
+    _samples = 0;
+    _firstTemperature = 0.0;
+    _minTemperature = 0.0;
+    _maxTemperature = 0.0;
+    _temperatureSum = 0.0;
+}
+
+void EllipsoidFit::add(int32_t x, int32_t y, int32_t z, double temperature)
+{
+    if (_samples == 0)
+    {
+        _firstTemperature = temperature;
+        _minTemperature = temperature;
+        _maxTemperature = temperature;
+    }
+    _minTemperature = std::min(_minTemperature, temperature);
+    _maxTemperature = std::max(_maxTemperature, temperature);
+    _temperatureSum += temperature;
+
+    // a x² + b y² + c z² + 2f yz + 2g xz + 2h xy + 2p x + 2q y + 2r z = 1
+    double u = x / SAMPLE_SCALE;
+    double v = y / SAMPLE_SCALE;
+    double w = z / SAMPLE_SCALE;
+    double t = (temperature - _firstTemperature) / TEMPERATURE_SCALE;
+    double row[NUM_PARAMS] = {u * u, v * v, w * w, 2.0 * v * w, 2.0 * u * w, 2.0 * u * v, 2.0 * u, 2.0 * v, 2.0 * w,
+        2.0 * t * u, 2.0 * t * v, 2.0 * t * w, 2.0 * t, t * t};
+    for (size_t i = 0; i < NUM_PARAMS; i++)
+    {
+        for (size_t j = i; j < NUM_PARAMS; j++)
+        {
+            _normal[i][j] += row[i] * row[j];
+        }
+        _rhs[i] += row[i];
+    }
+    _samples++;
+}
+
+bool EllipsoidFit::solve(MagnetometerCalibration &calibration, double &residual) const
+{
+    if (_samples < CALIBRATION_MIN_SAMPLES)
+    {
+        return false;
+    }
+
+    if (isHorizontal())
+    {
+        return solveHorizontal(calibration, residual);
+    }
+
+    // with little temperature change, the drift terms are close to linear combinations of the others
+    size_t n = fitsTemperature() ? NUM_PARAMS : NUM_SHAPE_PARAMS;
+    double params[NUM_PARAMS];
+    if (!solveUnknowns(_normal, _rhs, ELLIPSOID_UNKNOWNS, n, params))
+    {
+        return false;
+    }
+
+    double quadric[3][3] = {{params[0], params[5], params[4]}, {params[5], params[1], params[3]},
+        {params[4], params[3], params[2]}};
+    double linear[3] = {params[6], params[7], params[8]};
+
+    // centre = -A⁻¹ b, then (u - centre)ᵀ A (u - centre) = 1 + centreᵀ A centre
+    double inverse[3][3];
+    if (!invert3(quadric, inverse))
+    {
+        return false;
+    }
+    double centre[3];
+    for (size_t i = 0; i < 3; i++)
+    {
+        centre[i] = -(inverse[i][0] * linear[0] + inverse[i][1] * linear[1] + inverse[i][2] * linear[2]);
+    }
+    double k = 1.0;
+    for (size_t i = 0; i < 3; i++)
+    {
+        for (size_t j = 0; j < 3; j++)
+        {
+            k += centre[i] * quadric[i][j] * centre[j];
+        }
+    }
+    if (k <= 0.0)
+    {
+        return false;
+    }
+
+    double shape[3][3];
+    for (size_t i = 0; i < 3; i++)
+    {
+        for (size_t j = 0; j < 3; j++)
+        {
+            shape[i][j] = quadric[i][j] / k;
+        }
+    }
+    double values[3];
+    double vectors[3][3];
+    symmetricEigen(shape, values, vectors);
+    if ((values[0] <= 0.0) || (values[1] <= 0.0) || (values[2] <= 0.0))
+    {
+        // a hyperboloid or a degenerate quadric, not a sensor turned around
+        return false;
+    }
+
+    // matrix = R * shape^½, R being the geometric mean of the radii
+    double radius = std::cbrt(1.0 / std::sqrt(values[0] * values[1] * values[2]));
+    for (size_t i = 0; i < 3; i++)
+    {
+        for (size_t j = 0; j < 3; j++)
+        {
+            double sum = 0.0;
+            for (size_t e = 0; e < 3; e++)
+            {
+                sum += vectors[i][e] * std::sqrt(values[e]) * vectors[j][e];
+            }
+            calibration.matrix[i][j] = radius * sum;
+        }
+        calibration.offset[i] = centre[i] * SAMPLE_SCALE;
+    }
+
+    if (n == NUM_PARAMS)
+    {
+        // k = -A⁻¹ m, in raw units per degree C
+        for (size_t i = 0; i < 3; i++)
+        {
+            double drift = -(inverse[i][0] * params[9] + inverse[i][1] * params[10] + inverse[i][2] * params[11]);
+            calibration.temperatureCoefficients[i] = drift * SAMPLE_SCALE / TEMPERATURE_SCALE;
+        }
+        calibration.referenceTemperature = _firstTemperature;
+    }
+    else
+    {
+        for (size_t i = 0; i < 3; i++)
+        {
+            calibration.temperatureCoefficients[i] = 0.0;
+        }
+        calibration.referenceTemperature = _temperatureSum / _samples;
+    }
+
+    // a sample at (1 + δ) times the radius has an algebraic error of about 2kδ
+    double squares = squaredErrors(_normal, _rhs, ELLIPSOID_UNKNOWNS, n, params, _samples);
+    residual = std::sqrt(std::max(squares, 0.0) / _samples) / (2.0 * k);
+    return true;
+}
+
+bool EllipsoidFit::isHorizontal() const
+{
+    if (_samples == 0)
+    {
+        return false;
+    }
+
+    // the normal equations hold sums of (2u)², (2v)², (2w)² and of 2u, 2v, 2w
+    double variance[3];
+    for (size_t i = 0; i < 3; i++)
+    {
+        double mean = _rhs[6 + i] / (2.0 * _samples);
+        variance[i] = _normal[6 + i][6 + i] / (4.0 * _samples) - mean * mean;
+    }
+    return variance[2] < HORIZONTAL_SPREAD * HORIZONTAL_SPREAD * (variance[0] + variance[1]) / 2.0;
+}
+
+bool EllipsoidFit::solveHorizontal(MagnetometerCalibration &calibration, double &residual) const
+{
+    // a x² + b y² + 2h xy + 2p x + 2q y = 1, a level sensor reads about the same z on every heading
+    size_t n = fitsTemperature() ? (sizeof(ELLIPSE_UNKNOWNS) / sizeof(ELLIPSE_UNKNOWNS[0])) : NUM_ELLIPSE_SHAPE_PARAMS;
+    double params[NUM_PARAMS];
+    if (!solveUnknowns(_normal, _rhs, ELLIPSE_UNKNOWNS, n, params))
+    {
+        return false;
+    }
+
+    double quadric[2][2] = {{params[0], params[2]}, {params[2], params[1]}};
+    double det = quadric[0][0] * quadric[1][1] - quadric[0][1] * quadric[1][0];
+    if (std::fabs(det) < PIVOT_EPSILON)
+    {
+        return false;
+    }
+    double inverse[2][2] = {{quadric[1][1] / det, -quadric[0][1] / det}, {-quadric[1][0] / det, quadric[0][0] / det}};
+    double centre[2];
+    for (size_t i = 0; i < 2; i++)
+    {
+        centre[i] = -(inverse[i][0] * params[3] + inverse[i][1] * params[4]);
+    }
+    double k = 1.0;
+    for (size_t i = 0; i < 2; i++)
+    {
+        for (size_t j = 0; j < 2; j++)
+        {
+            k += centre[i] * quadric[i][j] * centre[j];
+        }
+    }
+    if (k <= 0.0)
+    {
+        return false;
+    }
+
+    double shape[2][2];
+    for (size_t i = 0; i < 2; i++)
+    {
+        for (size_t j = 0; j < 2; j++)
+        {
+            shape[i][j] = quadric[i][j] / k;
+        }
+    }
+    double shapeDet = shape[0][0] * shape[1][1] - shape[0][1] * shape[1][0];
+    double trace = shape[0][0] + shape[1][1];
+    if ((shapeDet <= 0.0) || (trace <= 0.0))
+    {
+        // not an ellipse
+        return false;
+    }
+
+    // √M = (M + √det I) / √(trace + 2√det) for a 2x2 positive definite M
+    double root = std::sqrt(shapeDet);
+    double radius = 1.0 / std::sqrt(root);
+    double norm = std::sqrt(trace + 2.0 * root);
+    calibration = MagnetometerCalibration();
+    for (size_t i = 0; i < 2; i++)
+    {
+        for (size_t j = 0; j < 2; j++)
+        {
+            calibration.matrix[i][j] = radius * (shape[i][j] + ((i == j) ? root : 0.0)) / norm;
+        }
+        calibration.offset[i] = centre[i] * SAMPLE_SCALE;
+    }
+    // the vertical axis is left as it is, only its mean is taken out
+    calibration.offset[2] = _rhs[8] / (2.0 * _samples) * SAMPLE_SCALE;
+
+    if (n > NUM_ELLIPSE_SHAPE_PARAMS)
+    {
+        for (size_t i = 0; i < 2; i++)
+        {
+            double drift = -(inverse[i][0] * params[5] + inverse[i][1] * params[6]);
+            calibration.temperatureCoefficients[i] = drift * SAMPLE_SCALE / TEMPERATURE_SCALE;
+        }
+        calibration.referenceTemperature = _firstTemperature;
+    }
+    else
+    {
+        calibration.referenceTemperature = _temperatureSum / _samples;
+    }
+
+    double squares = squaredErrors(_normal, _rhs, ELLIPSE_UNKNOWNS, n, params, _samples);
+    residual = std::sqrt(std::max(squares, 0.0) / _samples) / (2.0 * k);
+    return true;
+}
+
+bool fitEllipsoid(const std::vector<MagnetometerData> &samples, MagnetometerCalibration &calibration)
+{
+    EllipsoidFit fit;
+    for (const MagnetometerData &sample : samples)
+    {
+        fit.add(sample.x, sample.y, sample.z, sample.temperature);
+    }
+    double residual = 0.0;
+    return fit.solve(calibration, residual);
+}
+
+void inheritTemperatureDrift(const MagnetometerCalibration &previous, MagnetometerCalibration &calibration)
+{
+    double dt = calibration.referenceTemperature - previous.referenceTemperature;
+    for (size_t i = 0; i < 3; i++)
+    {
+        if (std::fabs(dt) >= CALIBRATION_MIN_TEMPERATURE_SPAN)
+        {
+            calibration.temperatureCoefficients[i] = (calibration.offset[i] - previous.offset[i]) / dt;
+        }
+        else
+        {
+            calibration.temperatureCoefficients[i] = previous.temperatureCoefficients[i];
+        }
+    }
+}
+
+bool loadCalibration(const std::string &path, MagnetometerCalibration &calibration)
+{
+    std::ifstream in(path.c_str());
+    if (!in.is_open())
+    {
+        return false;
+    }
+
+    json j = json::parse(in, nullptr, false);
+    if (j.is_discarded() || !j.contains("offset") || !j.contains("matrix"))
+    {
+        return false;
+    }
+
+    const json &offset = j["offset"];
+    const json &matrix = j["matrix"];
+    if (!offset.is_array() || (offset.size() != 3) || !matrix.is_array() || (matrix.size() != 3))
+    {
+        return false;
+    }
+
+    MagnetometerCalibration loaded;
+    for (size_t i = 0; i < 3; i++)
+    {
+        if (!offset[i].is_number() || !matrix[i].is_array() || (matrix[i].size() != 3))
+        {
+            return false;
+        }
+        loaded.offset[i] = offset[i].get<double>();
+        for (size_t k = 0; k < 3; k++)
+        {
+            if (!matrix[i][k].is_number())
+            {
+                return false;
+            }
+            loaded.matrix[i][k] = matrix[i][k].get<double>();
+        }
+    }
+
+    // files saved before the thermal drift was fitted don't have it
+    if (j.contains("temperatureCoefficients"))
+    {
+        const json &coefficients = j["temperatureCoefficients"];
+        if (!coefficients.is_array() || (coefficients.size() != 3) || !j.contains("referenceTemperature") ||
+            !j["referenceTemperature"].is_number())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < 3; i++)
+        {
+            if (!coefficients[i].is_number())
+            {
+                return false;
+            }
+            loaded.temperatureCoefficients[i] = coefficients[i].get<double>();
+        }
+        loaded.referenceTemperature = j["referenceTemperature"].get<double>();
+    }
+
+    calibration = loaded;
+    return true;
+}
+
+bool saveCalibration(const std::string &path, const MagnetometerCalibration &calibration)
+{
+    json j;
+    j["offset"] = calibration.offset;
+    j["matrix"] = calibration.matrix;
+    j["temperatureCoefficients"] = calibration.temperatureCoefficients;
+    j["referenceTemperature"] = calibration.referenceTemperature;
+
+    std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath.c_str(), std::ios::trunc);
+        if (!out.is_open())
+        {
+            return false;
+        }
+        out << j.dump(4) << std::endl;
+        if (!out.good())
+        {
+            return false;
+        }
+    }
+
+    return std::rename(tmpPath.c_str(), path.c_str()) == 0;
+}
+
+}
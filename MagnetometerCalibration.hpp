@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MAGNETOMETERCALIBRATION_HPP
+#define MAGNETOMETERCALIBRATION_HPP
+
+#include "MagnetometerReader.hpp"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ship_position
+{
+
+// corrected = matrix * (raw - offset - temperatureCoefficients * (temperature - referenceTemperature))
+struct MagnetometerCalibration
+{
+    // hard iron at referenceTemperature, raw sensor units
+    double offset[3];
+    // soft iron, maps the fitted ellipsoid onto a sphere of the same volume
+    double matrix[3][3];
+    // raw units per degree C
+    double temperatureCoefficients[3];
+    double referenceTemperature;
+
+    // identity, the raw values pass unchanged
+    MagnetometerCalibration() : offset{0.0, 0.0, 0.0}, matrix{{1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}, {0.0, 0.0, 1.0}},
+        temperatureCoefficients{0.0, 0.0, 0.0}, referenceTemperature(0.0) {}
+
+    // called for every sample, fixed size and no branches
+    void apply(int32_t x, int32_t y, int32_t z, double temperature, MagnetometerData &data) const
+    {
+        double dt = temperature - referenceTemperature;
+        double dx = x - offset[0] - temperatureCoefficients[0] * dt;
+        double dy = y - offset[1] - temperatureCoefficients[1] * dt;
+        double dz = z - offset[2] - temperatureCoefficients[2] * dt;
+        data.x = static_cast<int32_t>(std::lround(matrix[0][0] * dx + matrix[0][1] * dy + matrix[0][2] * dz));
+        data.y = static_cast<int32_t>(std::lround(matrix[1][0] * dx + matrix[1][1] * dy + matrix[1][2] * dz));
+        data.z = static_cast<int32_t>(std::lround(matrix[2][0] * dx + matrix[2][1] * dy + matrix[2][2] * dz));
+    }
+
+    // terms apply() uses at the given temperature
+    TemperatureCompensation compensation(double temperature) const
+    {
+        TemperatureCompensation result;
+        result.temperature = temperature;
+        result.referenceTemperature = referenceTemperature;
+        for (size_t i = 0; i < 3; i++)
+        {
+            result.coefficients[i] = temperatureCoefficients[i];
+            result.correction[i] = temperatureCoefficients[i] * (temperature - referenceTemperature);
+        }
+        return result;
+    }
+};
+
+// fewer samples than this are not enough to tell an ellipsoid from noise
+constexpr size_t CALIBRATION_MIN_SAMPLES = 50;
+
+// temperatures have to span this many degrees C for the thermal drift to be fitted
+constexpr double CALIBRATION_MIN_TEMPERATURE_SPAN = 5.0;
+
+// least squares ellipsoid fit, or ellipse fit of the horizontal components for level turns
+class EllipsoidFit
+{
+public:
+    EllipsoidFit();
+
+    void add(int32_t x, int32_t y, int32_t z, double temperature);
+    void reset();
+    size_t samples() const { return _samples; }
+    double temperatureSpan() const { return (_samples > 0) ? _maxTemperature - _minTemperature : 0.0; }
+    bool fitsTemperature() const { return temperatureSpan() >= CALIBRATION_MIN_TEMPERATURE_SPAN; }
+
+    // returns false if the samples don't determine a fit; residual is relative to the radius
+    bool solve(MagnetometerCalibration &calibration, double &residual) const;
+    // the samples hardly leave the horizontal plane, solve() corrects x and y only
+    bool isHorizontal() const;
+
+    // x², y², z², 2yz, 2xz, 2xy, 2x, 2y, 2z
+    static constexpr size_t NUM_SHAPE_PARAMS = 9;
+    // then 2tx, 2ty, 2tz, 2t, t², t being the temperature relative to the first sample
+    static constexpr size_t NUM_PARAMS = 14;
+
+protected:
+    bool solveHorizontal(MagnetometerCalibration &calibration, double &residual) const;
+
+    // upper triangle only
+    double _normal[NUM_PARAMS][NUM_PARAMS];
+    double _rhs[NUM_PARAMS];
+    size_t _samples;
+    double _firstTemperature;
+    double _minTemperature;
+    double _maxTemperature;
+    double _temperatureSum;
+};
+
+// takes the thermal drift from the offset change since the previous calibration
+void inheritTemperatureDrift(const MagnetometerCalibration &previous, MagnetometerCalibration &calibration);
+
+// fit over all samples, see EllipsoidFit
+bool fitEllipsoid(const std::vector<MagnetometerData> &samples, MagnetometerCalibration &calibration);
+
+// JSON file, written to a temporary file first and renamed
+bool loadCalibration(const std::string &path, MagnetometerCalibration &calibration);
+bool saveCalibration(const std::string &path, const MagnetometerCalibration &calibration);
+
+}
+
+#endif // MAGNETOMETERCALIBRATION_HPP
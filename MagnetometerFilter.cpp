@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "MagnetometerFilter.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace ship_position
+{
+
+MagnetometerFilter::MagnetometerFilter(MagnetometerFilterType type, size_t window, double alpha) :
+    _type(type),
+    _window(std::clamp<size_t>(window, 1, MAX_WINDOW)),
+    _alpha(std::clamp(alpha, 0.0, 1.0))
+{
+    reset();
+}
+
+void MagnetometerFilter::reset()
+{
+    _count = 0;
+    _next = 0;
+    for (size_t axis = 0; axis < NUM_AXES; axis++)
+    {
+        _sum[axis] = 0;
+        _average[axis] = 0.0;
+    }
+}
+
+MagnetometerData MagnetometerFilter::update(const MagnetometerData &sample)
+{
+    if (_type == MagnetometerFilterType::NONE)
+    {
+        return sample;
+    }
+
+    const int32_t values[NUM_AXES] = {sample.x, sample.y, sample.z};
+    int32_t filtered[NUM_AXES];
+    bool full = (_count == _window);
+
+    for (size_t axis = 0; axis < NUM_AXES; axis++)
+    {
+        int32_t value = values[axis];
+        if (_type == MagnetometerFilterType::EXPONENTIAL)
+        {
+            _average[axis] = (_count == 0) ? value : _average[axis] + _alpha * (value - _average[axis]);
+            filtered[axis] = static_cast<int32_t>(std::lround(_average[axis]));
+            continue;
+        }
+
+        int32_t oldest = _history[axis][_next];
+        _history[axis][_next] = value;
+
+        if (_type == MagnetometerFilterType::MOVING_AVERAGE)
+        {
+            _sum[axis] += value - (full ? oldest : 0);
+            size_t count = full ? _count : _count + 1;
+            filtered[axis] = static_cast<int32_t>(std::lround(static_cast<double>(_sum[axis]) / count));
+            continue;
+        }
+
+        // median: the oldest value leaves the sorted window and the new one is inserted in place
+        int32_t *sorted = _sorted[axis];
+        size_t size = _count;
+        if (full)
+        {
+            int32_t *position = std::lower_bound(sorted, sorted + size, oldest);
+            std::copy(position + 1, sorted + size, position);
+            size--;
+        }
+        int32_t *position = std::upper_bound(sorted, sorted + size, value);
+        std::copy_backward(position, sorted + size, sorted + size + 1);
+        *position = value;
+        size++;
+        filtered[axis] = (size % 2 == 1) ? sorted[size / 2] :
+            static_cast<int32_t>(std::lround((static_cast<int64_t>(sorted[size / 2 - 1]) + sorted[size / 2]) / 2.0));
+    }
+
+    if (_type != MagnetometerFilterType::EXPONENTIAL)
+    {
+        _next = (_next + 1) % _window;
+    }
+    if (!full)
+    {
+        _count++;
+    }
+
+    MagnetometerData result = sample;
+    result.x = filtered[0];
+    result.y = filtered[1];
+    result.z = filtered[2];
+    return result;
+}
+
+bool MagnetometerFilter::parseType(const std::string &name, MagnetometerFilterType &type)
+{
+    if (name == "none")
+    {
+        type = MagnetometerFilterType::NONE;
+    }
+    else if (name == "average")
+    {
+        type = MagnetometerFilterType::MOVING_AVERAGE;
+    }
+    else if (name == "median")
+    {
+        type = MagnetometerFilterType::MEDIAN;
+    }
+    else if (name == "exponential")
+    {
+        type = MagnetometerFilterType::EXPONENTIAL;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MAGNETOMETERFILTER_HPP
+#define MAGNETOMETERFILTER_HPP
+
+#include "MagnetometerReader.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ship_position
+{
+
+enum class MagnetometerFilterType
+{
+    NONE,
+    // mean of the last window samples
+    MOVING_AVERAGE,
+    // per axis median of the last window samples
+    MEDIAN,
+    // y += alpha * (x - y)
+    EXPONENTIAL
+};
+
+// smooths magnetometer samples one at a time, every update costs O(window) at most
+class MagnetometerFilter
+{
+public:
+    static constexpr size_t MAX_WINDOW = 64;
+
+    MagnetometerFilter(MagnetometerFilterType type, size_t window, double alpha);
+
+    // returns the filtered value, with timestamps of the sample
+    MagnetometerData update(const MagnetometerData &sample);
+    void reset();
+
+    // "none", "average", "median" or "exponential", returns false for anything else
+    static bool parseType(const std::string &name, MagnetometerFilterType &type);
+
+protected:
+    static constexpr size_t NUM_AXES = 3;
+
+    MagnetometerFilterType _type;
+    size_t _window;
+    double _alpha;
+    // last samples in arrival order, _next is the oldest once the window is full
+    int32_t _history[NUM_AXES][MAX_WINDOW];
+    size_t _count;
+    size_t _next;
+    int64_t _sum[NUM_AXES];
+    // the same samples sorted, for the median
+    int32_t _sorted[NUM_AXES][MAX_WINDOW];
+    double _average[NUM_AXES];
+};
+
+}
+
+#endif // MAGNETOMETERFILTER_HPP
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2024 - 2025 Mikhail Sapozhnikov
+ * Copyright (C) 2024 - 2026 Mikhail Sapozhnikov
  *
  * This file is part of ship-position.
  *
@@ -21,7 +21,9 @@
 #ifndef MAGNETOMETER_READER_HPP
 #define MAGNETOMETER_READER_HPP
 
+#include <cstddef>
 #include <cstdint>
+#include <vector>
 
 namespace ship_position
 {
@@ -31,16 +33,96 @@ struct MagnetometerData
     int32_t x;
     int32_t y;
     int32_t z;
+    // CLOCK_MONOTONIC nanoseconds when read from the sensor and when published, 0 before the first one
+    uint64_t arrivalNs;
+    uint64_t publishNs;
+    // sensor temperature, degrees C, relative only
+    double temperature;
 
-    MagnetometerData() : x(0), y(0), z(0) {}
+    MagnetometerData() : x(0), y(0), z(0), arrivalNs(0), publishNs(0), temperature(0.0) {}
+};
+
+struct HeadingData
+{
+    // degrees clockwise from magnetic north, [0, 360)
+    double magneticHeading;
+    // corrected by the configured declination
+    double trueHeading;
+    // of the magnetometer sample the heading was computed from
+    uint64_t arrivalNs;
+    uint64_t publishNs;
+
+    HeadingData() : magneticHeading(0.0), trueHeading(0.0), arrivalNs(0), publishNs(0) {}
+};
+
+struct MagnetometerStatistics
+{
+    // new measurements read from the sensor
+    uint64_t samples;
+    // measurements the sensor overwrote before they were read
+    uint64_t dropped;
+    // polls which found the previous measurement still in the data registers
+    uint64_t duplicates;
+    uint64_t readErrors;
+    // CLOCK_MONOTONIC nanoseconds the last new measurement was read, 0 before the first one
+    uint64_t lastArrivalNs;
+
+    MagnetometerStatistics() : samples(0), dropped(0), duplicates(0), readErrors(0), lastArrivalNs(0) {}
+};
+
+struct CalibrationStatus
+{
+    bool calibrating;
+    // coverage and residual are good enough, calibration stopped by itself
+    bool complete;
+    // samples accepted into the fit
+    uint64_t samples;
+    // fraction of directions around the sensor with enough samples, 0..1
+    double coverage;
+    // the same for headings only, regardless of pitch and roll
+    double headingCoverage;
+    // RMS residual of the fit relative to its radius, -1 without a fit
+    double residual;
+    // range of temperatures seen, degrees C; the thermal drift is learned from a wide enough one
+    double temperatureSpan;
+    // CLOCK_MONOTONIC nanoseconds the last sample was accepted, 0 before the first one
+    uint64_t arrivalNs;
+
+    CalibrationStatus() : calibrating(false), complete(false), samples(0), coverage(0.0), headingCoverage(0.0),
+        residual(-1.0), temperatureSpan(0.0), arrivalNs(0) {}
+};
+
+struct TemperatureCompensation
+{
+    // latest sensor temperature, degrees C, relative
+    double temperature;
+    // drift of the hard iron offset, raw units per degree C, learned during calibration
+    double coefficients[3];
+    // temperature the hard iron offset was fitted at
+    double referenceTemperature;
+    // subtracted from raw values now: coefficients * (temperature - referenceTemperature)
+    double correction[3];
+    // CLOCK_MONOTONIC nanoseconds the temperature was read, 0 before the first reading
+    uint64_t arrivalNs;
+
+    TemperatureCompensation() : temperature(0.0), coefficients{0.0, 0.0, 0.0}, referenceTemperature(0.0),
+        correction{0.0, 0.0, 0.0}, arrivalNs(0) {}
 };
 
 class MagnetometerReader
 {
 public:
+    // latest value, filtered
     virtual void getMagnetometerData(MagnetometerData &data) = 0;
+    // up to count latest unfiltered samples, oldest first
+    virtual void getMagnetometerSamples(size_t count, std::vector<MagnetometerData> &samples) = 0;
+    virtual void getMagnetometerStatistics(MagnetometerStatistics &statistics) = 0;
+    virtual void getHeading(HeadingData &heading) = 0;
+    virtual void getCalibrationStatus(CalibrationStatus &status) = 0;
+    virtual void getTemperatureCompensation(TemperatureCompensation &compensation) = 0;
     virtual void startCalibration() = 0;
-    virtual void stopCalibration() = 0;
+    // returns false if calibration wasn't running or the samples couldn't be fitted
+    virtual bool stopCalibration() = 0;
 };
 
 }
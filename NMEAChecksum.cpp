@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "NMEAChecksum.hpp"
+#include <cstring>
+
+namespace ship_position
+{
+
+uint8_t nmeaChecksum(const char *data, size_t length)
+{
+    // generic vector type, maps to SSE on x86 and NEON on ARM
+    typedef uint8_t Vector __attribute__((vector_size(16)));
+
+    uint8_t checksum = 0;
+    size_t i = 0;
+
+    if (length >= 2 * sizeof(Vector))
+    {
+        Vector acc0 = {};
+        Vector acc1 = {};
+        for (; i + 2 * sizeof(Vector) <= length; i += 2 * sizeof(Vector))
+        {
+            Vector v0;
+            Vector v1;
+            std::memcpy(&v0, data + i, sizeof(Vector));
+            std::memcpy(&v1, data + i + sizeof(Vector), sizeof(Vector));
+            acc0 ^= v0;
+            acc1 ^= v1;
+        }
+        acc0 ^= acc1;
+
+        uint64_t words[2];
+        std::memcpy(words, &acc0, sizeof(words));
+        uint64_t word = words[0] ^ words[1];
+        word ^= word >> 32;
+        word ^= word >> 16;
+        word ^= word >> 8;
+        checksum = static_cast<uint8_t>(word);
+    }
+
+    for (; i < length; i++)
+    {
+        checksum ^= static_cast<uint8_t>(data[i]);
+    }
+
+    return checksum;
+}
+
+bool verifyNMEAChecksum(std::string_view sentence)
+{
+    size_t length = sentence.size();
+    if ((length < 4) || (sentence[0] != '$') || (sentence[length - 3] != '*'))
+    {
+        return false;
+    }
+
+    int high = hexDigitValue(sentence[length - 2]);
+    int low = hexDigitValue(sentence[length - 1]);
+    if ((high == -1) || (low == -1))
+    {
+        return false;
+    }
+
+    return nmeaChecksum(sentence.data() + 1, length - 4) == ((high << 4) | low);
+}
+
+int hexDigitValue(char c)
+{
+    if ((c >= '0') && (c <= '9'))
+    {
+        return c - '0';
+    }
+    if ((c >= 'A') && (c <= 'F'))
+    {
+        return c - 'A' + 10;
+    }
+    if ((c >= 'a') && (c <= 'f'))
+    {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+}
@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef NMEA_CHECKSUM_HPP
+#define NMEA_CHECKSUM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace ship_position
+{
+
+// XOR of all bytes in data; long buffers are reduced 32 bytes at a time using vector registers
+uint8_t nmeaChecksum(const char *data, size_t length);
+
+// checks that sentence has the form $...*hh and that hh matches the data between '$' and '*'
+bool verifyNMEAChecksum(std::string_view sentence);
+
+// returns value of a hex digit or -1, if c is not a hex digit
+int hexDigitValue(char c);
+
+}
+
+#endif // NMEA_CHECKSUM_HPP
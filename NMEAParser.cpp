@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2024 Mikhail Sapozhnikov
+ * Copyright (C) 2024 - 2026 Mikhail Sapozhnikov
  *
  * This file is part of ship-position.
  *
@@ -19,103 +19,544 @@
  */
 
 #include "NMEAParser.hpp"
+#include "NMEAChecksum.hpp"
+#include <algorithm>
+#include <array>
+#include <charconv>
 
 namespace ship_position
 {
 
-void NMEAParser::parse(const std::string &data, GPSInfo &gpsInfo)
+namespace
 {
-    std::vector<std::string> lines;
-    split(data, "\n", lines);
-    for (auto& line : lines)
-    {
-        std::vector<std::string> fields;
-        split(line, ",", fields);
 
-        if (fields.empty())
-            continue;
+// BD/GB - BeiDou, GA - Galileo, GL - GLONASS, GN - combined, GP - GPS, GQ - QZSS
+constexpr std::string_view TALKERS[] = {"BD", "GA", "GB", "GL", "GN", "GP", "GQ"};
+
+template<typename Handler>
+struct SentenceType
+{
+    std::string_view type;
+    Handler handler;
+};
+
+template<typename Handler>
+struct DispatchEntry
+{
+    uint64_t key;
+    Handler handler;
+};
 
-        std::string key = fields[0];
+// packs address field characters into an integer, so that lookup compares a single word
+constexpr uint64_t addressKey(std::string_view address)
+{
+    uint64_t key = 0;
+    for (char c : address)
+    {
+        key = (key << 8) | static_cast<uint8_t>(c);
+    }
+    return key;
+}
 
-        if (key.find("GGA") != std::string::npos)
+// builds table of all talker+type combinations sorted by key
+template<typename Handler, size_t NumTalkers, size_t NumTypes>
+constexpr std::array<DispatchEntry<Handler>, NumTalkers * NumTypes> makeDispatchTable(
+    const std::string_view (&talkers)[NumTalkers], const SentenceType<Handler> (&types)[NumTypes])
+{
+    std::array<DispatchEntry<Handler>, NumTalkers * NumTypes> table{};
+    size_t idx = 0;
+    for (std::string_view talker : talkers)
+    {
+        for (const SentenceType<Handler> &type : types)
         {
-            parseGGA(fields, gpsInfo);
+            table[idx].key = (addressKey(talker) << 24) | addressKey(type.type);
+            table[idx].handler = type.handler;
+            idx++;
         }
-        else if (key.find("VTG") != std::string::npos)
+    }
+    std::sort(table.begin(), table.end(), [](const DispatchEntry<Handler> &a, const DispatchEntry<Handler> &b)
+    {
+        return a.key < b.key;
+    });
+    return table;
+}
+
+}
+
+void NMEAParser::parse(const std::string &data, GPSInfo &gpsInfo)
+{
+    NMEAStreamParser streamParser([this, &gpsInfo](std::string_view sentence, NMEAStreamParser::Status status)
+    {
+        parseSentence(sentence, status, gpsInfo);
+    });
+    size_t pos = 0;
+    while (pos < data.length())
+    {
+        pos += streamParser.feed(data.data() + pos, data.length() - pos);
+    }
+}
+
+void NMEAParser::parseSentence(std::string_view sentence, GPSInfo &gpsInfo)
+{
+    parseSentence(sentence, verifyNMEAChecksum(sentence) ? NMEAStreamParser::Status::VALID :
+        NMEAStreamParser::Status::INVALID, gpsInfo);
+}
+
+void NMEAParser::parseSentence(std::string_view sentence, NMEAStreamParser::Status status, GPSInfo &gpsInfo)
+{
+    NMEASentenceCounters &counters = _statistics.counters[NMEAStatistics::typeIndex(sentence)];
+
+    switch (status)
+    {
+        case NMEAStreamParser::Status::VALID:
+            counters.valid++;
+            parseFields(sentence, gpsInfo);
+            break;
+        case NMEAStreamParser::Status::INVALID:
+            counters.invalid++;
+            break;
+        case NMEAStreamParser::Status::TRUNCATED:
+            counters.truncated++;
+            break;
+    }
+}
+
+void NMEAParser::parseFields(std::string_view sentence, GPSInfo &gpsInfo)
+{
+    // the checksum is already verified, it shouldn't stick to the last field
+    sentence = sentence.substr(0, sentence.rfind('*'));
+
+    NMEAFields fields;
+    fields.size = split(sentence, ',', fields.fields, NMEAFields::MAX_FIELDS);
+
+    if (fields.empty() || (fields[0].size() < 2))
+        return;
+
+    SentenceHandler handler = findHandler(fields[0].substr(1));
+    if (handler != nullptr)
+    {
+        (this->*handler)(fields, gpsInfo);
+    }
+}
+
+NMEAParser::SentenceHandler NMEAParser::findHandler(std::string_view address)
+{
+    static constexpr SentenceType<SentenceHandler> types[] = {
+        {"GGA", &NMEAParser::parseGGA},
+        {"VTG", &NMEAParser::parseVTG},
+        {"RMC", &NMEAParser::parseRMC},
+        {"GSA", &NMEAParser::parseGSA},
+        {"GLL", &NMEAParser::parseGLL},
+        {"ZDA", &NMEAParser::parseZDA},
+        {"GSV", &NMEAParser::parseGSV}
+    };
+    static constexpr auto table = makeDispatchTable(TALKERS, types);
+
+    if (address.size() != 5)
+    {
+        return nullptr;
+    }
+
+    uint64_t key = addressKey(address);
+    auto it = std::lower_bound(table.begin(), table.end(), key, [](const DispatchEntry<SentenceHandler> &entry,
+        uint64_t key)
+    {
+        return entry.key < key;
+    });
+
+    if ((it == table.end()) || (it->key != key))
+    {
+        return nullptr;
+    }
+    return it->handler;
+}
+
+void NMEAParser::parseGGA(const NMEAFields &fields, GPSInfo &gpsInfo)
+{
+    if (fields.size < 8)
+    {
+        return;
+    }
+
+    parseTime(fields[1], gpsInfo);
+    bool position = parsePosition(fields, 2, gpsInfo);
+    parseInt(fields[6], gpsInfo.fixQuality);
+    parseInt(fields[7], gpsInfo.numSatellites);
+    if (position && (gpsInfo.fixQuality > 0))
+    {
+        gpsInfo.positionArrivalNs = gpsInfo.arrivalNs;
+    }
+    // HDOP and altitude are optional in short sentences
+    if (fields.size > 8)
+    {
+        parseDouble(fields[8], gpsInfo.hdop);
+    }
+    if (fields.size > 9)
+    {
+        parseDouble(fields[9], gpsInfo.altitude);
+    }
+}
+
+void NMEAParser::parseVTG(const NMEAFields &fields, GPSInfo &gpsInfo)
+{
+    if (fields.size < 8)
+    {
+        return;
+    }
+
+    parseDouble(fields[1], gpsInfo.courseOverGround);
+    parseDouble(fields[5], gpsInfo.speedKnots);
+    parseDouble(fields[7], gpsInfo.speedKm);
+}
+
+void NMEAParser::parseRMC(const NMEAFields &fields, GPSInfo &gpsInfo)
+{
+    if (fields.size < 10)
+    {
+        return;
+    }
+
+    // speed is taken from VTG, RMC provides date, course and the position when GGA is disabled
+    parseTime(fields[1], gpsInfo);
+    parseDate(fields[9], gpsInfo);
+    if (fields[2] == "A")
+    {
+        if (parsePosition(fields, 3, gpsInfo))
         {
-            parseVTG(fields, gpsInfo);
+            gpsInfo.positionArrivalNs = gpsInfo.arrivalNs;
         }
-    }   
+        parseDouble(fields[8], gpsInfo.courseOverGround);
+    }
 }
 
-void NMEAParser::parseGGA(const std::vector<std::string> &fields, GPSInfo &gpsInfo)
+void NMEAParser::parseGSA(const NMEAFields &fields, GPSInfo &gpsInfo)
 {
-    if (fields.size() < 8)
+    if (fields.size < 18)
     {
         return;
     }
 
-    if (!fields[2].empty() && !fields[3].empty())
+    parseInt(fields[2], gpsInfo.fixMode);
+    parseDouble(fields[15], gpsInfo.pdop);
+    parseDouble(fields[16], gpsInfo.hdop);
+    parseDouble(fields[17], gpsInfo.vdop);
+}
+
+void NMEAParser::parseGLL(const NMEAFields &fields, GPSInfo &gpsInfo)
+{
+    if (fields.size < 7)
     {
-        gpsInfo.latitude = parseCoordinates(fields[2], fields[3]);
+        return;
     }
-    if (!fields[4].empty() && !fields[5].empty())
+
+    if (fields[6] == "A")
+    {
+        if (parsePosition(fields, 1, gpsInfo))
+        {
+            gpsInfo.positionArrivalNs = gpsInfo.arrivalNs;
+        }
+        parseTime(fields[5], gpsInfo);
+    }
+}
+
+void NMEAParser::parseZDA(const NMEAFields &fields, GPSInfo &gpsInfo)
+{
+    if (fields.size < 5)
     {
-        gpsInfo.longitude = parseCoordinates(fields[4], fields[5]);
+        return;
     }
-    if (!fields[7].empty())
+
+    int day = 0;
+    int month = 0;
+    int year = 0;
+    if (parseInt(fields[2], day) && parseInt(fields[3], month) && parseInt(fields[4], year) &&
+        (day >= 1) && (day <= 31) && (month >= 1) && (month <= 12))
     {
-        gpsInfo.numSatellites = std::stoi(fields[7]);
+        parseTime(fields[1], gpsInfo);
+        gpsInfo.utcDay = day;
+        gpsInfo.utcMonth = month;
+        gpsInfo.utcYear = year;
     }
 }
 
-void NMEAParser::parseVTG(const std::vector<std::string> &fields, GPSInfo &gpsInfo)
+void NMEAParser::parseGSV(const NMEAFields &fields, GPSInfo &)
 {
-    if (fields.size() < 8)
+    int numMessages = 0;
+    int message = 0;
+    if ((fields.size < 4) || !parseInt(fields[1], numMessages) || !parseInt(fields[2], message))
     {
         return;
     }
 
-    if (!fields[5].empty())
+    GNSSSystem system = GNSSSystem::UNKNOWN;
+    std::string_view talker = fields[0].substr(1, 2);
+    if (talker == "GP")
+    {
+        system = GNSSSystem::GPS;
+    }
+    else if (talker == "GL")
+    {
+        system = GNSSSystem::GLONASS;
+    }
+    else if (talker == "GA")
+    {
+        system = GNSSSystem::GALILEO;
+    }
+    else if ((talker == "GB") || (talker == "BD"))
+    {
+        system = GNSSSystem::BEIDOU;
+    }
+    else if (talker == "GQ")
+    {
+        system = GNSSSystem::QZSS;
+    }
+
+    if (message == 1)
+    {
+        _pendingSatellites.count = 0;
+        _pendingSystem = system;
+        _pendingMessages = numMessages;
+        _nextMessage = 1;
+    }
+    if ((message != _nextMessage) || (system != _pendingSystem) || (numMessages != _pendingMessages))
     {
-        gpsInfo.speedKnots = std::stod(fields[5]);
+        // a part of the group was lost, wait for the next group
+        _nextMessage = 0;
+        return;
     }
-    if (!fields[7].empty())
+
+    // up to four satellites per message, NMEA 4.10 adds signal id after them
+    for (size_t idx = 4; idx + 3 < fields.size; idx += 4)
     {
-        gpsInfo.speedKm = std::stod(fields[7]);
+        int prn = 0;
+        if (!parseInt(fields[idx], prn) || (_pendingSatellites.count == SatelliteTable::MAX_SATELLITES))
+        {
+            continue;
+        }
+
+        int elevation = -1;
+        int azimuth = -1;
+        int snr = -1;
+        parseInt(fields[idx + 1], elevation);
+        parseInt(fields[idx + 2], azimuth);
+        parseInt(fields[idx + 3], snr);
+
+        size_t n = _pendingSatellites.count++;
+        _pendingSatellites.system[n] = system;
+        _pendingSatellites.prn[n] = prn;
+        _pendingSatellites.elevation[n] = elevation;
+        _pendingSatellites.azimuth[n] = azimuth;
+        _pendingSatellites.snr[n] = snr;
+    }
+
+    if (message == numMessages)
+    {
+        commitSatellites(system);
+        _nextMessage = 0;
+    }
+    else
+    {
+        _nextMessage++;
     }
 }
 
-void NMEAParser::split(const std::string &data, const std::string &delimiter, std::vector<std::string> &tokens)
+void NMEAParser::commitSatellites(GNSSSystem system)
 {
-    size_t pos = 0;
+    // drop previous satellites of the system, keeping the order of the rest
+    size_t count = 0;
+    for (size_t i = 0; i < _satellites.count; i++)
+    {
+        if (_satellites.system[i] != system)
+        {
+            _satellites.system[count] = _satellites.system[i];
+            _satellites.prn[count] = _satellites.prn[i];
+            _satellites.elevation[count] = _satellites.elevation[i];
+            _satellites.azimuth[count] = _satellites.azimuth[i];
+            _satellites.snr[count] = _satellites.snr[i];
+            count++;
+        }
+    }
+
+    for (size_t i = 0; (i < _pendingSatellites.count) && (count < SatelliteTable::MAX_SATELLITES); i++)
+    {
+        _satellites.system[count] = _pendingSatellites.system[i];
+        _satellites.prn[count] = _pendingSatellites.prn[i];
+        _satellites.elevation[count] = _pendingSatellites.elevation[i];
+        _satellites.azimuth[count] = _pendingSatellites.azimuth[i];
+        _satellites.snr[count] = _pendingSatellites.snr[i];
+        count++;
+    }
+    _satellites.count = count;
+}
+
+size_t NMEAParser::split(std::string_view data, char delimiter, std::string_view *tokens, size_t maxTokens)
+{
+    size_t count = 0;
 
     if (data.empty())
     {
-        return;
+        return 0;
     }
 
-    if ((pos = data.find(delimiter)) != std::string::npos)
+    while (count < maxTokens)
     {
-        tokens.push_back(data.substr(0, pos));
-        split(data.substr(pos + 1), delimiter, tokens);
+        size_t pos = data.find(delimiter);
+        tokens[count++] = data.substr(0, pos);
+        if (pos == std::string_view::npos)
+        {
+            break;
+        }
+        data.remove_prefix(pos + 1);
     }
-    else
+
+    return count;
+}
+
+bool NMEAParser::parseInt(std::string_view field, int &value)
+{
+    int result = 0;
+    const char *end = field.data() + field.size();
+    auto [ptr, ec] = std::from_chars(field.data(), end, result);
+    if (field.empty() || (ec != std::errc()) || (ptr != end))
+    {
+        return false;
+    }
+
+    value = result;
+    return true;
+}
+
+bool NMEAParser::parseDouble(std::string_view field, double &value)
+{
+    double result = 0.0;
+    const char *end = field.data() + field.size();
+    auto [ptr, ec] = std::from_chars(field.data(), end, result, std::chars_format::fixed);
+    if (field.empty() || (ec != std::errc()) || (ptr != end))
     {
-        tokens.push_back(data);
+        return false;
     }
+
+    value = result;
+    return true;
 }
 
-double NMEAParser::parseCoordinates(const std::string &digits, const std::string &direction)
+bool NMEAParser::parseCoordinates(std::string_view digits, std::string_view direction, double &coordinates)
 {
-    std::string trimmedDigits = digits.substr(digits.find_first_not_of("0"));
-    double coordinates = std::stod(trimmedDigits.substr(0, 2)) + (std::stod(trimmedDigits.substr(2)) / 60);
-    if ((direction == "S") || (direction == "W"))
+    if ((direction.size() != 1) || (digits.size() < 3))
+    {
+        return false;
+    }
+
+    double maxDegrees = 0;
+    bool negative = false;
+    switch (direction[0])
+    {
+        case 'S':
+            negative = true;
+            [[fallthrough]];
+        case 'N':
+            maxDegrees = 90;
+            break;
+        case 'W':
+            negative = true;
+            [[fallthrough]];
+        case 'E':
+            maxDegrees = 180;
+            break;
+        default:
+            return false;
+    }
+
+    // the last two digits before the decimal point are minutes, the rest are degrees
+    size_t point = digits.find('.');
+    if (point == std::string_view::npos)
+    {
+        point = digits.size();
+    }
+    if (point < 3)
+    {
+        return false;
+    }
+
+    int degrees = 0;
+    double minutes = 0.0;
+    if (!parseInt(digits.substr(0, point - 2), degrees) || !parseDouble(digits.substr(point - 2), minutes))
+    {
+        return false;
+    }
+    if ((degrees < 0) || (minutes < 0.0) || (minutes >= 60.0))
+    {
+        return false;
+    }
+
+    double result = degrees + (minutes / 60);
+    if (result > maxDegrees)
+    {
+        return false;
+    }
+
+    coordinates = negative ? -result : result;
+    return true;
+}
+
+bool NMEAParser::parsePosition(const NMEAFields &fields, size_t first, GPSInfo &gpsInfo)
+{
+    // half a position is no position, neither coordinate is updated then
+    double latitude = 0.0;
+    double longitude = 0.0;
+    if (!parseCoordinates(fields[first], fields[first + 1], latitude) ||
+        !parseCoordinates(fields[first + 2], fields[first + 3], longitude))
+    {
+        return false;
+    }
+    gpsInfo.latitude = latitude;
+    gpsInfo.longitude = longitude;
+    return true;
+}
+
+bool NMEAParser::parseTime(std::string_view field, GPSInfo &gpsInfo)
+{
+    int hours = 0;
+    int minutes = 0;
+    double seconds = 0.0;
+
+    if ((field.size() < 6) || !parseInt(field.substr(0, 2), hours) || !parseInt(field.substr(2, 2), minutes) ||
+        !parseDouble(field.substr(4), seconds))
+    {
+        return false;
+    }
+    // 60 seconds are allowed for leap second
+    if ((hours < 0) || (hours > 23) || (minutes < 0) || (minutes > 59) || (seconds < 0.0) || (seconds >= 61.0))
+    {
+        return false;
+    }
+
+    gpsInfo.utcHours = hours;
+    gpsInfo.utcMinutes = minutes;
+    gpsInfo.utcSeconds = seconds;
+    return true;
+}
+
+bool NMEAParser::parseDate(std::string_view field, GPSInfo &gpsInfo)
+{
+    int day = 0;
+    int month = 0;
+    int year = 0;
+
+    if ((field.size() != 6) || !parseInt(field.substr(0, 2), day) || !parseInt(field.substr(2, 2), month) ||
+        !parseInt(field.substr(4, 2), year))
+    {
+        return false;
+    }
+    if ((day < 1) || (day > 31) || (month < 1) || (month > 12) || (year < 0))
     {
-        coordinates *= -1;
+        return false;
     }
 
-    return coordinates;
+    gpsInfo.utcDay = day;
+    gpsInfo.utcMonth = month;
+    gpsInfo.utcYear = 2000 + year;
+    return true;
 }
 
 }
\ No newline at end of file
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2024 Mikhail Sapozhnikov
+ * Copyright (C) 2024 - 2026 Mikhail Sapozhnikov
  *
  * This file is part of ship-position.
  *
@@ -22,22 +22,78 @@
 #define NMEA_PARSER_HPP
 
 #include "GPSReader.hpp"
+#include "NMEAStreamParser.hpp"
+#include <cstddef>
 #include <string>
-#include <vector>
+#include <string_view>
 
 namespace ship_position
 {
 
+// fields of a single sentence, point into the sentence data
+struct NMEAFields
+{
+    // enough for the longest standard sentences (GSV, GSA)
+    static constexpr size_t MAX_FIELDS = 32;
+
+    std::string_view fields[MAX_FIELDS];
+    size_t size = 0;
+
+    const std::string_view &operator[](size_t idx) const { return fields[idx]; }
+    bool empty() const { return size == 0; }
+};
+
 class NMEAParser
 {
 public:
+    // parses all checksum-verified sentences found in data
     void parse(const std::string &data, GPSInfo &gpsInfo);
+    // verifies checksum of a single sentence without the line terminator and parses it
+    void parseSentence(std::string_view sentence, GPSInfo &gpsInfo);
+    // accounts a sentence framed and verified by NMEAStreamParser and parses it, if it is valid
+    void parseSentence(std::string_view sentence, NMEAStreamParser::Status status, GPSInfo &gpsInfo);
+
+    const NMEAStatistics &getStatistics() const { return _statistics; }
+    // satellites of the last complete GSV group of every constellation
+    const SatelliteTable &getSatellites() const { return _satellites; }
 
 protected:
-    void split(const std::string &data, const std::string &delimited, std::vector<std::string> &tokens);
-    void parseGGA(const std::vector<std::string> &fields, GPSInfo &gpsInfo);
-    void parseVTG(const std::vector<std::string> &fields, GPSInfo &gpsInfo);
-    double parseCoordinates(const std::string &digits, const std::string &direction);
+    void parseFields(std::string_view sentence, GPSInfo &gpsInfo);
+    // splits data into at most maxTokens tokens, returns number of tokens
+    size_t split(std::string_view data, char delimiter, std::string_view *tokens, size_t maxTokens);
+    void parseGGA(const NMEAFields &fields, GPSInfo &gpsInfo);
+    void parseVTG(const NMEAFields &fields, GPSInfo &gpsInfo);
+    void parseRMC(const NMEAFields &fields, GPSInfo &gpsInfo);
+    void parseGSA(const NMEAFields &fields, GPSInfo &gpsInfo);
+    void parseGLL(const NMEAFields &fields, GPSInfo &gpsInfo);
+    void parseZDA(const NMEAFields &fields, GPSInfo &gpsInfo);
+    void parseGSV(const NMEAFields &fields, GPSInfo &gpsInfo);
+    // replaces satellites of the system in _satellites with the collected GSV group
+    void commitSatellites(GNSSSystem system);
+
+    typedef void (NMEAParser::*SentenceHandler)(const NMEAFields &fields, GPSInfo &gpsInfo);
+    // looks up handler for a talker+type address field (e.g. GNGGA), returns nullptr if there is none
+    static SentenceHandler findHandler(std::string_view address);
+
+    // locale independent, return false and leave value untouched if the field is malformed
+    static bool parseInt(std::string_view field, int &value);
+    static bool parseDouble(std::string_view field, double &value);
+    // converts (d)ddmm.mmmmm and N/S/E/W direction into signed degrees
+    static bool parseCoordinates(std::string_view digits, std::string_view direction, double &coordinates);
+    // latitude and longitude, each field pair starting at first; returns true if both were well-formed
+    static bool parsePosition(const NMEAFields &fields, size_t first, GPSInfo &gpsInfo);
+    // hhmmss.ss
+    static bool parseTime(std::string_view field, GPSInfo &gpsInfo);
+    // ddmmyy
+    static bool parseDate(std::string_view field, GPSInfo &gpsInfo);
+
+    NMEAStatistics _statistics;
+    SatelliteTable _satellites;
+    // GSV group being collected
+    SatelliteTable _pendingSatellites;
+    GNSSSystem _pendingSystem = GNSSSystem::UNKNOWN;
+    int _pendingMessages = 0;
+    int _nextMessage = 0;
 };
 
 }
@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "NMEAStreamParser.hpp"
+#include "NMEAChecksum.hpp"
+#include <cstring>
+
+namespace ship_position
+{
+
+NMEAStreamParser::NMEAStreamParser(SentenceCallback onSentence) :
+    _onSentence(onSentence),
+    _state(State::WAIT_START),
+    _pendingLength(0),
+    _length(0),
+    _expectedChecksum(0),
+    _checksumErrors(0),
+    _truncated(0)
+{
+}
+
+size_t NMEAStreamParser::feed(const char *data, size_t length)
+{
+    // start of the current sentence in data; if it started in one of the previous chunks, its head is pending
+    size_t begin = 0;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        char c = data[i];
+        // sentences consist of printable ASCII only, anything else is most likely binary protocol data
+        bool printable = (c >= 0x20) && (c <= 0x7e);
+
+        switch (_state)
+        {
+            case State::WAIT_START:
+                // everything between sentences, including line terminators, is skipped
+                if (c == '$')
+                {
+                    start();
+                    begin = i;
+                }
+                break;
+
+            case State::BODY:
+                if (c == '$')
+                {
+                    truncate(sentence(data, begin, i));
+                    start();
+                    begin = i;
+                }
+                else if (c == '*')
+                {
+                    _length++;
+                    _state = State::CHECKSUM_HIGH;
+                }
+                else if (!printable)
+                {
+                    // line ended without checksum or binary data follows
+                    truncate(sentence(data, begin, i));
+                    return ((c == '\r') || (c == '\n')) ? i + 1 : i;
+                }
+                else if (_length == MAX_SENTENCE_LENGTH - 3)
+                {
+                    // no room left for the checksum
+                    truncate(sentence(data, begin, i));
+                    return i + 1;
+                }
+                else
+                {
+                    _length++;
+                }
+                break;
+
+            case State::CHECKSUM_HIGH:
+            case State::CHECKSUM_LOW:
+            {
+                int value = hexDigitValue(c);
+                if (value == -1)
+                {
+                    truncate(sentence(data, begin, i));
+                    if (c == '$')
+                    {
+                        start();
+                        begin = i;
+                        break;
+                    }
+                    return printable ? i + 1 : i;
+                }
+
+                _length++;
+                if (_state == State::CHECKSUM_HIGH)
+                {
+                    _expectedChecksum = value << 4;
+                    _state = State::CHECKSUM_LOW;
+                    break;
+                }
+
+                _expectedChecksum |= value;
+                _state = State::WAIT_START;
+                // the sentence is complete, no need to wait for the line terminator
+                std::string_view complete = sentence(data, begin, i + 1);
+                if (nmeaChecksum(complete.data() + 1, complete.length() - 4) == _expectedChecksum)
+                {
+                    _onSentence(complete, Status::VALID);
+                }
+                else
+                {
+                    _checksumErrors++;
+                    _onSentence(complete, Status::INVALID);
+                }
+                _pendingLength = 0;
+                return i + 1;
+            }
+        }
+    }
+
+    if (_state != State::WAIT_START)
+    {
+        // the sentence continues in the next chunk
+        std::memcpy(_pending + _pendingLength, data + begin, length - begin);
+        _pendingLength += length - begin;
+    }
+    return length;
+}
+
+void NMEAStreamParser::reset()
+{
+    _state = State::WAIT_START;
+    _pendingLength = 0;
+    _length = 0;
+}
+
+void NMEAStreamParser::start()
+{
+    _pendingLength = 0;
+    _length = 1;
+    _state = State::BODY;
+}
+
+std::string_view NMEAStreamParser::sentence(const char *data, size_t begin, size_t end)
+{
+    if (_pendingLength == 0)
+    {
+        return std::string_view(data + begin, end - begin);
+    }
+
+    // the sentence started in one of the previous chunks, so begin is 0
+    std::memcpy(_pending + _pendingLength, data, end);
+    _pendingLength += end;
+    return std::string_view(_pending, _pendingLength);
+}
+
+void NMEAStreamParser::truncate(std::string_view sentence)
+{
+    _truncated++;
+    _state = State::WAIT_START;
+    _onSentence(sentence, Status::TRUNCATED);
+    _pendingLength = 0;
+}
+
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef NMEA_STREAM_PARSER_HPP
+#define NMEA_STREAM_PARSER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+namespace ship_position
+{
+
+// resumable NMEA framing state machine, calls back with every sentence once its checksum is verified
+class NMEAStreamParser
+{
+public:
+    enum class Status
+    {
+        VALID,
+        // checksum doesn't match the data
+        INVALID,
+        // sentence was cut short or is too long, the data received so far is passed
+        TRUNCATED
+    };
+
+    // sentence is passed without the line terminator and is valid only during the callback
+    typedef std::function<void(std::string_view sentence, Status status)> SentenceCallback;
+
+    // longest sentence kept, including '$' and checksum; standard sentences are at most 82 bytes
+    static constexpr size_t MAX_SENTENCE_LENGTH = 128;
+
+    NMEAStreamParser(SentenceCallback onSentence);
+
+    // returns number of bytes consumed, stops after each sentence and before non-NMEA bytes
+    size_t feed(const char *data, size_t length);
+    // drops the partially received sentence
+    void reset();
+    // true if no sentence is being received
+    bool idle() const { return _state == State::WAIT_START; }
+
+    // sentences dropped because of checksum mismatch
+    uint64_t checksumErrors() const { return _checksumErrors; }
+    // sentences dropped because they were cut short or too long
+    uint64_t truncated() const { return _truncated; }
+
+protected:
+    enum class State
+    {
+        WAIT_START,
+        BODY,
+        CHECKSUM_HIGH,
+        CHECKSUM_LOW
+    };
+
+    void start();
+    // sentence received so far, ending at data + end
+    std::string_view sentence(const char *data, size_t begin, size_t end);
+    void truncate(std::string_view sentence);
+
+    SentenceCallback _onSentence;
+    State _state;
+    // head of a sentence split between chunks
+    char _pending[MAX_SENTENCE_LENGTH];
+    size_t _pendingLength;
+    // bytes of the current sentence received so far
+    size_t _length;
+    uint8_t _expectedChecksum;
+    uint64_t _checksumErrors;
+    uint64_t _truncated;
+};
+
+}
+
+#endif // NMEA_STREAM_PARSER_HPP
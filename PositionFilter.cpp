@@ -0,0 +1,365 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "PositionFilter.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace ship_position
+{
+
+namespace
+{
+
+constexpr double PI = 3.14159265358979323846;
+constexpr double DEGREES_TO_RADIANS = PI / 180.0;
+constexpr double MPS_PER_KNOT = 1852.0 / 3600.0;
+// mean earth radius, a sphere is close enough over a few kilometers
+constexpr double METERS_PER_DEGREE = 6371008.8 * DEGREES_TO_RADIANS;
+// 1 sigma of the state the first fix can't tell
+constexpr double INITIAL_SPEED_SIGMA = 1.0;
+constexpr double INITIAL_HEADING_SIGMA = 30.0 * DEGREES_TO_RADIANS;
+constexpr double INITIAL_TURN_RATE_SIGMA = 3.0 * DEGREES_TO_RADIANS;
+constexpr double INITIAL_CURRENT_SIGMA = 0.5;
+
+// [0, 2pi)
+double wrapAngle(double angle)
+{
+    angle = std::fmod(angle, 2.0 * PI);
+    return (angle < 0.0) ? angle + 2.0 * PI : angle;
+}
+
+// [-pi, pi)
+double angleDifference(double a, double b)
+{
+    double difference = wrapAngle(a - b);
+    return (difference >= PI) ? difference - 2.0 * PI : difference;
+}
+
+// [-180, 180)
+double wrapLongitude(double longitude)
+{
+    longitude = std::fmod(longitude + 180.0, 360.0);
+    return ((longitude < 0.0) ? longitude + 360.0 : longitude) - 180.0;
+}
+
+double toDegrees(double radians)
+{
+    double degrees = radians / DEGREES_TO_RADIANS;
+    return (degrees < 0.0) ? degrees + 360.0 : degrees;
+}
+
+}
+
+PositionFilter::PositionFilter(const FusionConfig &config) :
+_positionVariance(config.positionNoise * config.positionNoise),
+_velocityVariance(config.velocityNoise * config.velocityNoise),
+_headingVariance(std::pow(config.headingNoise * DEGREES_TO_RADIANS, 2)),
+_accelerationNoise(config.accelerationNoise * config.accelerationNoise),
+_turnNoise(std::pow(config.turnNoise * DEGREES_TO_RADIANS, 2)),
+_currentNoise(config.currentNoise * config.currentNoise),
+_pendingHeading(-1.0)
+{
+    reset();
+}
+
+void PositionFilter::reset()
+{
+    _initialized = false;
+    _rejectedFixes = 0;
+    std::fill(_x, _x + NUM_STATES, 0.0);
+    for (size_t i = 0; i < NUM_STATES; i++)
+    {
+        std::fill(_p[i], _p[i] + NUM_STATES, 0.0);
+    }
+    setOrigin(0.0, 0.0);
+}
+
+void PositionFilter::predict(double dt)
+{
+    if (!_initialized)
+    {
+        return;
+    }
+    while (dt > 0.0)
+    {
+        double stepDt = std::min(dt, MAX_STEP);
+        step(stepDt);
+        dt -= stepDt;
+    }
+}
+
+void PositionFilter::step(double dt)
+{
+    // the heading in the middle of the step, so that turns don't lag
+    double speed = _x[SPEED];
+    double heading = _x[HEADING] + _x[TURN_RATE] * dt / 2.0;
+    double c = std::cos(heading);
+    double s = std::sin(heading);
+
+    _x[NORTH] += (speed * c + _x[CURRENT_NORTH]) * dt;
+    _x[EAST] += (speed * s + _x[CURRENT_EAST]) * dt;
+    _x[HEADING] = wrapAngle(_x[HEADING] + _x[TURN_RATE] * dt);
+
+    // F differs from the identity in the north, east and heading rows only
+    double f[3][NUM_STATES] = {};
+    const StateIndex rows[3] = {NORTH, EAST, HEADING};
+    f[0][NORTH] = 1.0;
+    f[0][SPEED] = c * dt;
+    f[0][HEADING] = -speed * s * dt;
+    f[0][TURN_RATE] = -speed * s * dt * dt / 2.0;
+    f[0][CURRENT_NORTH] = dt;
+    f[1][EAST] = 1.0;
+    f[1][SPEED] = s * dt;
+    f[1][HEADING] = speed * c * dt;
+    f[1][TURN_RATE] = speed * c * dt * dt / 2.0;
+    f[1][CURRENT_EAST] = dt;
+    f[2][HEADING] = 1.0;
+    f[2][TURN_RATE] = dt;
+
+    double combined[3][NUM_STATES];
+    for (size_t r = 0; r < 3; r++)
+    {
+        for (size_t j = 0; j < NUM_STATES; j++)
+        {
+            double sum = 0.0;
+            for (size_t k = 0; k < NUM_STATES; k++)
+            {
+                sum += f[r][k] * _p[k][j];
+            }
+            combined[r][j] = sum;
+        }
+    }
+    for (size_t r = 0; r < 3; r++)
+    {
+        std::copy(combined[r], combined[r] + NUM_STATES, _p[rows[r]]);
+    }
+    for (size_t r = 0; r < 3; r++)
+    {
+        for (size_t i = 0; i < NUM_STATES; i++)
+        {
+            double sum = 0.0;
+            for (size_t k = 0; k < NUM_STATES; k++)
+            {
+                sum += _p[i][k] * f[r][k];
+            }
+            combined[r][i] = sum;
+        }
+    }
+    for (size_t r = 0; r < 3; r++)
+    {
+        for (size_t i = 0; i < NUM_STATES; i++)
+        {
+            _p[i][rows[r]] = combined[r][i];
+        }
+    }
+
+    // random walks of speed, turn rate and current, integrated into position and heading
+    double dt2 = dt * dt;
+    double dt3 = dt2 * dt;
+    _p[NORTH][NORTH] += _accelerationNoise * dt3 / 3.0;
+    _p[EAST][EAST] += _accelerationNoise * dt3 / 3.0;
+    _p[SPEED][SPEED] += _accelerationNoise * dt;
+    _p[HEADING][HEADING] += _turnNoise * dt3 / 3.0;
+    _p[HEADING][TURN_RATE] += _turnNoise * dt2 / 2.0;
+    _p[TURN_RATE][HEADING] += _turnNoise * dt2 / 2.0;
+    _p[TURN_RATE][TURN_RATE] += _turnNoise * dt;
+    _p[CURRENT_NORTH][CURRENT_NORTH] += _currentNoise * dt;
+    _p[CURRENT_EAST][CURRENT_EAST] += _currentNoise * dt;
+}
+
+bool PositionFilter::updateGPS(double latitude, double longitude, double speedKnots, double course, double hdop)
+{
+    if (!_initialized)
+    {
+        initialize(latitude, longitude, speedKnots, course, hdop);
+        return true;
+    }
+
+    double north = 0.0;
+    double east = 0.0;
+    toLocal(latitude, longitude, north, east);
+    double positionVariance = _positionVariance * ((hdop > 0.0) ? hdop * hdop : 1.0);
+
+    // both coordinates at once: a jump shows in their joint distance, not in either alone
+    double dn = north - _x[NORTH];
+    double de = east - _x[EAST];
+    double s00 = _p[NORTH][NORTH] + positionVariance;
+    double s01 = _p[NORTH][EAST];
+    double s11 = _p[EAST][EAST] + positionVariance;
+    double determinant = s00 * s11 - s01 * s01;
+    double distance = (dn * dn * s11 - 2.0 * dn * de * s01 + de * de * s00) / determinant;
+    if (distance > POSITION_GATE)
+    {
+        if (++_rejectedFixes < MAX_REJECTED_FIXES)
+        {
+            return false;
+        }
+        // consistently far off, the prediction is what's wrong
+        initialize(latitude, longitude, speedKnots, course, hdop);
+        return true;
+    }
+    _rejectedFixes = 0;
+
+    double h[NUM_STATES] = {};
+    h[NORTH] = 1.0;
+    update(h, north - _x[NORTH], positionVariance);
+    h[NORTH] = 0.0;
+    h[EAST] = 1.0;
+    update(h, east - _x[EAST], positionVariance);
+    h[EAST] = 0.0;
+
+    // velocity over ground: speed along the heading plus the current
+    double velocityNorth = speedKnots * MPS_PER_KNOT * std::cos(course * DEGREES_TO_RADIANS);
+    double velocityEast = speedKnots * MPS_PER_KNOT * std::sin(course * DEGREES_TO_RADIANS);
+    double c = std::cos(_x[HEADING]);
+    double s = std::sin(_x[HEADING]);
+    h[SPEED] = c;
+    h[HEADING] = -_x[SPEED] * s;
+    h[CURRENT_NORTH] = 1.0;
+    update(h, velocityNorth - (_x[SPEED] * c + _x[CURRENT_NORTH]), _velocityVariance);
+
+    c = std::cos(_x[HEADING]);
+    s = std::sin(_x[HEADING]);
+    h[SPEED] = s;
+    h[HEADING] = _x[SPEED] * c;
+    h[CURRENT_NORTH] = 0.0;
+    h[CURRENT_EAST] = 1.0;
+    update(h, velocityEast - (_x[SPEED] * s + _x[CURRENT_EAST]), _velocityVariance);
+
+    if (std::hypot(_x[NORTH], _x[EAST]) > RECENTER_DISTANCE)
+    {
+        // the plane is a good approximation near the origin only
+        FusedState state;
+        getState(state);
+        setOrigin(state.latitude, state.longitude);
+        _x[NORTH] = 0.0;
+        _x[EAST] = 0.0;
+    }
+    return true;
+}
+
+void PositionFilter::updateHeading(double heading)
+{
+    _pendingHeading = wrapAngle(heading * DEGREES_TO_RADIANS);
+    if (!_initialized)
+    {
+        return;
+    }
+
+    double h[NUM_STATES] = {};
+    h[HEADING] = 1.0;
+    update(h, angleDifference(_pendingHeading, _x[HEADING]), _headingVariance);
+}
+
+void PositionFilter::getState(FusedState &state) const
+{
+    state.valid = _initialized;
+    state.latitude = _originLatitude + _x[NORTH] / METERS_PER_DEGREE;
+    state.longitude = wrapLongitude(_originLongitude + _x[EAST] / _metersPerDegreeLongitude);
+
+    double velocityNorth = _x[SPEED] * std::cos(_x[HEADING]) + _x[CURRENT_NORTH];
+    double velocityEast = _x[SPEED] * std::sin(_x[HEADING]) + _x[CURRENT_EAST];
+    state.speedKnots = std::hypot(velocityNorth, velocityEast) / MPS_PER_KNOT;
+    state.courseOverGround = toDegrees(std::atan2(velocityEast, velocityNorth));
+    state.heading = toDegrees(_x[HEADING]);
+    state.turnRate = _x[TURN_RATE] / DEGREES_TO_RADIANS;
+    state.currentKnots = std::hypot(_x[CURRENT_NORTH], _x[CURRENT_EAST]) / MPS_PER_KNOT;
+    state.currentDirection = toDegrees(std::atan2(_x[CURRENT_EAST], _x[CURRENT_NORTH]));
+    state.positionError = std::sqrt(_p[NORTH][NORTH] + _p[EAST][EAST]);
+    state.headingError = std::sqrt(_p[HEADING][HEADING]) / DEGREES_TO_RADIANS;
+}
+
+void PositionFilter::initialize(double latitude, double longitude, double speedKnots, double course, double hdop)
+{
+    reset();
+    setOrigin(latitude, longitude);
+
+    // with a compass, velocity across the heading is taken for current
+    double velocityNorth = speedKnots * MPS_PER_KNOT * std::cos(course * DEGREES_TO_RADIANS);
+    double velocityEast = speedKnots * MPS_PER_KNOT * std::sin(course * DEGREES_TO_RADIANS);
+    double heading = (_pendingHeading >= 0.0) ? _pendingHeading : wrapAngle(course * DEGREES_TO_RADIANS);
+    double c = std::cos(heading);
+    double s = std::sin(heading);
+    _x[SPEED] = velocityNorth * c + velocityEast * s;
+    _x[HEADING] = heading;
+    _x[CURRENT_NORTH] = velocityNorth - _x[SPEED] * c;
+    _x[CURRENT_EAST] = velocityEast - _x[SPEED] * s;
+
+    double positionVariance = _positionVariance * ((hdop > 0.0) ? hdop * hdop : 1.0);
+    _p[NORTH][NORTH] = positionVariance;
+    _p[EAST][EAST] = positionVariance;
+    _p[SPEED][SPEED] = INITIAL_SPEED_SIGMA * INITIAL_SPEED_SIGMA;
+    _p[HEADING][HEADING] = (_pendingHeading >= 0.0) ? _headingVariance : INITIAL_HEADING_SIGMA * INITIAL_HEADING_SIGMA;
+    _p[TURN_RATE][TURN_RATE] = INITIAL_TURN_RATE_SIGMA * INITIAL_TURN_RATE_SIGMA;
+    _p[CURRENT_NORTH][CURRENT_NORTH] = INITIAL_CURRENT_SIGMA * INITIAL_CURRENT_SIGMA;
+    _p[CURRENT_EAST][CURRENT_EAST] = INITIAL_CURRENT_SIGMA * INITIAL_CURRENT_SIGMA;
+    _initialized = true;
+}
+
+void PositionFilter::update(const double (&h)[NUM_STATES], double innovation, double variance)
+{
+    // P H^T, which is also (H P)^T as P is symmetric
+    double ph[NUM_STATES];
+    double s = variance;
+    for (size_t i = 0; i < NUM_STATES; i++)
+    {
+        double sum = 0.0;
+        for (size_t j = 0; j < NUM_STATES; j++)
+        {
+            sum += _p[i][j] * h[j];
+        }
+        ph[i] = sum;
+        s += h[i] * sum;
+    }
+
+    for (size_t i = 0; i < NUM_STATES; i++)
+    {
+        _x[i] += ph[i] / s * innovation;
+    }
+    _x[HEADING] = wrapAngle(_x[HEADING]);
+
+    // P = P - K H P, kept exactly symmetric
+    for (size_t i = 0; i < NUM_STATES; i++)
+    {
+        for (size_t j = i; j < NUM_STATES; j++)
+        {
+            double value = _p[i][j] - ph[i] * ph[j] / s;
+            _p[i][j] = value;
+            _p[j][i] = value;
+        }
+    }
+}
+
+void PositionFilter::toLocal(double latitude, double longitude, double &north, double &east) const
+{
+    north = (latitude - _originLatitude) * METERS_PER_DEGREE;
+    east = wrapLongitude(longitude - _originLongitude) * _metersPerDegreeLongitude;
+}
+
+void PositionFilter::setOrigin(double latitude, double longitude)
+{
+    _originLatitude = latitude;
+    _originLongitude = longitude;
+    // never 0, even at the poles
+    _metersPerDegreeLongitude = std::max(METERS_PER_DEGREE * std::cos(latitude * DEGREES_TO_RADIANS), 1.0);
+}
+
+}
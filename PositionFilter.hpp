@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef POSITIONFILTER_HPP
+#define POSITIONFILTER_HPP
+
+#include "FusionConfig.hpp"
+#include "FusionReader.hpp"
+#include <cstddef>
+
+namespace ship_position
+{
+
+// extended Kalman filter of a vessel moving along its heading through the water and carried by the current
+class PositionFilter
+{
+public:
+    enum StateIndex
+    {
+        // meters from the origin
+        NORTH,
+        EAST,
+        // through the water, m/s
+        SPEED,
+        // radians true, [0, 2pi)
+        HEADING,
+        // radians per second
+        TURN_RATE,
+        // m/s
+        CURRENT_NORTH,
+        CURRENT_EAST,
+        NUM_STATES
+    };
+
+    // squared Mahalanobis distance of a rejected fix, 99.99% for two degrees of freedom
+    static constexpr double POSITION_GATE = 18.4;
+    // the filter starts over with the fix after this many rejected in a row
+    static constexpr int MAX_REJECTED_FIXES = 5;
+    // longer predictions are split into steps of at most this many seconds
+    static constexpr double MAX_STEP = 0.1;
+    // the origin moves to the current position when it is farther away than this many meters
+    static constexpr double RECENTER_DISTANCE = 10000.0;
+
+    PositionFilter(const FusionConfig &config);
+
+    bool initialized() const { return _initialized; }
+    // forgets the state, the next fix starts over; a compass heading seen before is kept
+    void reset();
+
+    // moves the state forward by dt seconds
+    void predict(double dt);
+    // degrees, knots, degrees true, hdop 0 if unknown; returns false if rejected as an outlier
+    bool updateGPS(double latitude, double longitude, double speedKnots, double course, double hdop);
+    // degrees true
+    void updateHeading(double heading);
+
+    // everything but the times
+    void getState(FusedState &state) const;
+    double state(StateIndex index) const { return _x[index]; }
+    double covariance(StateIndex row, StateIndex column) const { return _p[row][column]; }
+
+protected:
+    void initialize(double latitude, double longitude, double speedKnots, double course, double hdop);
+    // one predict step of at most MAX_STEP
+    void step(double dt);
+    // scalar measurement with Jacobian h, innovation measured - predicted and variance
+    void update(const double (&h)[NUM_STATES], double innovation, double variance);
+    void toLocal(double latitude, double longitude, double &north, double &east) const;
+    void setOrigin(double latitude, double longitude);
+
+    // variances of the measurements and spectral densities of the process noise, SI units
+    double _positionVariance;
+    double _velocityVariance;
+    double _headingVariance;
+    double _accelerationNoise;
+    double _turnNoise;
+    double _currentNoise;
+
+    bool _initialized;
+    double _x[NUM_STATES];
+    double _p[NUM_STATES][NUM_STATES];
+    int _rejectedFixes;
+    // compass heading seen before the first fix, radians, < 0 if none
+    double _pendingHeading;
+    double _originLatitude;
+    double _originLongitude;
+    double _metersPerDegreeLongitude;
+};
+
+}
+
+#endif // POSITIONFILTER_HPP
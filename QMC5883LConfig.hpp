@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2024 - 2025 Mikhail Sapozhnikov
+ * Copyright (C) 2024 - 2026 Mikhail Sapozhnikov
  *
  * This file is part of ship-position.
  *
@@ -30,10 +30,31 @@ struct QMC5883LConfig
 {
     // path to i2c device
     std::string devPath;
-    // polling timeout in milliseconds
-    int pollTimeout;
-    // calibration polling timeout in milliseconds
-    int calibrationPollTimeout;
+    // delay before retrying a failed bus read, milliseconds
+    int pollTimeout = 100;
+    // samples per second: 10, 50, 100 or 200, the chip is polled at this rate
+    int outputDataRate = 10;
+    // full scale, gauss: 2 or 8
+    int fieldRange = 2;
+    // over sample ratio: 512, 256, 128 or 64
+    int oversampling = 512;
+    // smoothing of published values: "none", "average", "median" or "exponential"
+    std::string filter = "none";
+    // samples the average and median are taken over
+    int filterWindow = 5;
+    // weight of a new sample for the exponential filter, 0..1
+    double filterAlpha = 0.2;
+    // degrees clockwise from the bow to the sensor X axis
+    double mountingRotation = 0.0;
+    // sensor is mounted upside down
+    bool mountingFlipped = false;
+    // magnetic declination, degrees, east positive
+    double declination = 0.0;
+    // hard and soft iron correction, loaded at startup and saved when calibration completes
+    std::string calibrationFile;
+    // calibration stops by itself once this fraction of headings is covered and the residual is low enough
+    double calibrationMinCoverage = 1.0;
+    double calibrationMaxResidual = 0.02;
 };
 
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2024 - 2025 Mikhail Sapozhnikov
+ * Copyright (C) 2024 - 2026 Mikhail Sapozhnikov
  *
  * This file is part of ship-position.
  *
@@ -19,32 +19,84 @@
  */
 
 #include "QMC5883LReader.hpp"
+#include "Clock.hpp"
+#include "MethodWrapper.hpp"
 
-extern "C"
-{
-    #include <linux/i2c-dev.h>
-    #include <i2c/smbus.h>
-}
-
-#include <fcntl.h>
-#include <sys/ioctl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
 #include <unistd.h>
+#include <algorithm>
 
 namespace ship_position
 {
 
-QMC5883LReader::QMC5883LReader(const QMC5883LConfig &config) :
+namespace
+{
+
+// supported value of a configuration parameter and its bits in control register 1
+struct ControlSetting
+{
+    int value;
+    uint8_t bits;
+};
+
+constexpr uint8_t MODE_CONTINUOUS = 0x01;
+constexpr ControlSetting ODR_SETTINGS[] = {{10, 0x00}, {50, 0x04}, {100, 0x08}, {200, 0x0c}};
+constexpr ControlSetting RANGE_SETTINGS[] = {{2, 0x00}, {8, 0x10}};
+constexpr ControlSetting OSR_SETTINGS[] = {{512, 0x00}, {256, 0x40}, {128, 0x80}, {64, 0xc0}};
+
+template <size_t N>
+bool findSetting(const ControlSetting (&settings)[N], int value, uint8_t &bits)
+{
+    for (const ControlSetting &setting : settings)
+    {
+        if (setting.value == value)
+        {
+            bits |= setting.bits;
+            return true;
+        }
+    }
+    return false;
+}
+
+}
+
+QMC5883LReader::QMC5883LReader(const QMC5883LConfig &config, I2CBus &bus) :
 _config(config),
-_fd(-1),
-_calibrating(false)
+_bus(bus),
+_initialized(false),
+_eventfd(-1),
+_outputDataRate(10),
+_filter(MagnetometerFilterType::NONE, 1, 1.0),
+_headingCalculator(config.mountingRotation, config.mountingFlipped, config.declination),
+_calibrating(false),
+_calibrationGeneration(0),
+_collector(config.calibrationMinCoverage, config.calibrationMaxResidual),
+_calibrationTask(methodWrapper<QMC5883LReader, void>(this, &QMC5883LReader::updateCalibration))
 {
     _log = Log::getInstance();
-    _calibration.xmin = 0;
-    _calibration.xmax = 0;
-    _calibration.ymin = 0;
-    _calibration.ymax = 0;
-    _calibration.zmax = 0;
-    _calibration.zmin = 0;
+
+    MagnetometerFilterType filterType;
+    if (!MagnetometerFilter::parseType(_config.filter, filterType))
+    {
+        _log->write(LogLevel::ERROR, "qmc5883l: unknown filter %s, samples are not filtered\n", _config.filter.c_str());
+        filterType = MagnetometerFilterType::NONE;
+    }
+    _filter = MagnetometerFilter(filterType, _config.filterWindow, _config.filterAlpha);
+    _eventfd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+    // the last calibration is applied from the first sample on
+    MagnetometerCalibration calibration;
+    if (!_config.calibrationFile.empty() && loadCalibration(_config.calibrationFile, calibration))
+    {
+        _calibration.store(calibration);
+        _log->write(LogLevel::NOTICE, "qmc5883l calibration loaded from %s\n", _config.calibrationFile.c_str());
+    }
+    else
+    {
+        _log->write(LogLevel::NOTICE, "qmc5883l: no calibration in %s, values are not corrected\n",
+            _config.calibrationFile.c_str());
+    }
 
     init();
 }
@@ -52,10 +104,10 @@ _calibrating(false)
 QMC5883LReader::~QMC5883LReader()
 {
     Log::release();
-    
-    if (_fd != -1)
+
+    if (_eventfd != -1)
     {
-        close(_fd);
+        close(_eventfd);
     }
 }
 
@@ -63,177 +115,413 @@ void QMC5883LReader::init()
 {
     _log->write(LogLevel::DEBUG, "QMC5883LReader::init(), device: %s\n", _config.devPath.c_str());
 
-    _fd = open(_config.devPath.c_str(), O_RDWR);
-    if (_fd == -1)
+    // define set/reset period
+    if (!_bus.writeRegister(REG_SET_RESET_PERIOD, 0x01))
     {
-        _log->write(LogLevel::ERROR, "error opening qmc5883l device %s, error = %d\n",
-            _config.devPath.c_str(), errno);
+        _log->write(LogLevel::ERROR, "failed to set qmc5883l register 0x0B to 0x01, error = %d\n", errno);
         return;
     }
 
-    if (ioctl(_fd, I2C_SLAVE, QMC5883L_I2C_ADDR) == -1)
+    // pointer roll-over, so that a block read starting at the status register continues with the data
+    if (!_bus.writeRegister(REG_CONTROL_2, CONTROL_2_ROL_PNT))
     {
-        _log->write(LogLevel::ERROR, "error specifying i2c address to communicate with, error = %d\n",
-            errno);
+        _log->write(LogLevel::ERROR, "failed to set qmc5883l register 0x0A to 0x40, error = %d\n", errno);
         return;
     }
 
-    // define set/reset period
-    if (i2c_smbus_write_byte_data(_fd, 0x0D, 0x01) == -1)
+    // set control register: continuous mode with configured ODR, field range and OSR
+    uint8_t control = 0;
+    if (controlRegister1(_config, control))
     {
-        _log->write(LogLevel::ERROR, "failed to set qmc5883l register 0x0B to 0x01, error = %d\n", errno);
-        return;
+        _outputDataRate = _config.outputDataRate;
     }
-
-    // set control register: continuous mode, 10 Hz ODR, 2G field range, 512 OSR
-    if (i2c_smbus_write_byte_data(_fd, 0x09, 0x01) == -1)
+    else
+    {
+        _log->write(LogLevel::ERROR, "qmc5883l: unsupported odr %d, range %d or osr %d, using 10 Hz, 2G, 512\n",
+            _config.outputDataRate, _config.fieldRange, _config.oversampling);
+        control = MODE_CONTINUOUS;
+    }
+    if (!_bus.writeRegister(REG_CONTROL_1, control))
     {
-        _log->write(LogLevel::ERROR, "failed to set qmc5883l register 0x09 to 0x01, error = %d\n", errno);
+        _log->write(LogLevel::ERROR, "failed to set qmc5883l register 0x09 to 0x%02x, error = %d\n", control, errno);
         return;
     }
+
+    _initialized = true;
 }
 
 void QMC5883LReader::run()
 {
     _log->write(LogLevel::DEBUG, "QMC5883LReader::run()\n");
 
-    if (_fd == -1)
+    if (!_initialized)
     {
         _log->write(LogLevel::ERROR, "qmc5883l device not initialized, run() quitting\n");
         return;
     }
 
-    while (true)
+    // absolute deadlines one ODR period apart, counted from the poll which found a new sample
+    uint64_t period = 1000000000ULL / _outputDataRate;
+    uint64_t deadline = monotonicNs() + period;
+    MagnetometerStatistics statistics;
+    bool wasCalibrating = false;
+    MagnetometerCalibration calibration;
+    _calibration.load(calibration);
+    uint64_t calibrationUpdates = _calibration.updates();
+    // offer every n-th sample to the collector while calibrating
+    int calibrationDecimation = std::max(1, _outputDataRate / CALIBRATION_SAMPLE_RATE);
+    int calibrationSkipped = 0;
+    uint64_t calibrationGeneration = 0;
+    uint64_t calibrationHandoverNs = 0;
+    bool calibrationCollected = false;
+    double temperature = 0.0;
+    uint64_t temperatureNs = 0;
+    // the first sample reads the thermometer
+    int temperatureSamples = _outputDataRate - 1;
+
+    while (!waitForStopUntil(deadline))
     {
         bool calibrating = _calibrating;
 
-        // read status register to check whether data is ready
-        __s32 res = i2c_smbus_read_byte_data(_fd, 0x06);
-        if (res == -1)
+        // status and all three axes in one transaction, the pointer rolls over from status to 0x00
+        uint8_t block[BLOCK_SIZE];
+        int res = _bus.readRegisters(REG_STATUS, BLOCK_SIZE, block);
+        uint64_t arrivalNs = monotonicNs();
+        if (res != BLOCK_SIZE)
         {
-            _log->write(LogLevel::ERROR, "failed to read qmc5883l status register 0x06, error = %d\n", errno);
-            std::this_thread::sleep_for(std::chrono::milliseconds(_config.pollTimeout));
+            _log->write(LogLevel::ERROR, "failed to read qmc5883l registers, result = %d, error = %d\n", res, errno);
+            statistics.readErrors++;
+            _statistics.store(statistics);
+            deadline = arrivalNs + _config.pollTimeout * 1000000ULL;
             continue;
         }
 
-        if ((res & 0x01) || (res & 0x04))
+        uint8_t status = block[0];
+        if (!(status & (STATUS_DRDY | STATUS_DOR)))
         {
-            if (res & 0x04)
-            {
-                _log->write(LogLevel::DEBUG, "qmc5883l overflow detected\n");
-            }
+            statistics.duplicates++;
+            _statistics.store(statistics);
+            deadline = arrivalNs + period / RETRY_DIVISOR;
+            continue;
+        }
 
-            int32_t x = 0;
-            int32_t y = 0;
-            int32_t z = 0;
+        deadline += period - period / DRIFT_DIVISOR;
+        if (deadline <= arrivalNs)
+        {
+            deadline = arrivalNs + period;
+        }
 
-            if (readWord2C(0x00, 0x01, x) == -1)
+        if (status & STATUS_DOR)
+        {
+            // at least one measurement was overwritten before it was read
+            statistics.dropped++;
+        }
+        if (status & STATUS_OVL)
+        {
+            _log->write(LogLevel::DEBUG, "qmc5883l overflow detected\n");
+        }
+
+        int32_t x = 0;
+        int32_t y = 0;
+        int32_t z = 0;
+        decodeSample(block + 1, x, y, z);
+
+        // the thermometer is out of the burst's reach, read it once a second
+        bool compensationChanged = false;
+        if (++temperatureSamples >= _outputDataRate)
+        {
+            temperatureSamples = 0;
+            uint8_t raw[TEMPERATURE_SIZE];
+            res = _bus.readRegisters(REG_TEMPERATURE, TEMPERATURE_SIZE, raw);
+            if (res == TEMPERATURE_SIZE)
             {
-                _log->write(LogLevel::ERROR, "failed to read qmc5883l x axis\n");
+                temperature = decodeTemperature(raw);
+                temperatureNs = arrivalNs;
+                compensationChanged = true;
             }
-            if (readWord2C(0x02, 0x03, y) == -1)
+            else
             {
-                _log->write(LogLevel::ERROR, "failed to read qmc5883l y axis\n");
+                // the previous temperature is used until the next attempt
+                _log->write(LogLevel::ERROR, "failed to read qmc5883l temperature, result = %d, error = %d\n",
+                    res, errno);
+                statistics.readErrors++;
             }
-            if (readWord2C(0x04, 0x05, z) == -1)
+        }
+
+        if (calibrating)
+        {
+            uint64_t generation = _calibrationGeneration;
+            if (generation != calibrationGeneration)
             {
-                _log->write(LogLevel::ERROR, "failed to read qmc5883l z axis\n");
+                _collector.reset();
+                calibrationGeneration = generation;
+                calibrationHandoverNs = 0;
             }
-
-            if (calibrating)
+            if (++calibrationSkipped >= calibrationDecimation)
             {
-                if ((x < _calibration.xmin) || (_calibration.xmin == 0))
-                {
-                    _calibration.xmin = x;
-                }
-                else if ((x > _calibration.xmax) || (_calibration.xmax == 0))
-                {
-                    _calibration.xmax = x;
-                }
-                if ((y < _calibration.ymin) || (_calibration.xmin == 0))
-                {
-                    _calibration.ymin = y;
-                }
-                else if ((y > _calibration.ymax) || (_calibration.ymax == 0))
-                {
-                    _calibration.ymax = y;
-                }
-                if ((z < _calibration.zmin) || (_calibration.zmin == 0))
-                {
-                    _calibration.zmin = z;
-                }
-                else if ((z > _calibration.zmax) || (_calibration.zmax == 0))
-                {
-                    _calibration.zmax = z;
-                }
+                calibrationSkipped = 0;
+                calibrationCollected = _collector.add(x, y, z, temperature) || calibrationCollected;
             }
-            else 
+            // fitting would stall sampling, collecting goes on meanwhile
+            if (calibrationCollected && (arrivalNs - calibrationHandoverNs >= CALIBRATION_FIT_PERIOD_NS))
             {
-                std::unique_lock<std::shared_mutex> lock(_magnetometerDataMutex);
-                _magnetometerData.x = x - ((_calibration.xmin + _calibration.xmax) / 2);
-                _magnetometerData.y = y - ((_calibration.ymin + _calibration.ymax) / 2);
-                _magnetometerData.z = z - ((_calibration.zmin + _calibration.zmax) / 2);
+                CalibrationSamples samples;
+                samples.snapshot = _collector.snapshot();
+                samples.snapshot.generation = generation;
+                samples.snapshot.status.arrivalNs = arrivalNs;
+                samples.fit = _collector.fit();
+                _calibrationSamples.store(samples);
+                _calibrationTask.trigger();
+                calibrationHandoverNs = arrivalNs;
+                calibrationCollected = false;
             }
         }
         else
         {
-            _log->write(LogLevel::DEBUG, "qmc5883l status register = 0x%02x, skipping measurement\n", res);
-        }
+            uint64_t updates = _calibration.updates();
+            if (updates != calibrationUpdates)
+            {
+                _calibration.load(calibration);
+                calibrationUpdates = updates;
+                _filter.reset();
+                compensationChanged = true;
+            }
 
-        if (calibrating)
-        {
-            std::this_thread::sleep_for(std::chrono::milliseconds(_config.calibrationPollTimeout));
+            MagnetometerData data;
+            calibration.apply(x, y, z, temperature, data);
+            data.arrivalNs = arrivalNs;
+            data.temperature = temperature;
+            if (wasCalibrating)
+            {
+                // the correction changed, older samples don't belong with the new ones
+                _filter.reset();
+            }
+            MagnetometerData filtered = _filter.update(data);
+            data.publishNs = monotonicNs();
+            filtered.publishNs = data.publishNs;
+            _samples.push(data);
+            _magnetometerData.store(filtered);
+            _heading.store(_headingCalculator.compute(filtered));
         }
-        else
+
+        if (compensationChanged)
         {
-            std::this_thread::sleep_for(std::chrono::milliseconds(_config.pollTimeout));
+            TemperatureCompensation compensation = calibration.compensation(temperature);
+            compensation.arrivalNs = temperatureNs;
+            _compensation.store(compensation);
         }
+
+        wasCalibrating = calibrating;
+        statistics.samples++;
+        statistics.lastArrivalNs = arrivalNs;
+        _statistics.store(statistics);
     }
+
+    _log->write(LogLevel::DEBUG, "QMC5883LReader::run() stopping\n");
+}
+
+void QMC5883LReader::start()
+{
+    _calibrationTask.start();
+    SingleThread::start();
 }
 
-int QMC5883LReader::readWord2C(uint8_t lowReg, uint8_t highReg, int32_t &res)
+void QMC5883LReader::stop()
 {
-    __s32 low = i2c_smbus_read_byte_data(_fd, lowReg);
-    if (low == -1)
+    if (_eventfd != -1)
     {
-        _log->write(LogLevel::ERROR, "failed to read qmc5883l register 0x%02x, error = %d\n", lowReg, errno);
-        return -1;
+        uint64_t value = 1;
+        if (write(_eventfd, &value, sizeof(value)) == -1)
+        {
+            _log->write(LogLevel::ERROR, "QMC5883LReader failed to signal eventfd, error=%d\n", errno);
+        }
     }
 
-    __s32 high = i2c_smbus_read_byte_data(_fd, highReg);
-    if (high == -1)
+    SingleThread::stop();
+
+    // drain the eventfd, so that the reader can be started again
+    if (_eventfd != -1)
     {
-        _log->write(LogLevel::ERROR, "failed to read qmc5883l register 0x%02x, error = %d\n", highReg, errno);
-        return -1;
+        uint64_t value;
+        if ((read(_eventfd, &value, sizeof(value)) == -1) && (errno != EAGAIN))
+        {
+            _log->write(LogLevel::ERROR, "QMC5883LReader failed to drain eventfd, error=%d\n", errno);
+        }
     }
 
-    res = (high << 8) + low;
-    if (res >= 0x08000)
+    // after the reader thread, which triggers it
+    _calibrationTask.stop();
+}
+
+bool QMC5883LReader::waitForStopUntil(uint64_t deadlineNs)
+{
+    uint64_t now = monotonicNs();
+    struct timespec timeout = {0, 0};
+    if (deadlineNs > now)
     {
-        res -= 0x10000;
+        timeout.tv_sec = (deadlineNs - now) / 1000000000ULL;
+        timeout.tv_nsec = (deadlineNs - now) % 1000000000ULL;
     }
 
-    return 0;
+    struct pollfd pfd;
+    pfd.fd = _eventfd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    return (ppoll(&pfd, 1, &timeout, nullptr) > 0) && (pfd.revents & POLLIN);
+}
+
+bool QMC5883LReader::controlRegister1(const QMC5883LConfig &config, uint8_t &value)
+{
+    value = MODE_CONTINUOUS;
+    bool supported = findSetting(ODR_SETTINGS, config.outputDataRate, value);
+    supported = findSetting(RANGE_SETTINGS, config.fieldRange, value) && supported;
+    supported = findSetting(OSR_SETTINGS, config.oversampling, value) && supported;
+    return supported;
+}
+
+double QMC5883LReader::decodeTemperature(const uint8_t *data)
+{
+    return static_cast<int16_t>(data[0] | (data[1] << 8)) / static_cast<double>(TEMPERATURE_LSB_PER_DEGREE);
+}
+
+void QMC5883LReader::decodeSample(const uint8_t *data, int32_t &x, int32_t &y, int32_t &z)
+{
+    // little endian two's complement words
+    x = static_cast<int16_t>(data[0] | (data[1] << 8));
+    y = static_cast<int16_t>(data[2] | (data[3] << 8));
+    z = static_cast<int16_t>(data[4] | (data[5] << 8));
 }
 
 void QMC5883LReader::getMagnetometerData(MagnetometerData &data)
 {
-    std::shared_lock<std::shared_mutex> lock(_magnetometerDataMutex);
-    data = _magnetometerData;
+    _magnetometerData.load(data);
+}
+
+void QMC5883LReader::getMagnetometerSamples(size_t count, std::vector<MagnetometerData> &samples)
+{
+    samples.resize(std::min(count, SAMPLE_RING_CAPACITY));
+    samples.resize(_samples.read(samples.data(), samples.size()));
+}
+
+void QMC5883LReader::getHeading(HeadingData &heading)
+{
+    _heading.load(heading);
+}
+
+void QMC5883LReader::getMagnetometerStatistics(MagnetometerStatistics &statistics)
+{
+    _statistics.load(statistics);
+}
+
+void QMC5883LReader::getCalibrationStatus(CalibrationStatus &status)
+{
+    CalibrationSnapshot snapshot;
+    _calibrationSnapshot.load(snapshot);
+    if (snapshot.generation == _calibrationGeneration)
+    {
+        status = snapshot.status;
+    }
+    else
+    {
+        // started, but no sample collected yet
+        status = CalibrationStatus();
+    }
+    status.calibrating = _calibrating;
+}
+
+void QMC5883LReader::getTemperatureCompensation(TemperatureCompensation &compensation)
+{
+    _compensation.load(compensation);
 }
 
 void QMC5883LReader::startCalibration()
 {
+    std::lock_guard<std::mutex> lock(_calibrationMutex);
+    _calibrationGeneration++;
     _calibrating = true;
     _log->write(LogLevel::DEBUG, "qmc5883L calibration started\n");
 }
 
-void QMC5883LReader::stopCalibration()
+bool QMC5883LReader::stopCalibration()
+{
+    std::lock_guard<std::mutex> lock(_calibrationMutex);
+    if (!_calibrating)
+    {
+        return false;
+    }
+
+    // the samples of the last handover are fitted
+    CalibrationSamples samples;
+    _calibrationSamples.load(samples);
+    CalibrationSnapshot snapshot;
+    if (samples.snapshot.generation == _calibrationGeneration)
+    {
+        snapshot = samples.snapshot;
+        _collector.solve(samples.fit, snapshot);
+    }
+    return finishCalibration(snapshot);
+}
+
+void QMC5883LReader::updateCalibration()
+{
+    CalibrationSamples samples;
+    _calibrationSamples.load(samples);
+    CalibrationSnapshot snapshot = samples.snapshot;
+    _collector.solve(samples.fit, snapshot);
+
+    std::lock_guard<std::mutex> lock(_calibrationMutex);
+    // a client stopping or restarting calibration meanwhile takes precedence
+    if (!_calibrating || (snapshot.generation != _calibrationGeneration))
+    {
+        return;
+    }
+    _calibrationSnapshot.store(snapshot);
+    if (snapshot.status.complete)
+    {
+        finishCalibration(snapshot);
+    }
+}
+
+bool QMC5883LReader::finishCalibration(const CalibrationSnapshot &snapshot)
 {
     _calibrating = false;
+
+    MagnetometerCalibration calibration = snapshot.calibration;
+    if (!snapshot.fitValid)
+    {
+        _log->write(LogLevel::ERROR, "qmc5883l calibration failed, %llu samples don't fit an ellipsoid, "
+            "keeping the previous calibration\n", static_cast<unsigned long long>(snapshot.status.samples));
+        return false;
+    }
+    if (!snapshot.temperatureFitted && (_calibration.updates() > 0))
+    {
+        MagnetometerCalibration previous;
+        _calibration.load(previous);
+        inheritTemperatureDrift(previous, calibration);
+    }
+    _calibration.store(calibration);
+
     _log->write(LogLevel::DEBUG, "qmc5883L calibration stopped\n");
-    _log->write(LogLevel::DEBUG, "qmc5883l calibration data: xmax=%d, xmin=%d, ymax=%d, ymin=%d, zmax=%d, zmin=%d\n",
-        _calibration.xmax, _calibration.xmin, _calibration.ymax, _calibration.ymin, _calibration.zmax, _calibration.zmin);
+    _log->write(LogLevel::DEBUG, "qmc5883l %s calibration data from %llu samples, coverage %.2f, residual %.4f: "
+        "offset=(%.1f, %.1f, %.1f), matrix=((%.4f, %.4f, %.4f), (%.4f, %.4f, %.4f), (%.4f, %.4f, %.4f))\n",
+        snapshot.horizontalFit ? "horizontal" : "3D", static_cast<unsigned long long>(snapshot.status.samples),
+        snapshot.status.coverage, snapshot.status.residual,
+        calibration.offset[0], calibration.offset[1], calibration.offset[2],
+        calibration.matrix[0][0], calibration.matrix[0][1], calibration.matrix[0][2],
+        calibration.matrix[1][0], calibration.matrix[1][1], calibration.matrix[1][2],
+        calibration.matrix[2][0], calibration.matrix[2][1], calibration.matrix[2][2]);
+    _log->write(LogLevel::DEBUG, "qmc5883l thermal drift %s: (%.2f, %.2f, %.2f) per degree from %.2f\n",
+        snapshot.temperatureFitted ? "fitted" : "inherited", calibration.temperatureCoefficients[0],
+        calibration.temperatureCoefficients[1], calibration.temperatureCoefficients[2],
+        calibration.referenceTemperature);
+
+    if (!_config.calibrationFile.empty() && !saveCalibration(_config.calibrationFile, calibration))
+    {
+        _log->write(LogLevel::ERROR, "failed to save qmc5883l calibration to %s, error = %d\n",
+            _config.calibrationFile.c_str(), errno);
+    }
+    return true;
 }
 
-}
\ No newline at end of file
+}
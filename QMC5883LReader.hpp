@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2024 - 2025 Mikhail Sapozhnikov
+ * Copyright (C) 2024 - 2026 Mikhail Sapozhnikov
  *
  * This file is part of ship-position.
  *
@@ -25,45 +25,121 @@
 #include "Log.hpp"
 #include "QMC5883LConfig.hpp"
 #include "MagnetometerReader.hpp"
+#include "CalibrationCollector.hpp"
+#include "Heading.hpp"
+#include "BackgroundTask.hpp"
+#include "I2CBus.hpp"
+#include "MagnetometerCalibration.hpp"
+#include "MagnetometerFilter.hpp"
+#include "SampleRing.hpp"
+#include "Seqlock.hpp"
 
+#include <atomic>
 #include <cstdint>
-#include <shared_mutex>
+#include <mutex>
 
 #define QMC5883L_I2C_ADDR 0x0D
 
 namespace ship_position
 {
 
-struct QMC5883LCalibration
-{
-    int32_t xmin;
-    int32_t xmax;
-    int32_t ymin;
-    int32_t ymax;
-    int32_t zmax;
-    int32_t zmin;
-};
-
 class QMC5883LReader : public SingleThread, public MagnetometerReader
 {
 public:
-    QMC5883LReader(const QMC5883LConfig &config);
+    // the bus has to outlive the reader
+    QMC5883LReader(const QMC5883LConfig &config, I2CBus &bus);
     virtual ~QMC5883LReader();
     virtual void run();
+    virtual void start();
+    virtual void stop();
     virtual void getMagnetometerData(MagnetometerData &data);
+    virtual void getMagnetometerSamples(size_t count, std::vector<MagnetometerData> &samples);
+    virtual void getMagnetometerStatistics(MagnetometerStatistics &statistics);
+    virtual void getHeading(HeadingData &heading);
+    virtual void getCalibrationStatus(CalibrationStatus &status);
+    virtual void getTemperatureCompensation(TemperatureCompensation &compensation);
     virtual void startCalibration();
-    virtual void stopCalibration();
+    virtual bool stopCalibration();
+
+    // X, Y and Z from the six data registers as read from the chip
+    static void decodeSample(const uint8_t *data, int32_t &x, int32_t &y, int32_t &z);
+    // degrees C from the two temperature registers
+    static double decodeTemperature(const uint8_t *data);
+    // control register 1 value, returns false if ODR, range or OSR is not supported
+    static bool controlRegister1(const QMC5883LConfig &config, uint8_t &value);
+
+    static constexpr uint8_t REG_STATUS = 0x06;
+    static constexpr uint8_t REG_TEMPERATURE = 0x07;
+    static constexpr uint8_t REG_CONTROL_1 = 0x09;
+    static constexpr uint8_t REG_CONTROL_2 = 0x0A;
+    static constexpr uint8_t REG_SET_RESET_PERIOD = 0x0B;
+    // status register bits: data ready, field overflow, data skipped
+    static constexpr uint8_t STATUS_DRDY = 0x01;
+    static constexpr uint8_t STATUS_OVL = 0x02;
+    static constexpr uint8_t STATUS_DOR = 0x04;
+    // register pointer rolls over from 0x06 to 0x00
+    static constexpr uint8_t CONTROL_2_ROL_PNT = 0x40;
+    // status followed by the six data registers
+    static constexpr uint8_t BLOCK_SIZE = 7;
+    static constexpr uint8_t TEMPERATURE_SIZE = 2;
+    static constexpr int TEMPERATURE_LSB_PER_DEGREE = 100;
+    // when a poll finds no new data, it is repeated after this fraction of the ODR period
+    static constexpr int RETRY_DIVISOR = 8;
+    // the schedule moves earlier by this fraction of the ODR period every sample
+    static constexpr int DRIFT_DIVISOR = 32;
+    // unfiltered history, a bit more than 5 s at 200 Hz
+    static constexpr size_t SAMPLE_RING_CAPACITY = 1024;
+    // raw samples offered to the calibration collector per second at most
+    static constexpr int CALIBRATION_SAMPLE_RATE = 20;
+    // collected samples are handed over to be fitted at most this often
+    static constexpr uint64_t CALIBRATION_FIT_PERIOD_NS = 1000000000ULL;
 protected:
     void init();
-    int32_t readWord2C(uint8_t lowReg, uint8_t highReg, int32_t &res);
+    // returns true if stop was requested before the CLOCK_MONOTONIC deadline
+    bool waitForStopUntil(uint64_t deadlineNs);
+    // applies and saves the fitted calibration, _calibrationMutex has to be held
+    bool finishCalibration(const CalibrationSnapshot &snapshot);
+    // runs on _calibrationTask: fits the samples handed over and finishes calibration once it is complete
+    void updateCalibration();
 
     const QMC5883LConfig &_config;
-    int _fd;
+    I2CBus &_bus;
+    // the chip was configured, run() does nothing otherwise
+    bool _initialized;
+    // used to wake up the reader thread on stop()
+    int _eventfd;
+    // samples per second the chip was configured for
+    int _outputDataRate;
     Log *_log;
-    MagnetometerData _magnetometerData;
-    std::shared_mutex _magnetometerDataMutex;
-    bool _calibrating;
-    QMC5883LCalibration _calibration;
+    // published once per measurement, read without locking
+    Seqlock<MagnetometerData> _magnetometerData;
+    SampleRing<MagnetometerData, SAMPLE_RING_CAPACITY> _samples;
+    // used by the reader thread only
+    MagnetometerFilter _filter;
+    HeadingCalculator _headingCalculator;
+    Seqlock<HeadingData> _heading;
+    Seqlock<MagnetometerStatistics> _statistics;
+    std::atomic<bool> _calibrating;
+    // incremented by every start, so that the reader thread notices a restart it didn't see
+    std::atomic<uint64_t> _calibrationGeneration;
+    // samples are added by the reader thread only, solve() is used by the others
+    CalibrationCollector _collector;
+    // sums of the collector as of the last handover
+    struct CalibrationSamples
+    {
+        CalibrationSnapshot snapshot;
+        EllipsoidFit fit;
+    };
+    Seqlock<CalibrationSamples> _calibrationSamples;
+    // written by _calibrationTask
+    Seqlock<CalibrationSnapshot> _calibrationSnapshot;
+    // written by the thread which finishes calibration, applied by the reader thread
+    Seqlock<MagnetometerCalibration> _calibration;
+    Seqlock<TemperatureCompensation> _compensation;
+    // serializes finishing calibration by a client and by _calibrationTask
+    std::mutex _calibrationMutex;
+    // fits and finishes calibration off the reader thread, declared last to be destroyed first
+    BackgroundTask _calibrationTask;
 };
 
 }
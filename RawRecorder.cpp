@@ -0,0 +1,287 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RawRecorder.hpp"
+#include "Clock.hpp"
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <unistd.h>
+#include <charconv>
+#include <chrono>
+#include <ctime>
+#include <cstdio>
+#include <filesystem>
+
+namespace ship_position
+{
+
+RawRecorder::RawRecorder(const std::string &path, size_t bufferSize, uint64_t maxSegmentSize, uint32_t maxSegments,
+    bool timestamps) :
+    _path(path),
+    _bufferSize(bufferSize),
+    _maxSegmentSize(maxSegmentSize),
+    _maxSegments(maxSegments),
+    _timestamps(timestamps),
+    _fd(-1),
+    _segment(0),
+    _segmentSize(0),
+    _writtenBytes(0),
+    _droppedBytes(0),
+    _stopRequested(false)
+{
+    _log = Log::getInstance();
+    _log->write(LogLevel::DEBUG, "RawRecorder ctor, path=%s\n", path.c_str());
+
+    _storage = new char[NUM_BUFFERS * bufferSize];
+    for (size_t i = 0; i < NUM_BUFFERS; i++)
+    {
+        _buffers[i].data = _storage + i * bufferSize;
+        _buffers[i].length = 0;
+        _buffers[i].timestamp = 0;
+        _free.push(&_buffers[i]);
+    }
+
+    // continue numbering after segments left by previous runs
+    std::error_code error;
+    std::filesystem::path filePath(path);
+    std::string prefix = filePath.filename().string() + ".";
+    std::filesystem::path dir = filePath.parent_path().empty() ? "." : filePath.parent_path();
+    for (const auto &entry : std::filesystem::directory_iterator(dir, error))
+    {
+        std::string name = entry.path().filename().string();
+        if (name.compare(0, prefix.length(), prefix) != 0)
+        {
+            continue;
+        }
+        uint64_t segment = 0;
+        const char *begin = name.data() + prefix.length();
+        const char *end = name.data() + name.length();
+        auto [ptr, ec] = std::from_chars(begin, end, segment);
+        if ((ec == std::errc()) && (ptr == end) && (segment > _segment))
+        {
+            _segment = segment;
+        }
+    }
+
+    openSegment();
+    removeOldSegments();
+}
+
+RawRecorder::~RawRecorder()
+{
+    if (_fd != -1)
+    {
+        close(_fd);
+    }
+    delete[] _storage;
+    Log::release();
+}
+
+void RawRecorder::run()
+{
+    _log->write(LogLevel::DEBUG, "RawRecorder::run()\n");
+
+    while (true)
+    {
+        bool stopping;
+        {
+            std::unique_lock<std::mutex> lock(_stopMutex);
+            _stopCondition.wait_for(lock, std::chrono::milliseconds(FLUSH_INTERVAL_MS),
+                [this]() { return _stopRequested; });
+            stopping = _stopRequested;
+        }
+
+        while (flush())
+        {
+        }
+
+        if (stopping)
+        {
+            _log->write(LogLevel::DEBUG, "RawRecorder::run() stopping\n");
+            break;
+        }
+    }
+}
+
+void RawRecorder::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(_stopMutex);
+        _stopRequested = true;
+    }
+    _stopCondition.notify_one();
+
+    SingleThread::stop();
+    _stopRequested = false;
+}
+
+RawRecorder::Buffer *RawRecorder::acquire()
+{
+    Buffer *buffer = nullptr;
+    _free.pop(buffer);
+    return buffer;
+}
+
+void RawRecorder::submit(Buffer *buffer, size_t length)
+{
+    buffer->length = length;
+    buffer->timestamp = monotonicNs();
+    // the queue holds all the buffers, so it can't be full
+    _filled.push(buffer);
+}
+
+std::string RawRecorder::segmentPath(uint64_t segment) const
+{
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), ".%06llu", static_cast<unsigned long long>(segment));
+    return _path + suffix;
+}
+
+bool RawRecorder::flush()
+{
+    Buffer *batch[NUM_BUFFERS];
+    RecordHeader headers[NUM_BUFFERS];
+    struct iovec iov[2 * NUM_BUFFERS];
+    size_t count = 0;
+    size_t numIov = 0;
+    size_t total = 0;
+    while ((count < NUM_BUFFERS) && _filled.pop(batch[count]))
+    {
+        if (_timestamps)
+        {
+            headers[count].timestamp = batch[count]->timestamp;
+            headers[count].length = batch[count]->length;
+            headers[count].reserved = 0;
+            iov[numIov].iov_base = &headers[count];
+            iov[numIov].iov_len = sizeof(RecordHeader);
+            total += sizeof(RecordHeader);
+            numIov++;
+        }
+        iov[numIov].iov_base = batch[count]->data;
+        iov[numIov].iov_len = batch[count]->length;
+        total += batch[count]->length;
+        numIov++;
+        count++;
+    }
+
+    if (count == 0)
+    {
+        return false;
+    }
+
+    // batches aren't split between segments
+    size_t emptySize = _timestamps ? sizeof(TIMESTAMPED_MAGIC) : 0;
+    if ((_maxSegmentSize != 0) && (_segmentSize > emptySize) && (_segmentSize + total > _maxSegmentSize))
+    {
+        openSegment();
+        removeOldSegments();
+    }
+
+    struct iovec *next = iov;
+    int remaining = numIov;
+    while ((_fd != -1) && (remaining > 0))
+    {
+        ssize_t written = writev(_fd, next, remaining);
+        if (written == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            _log->write(LogLevel::ERROR, "RawRecorder failed to write to %s, error=%d\n",
+                segmentPath(_segment).c_str(), errno);
+            _droppedBytes += total;
+            break;
+        }
+
+        _segmentSize += written;
+        _writtenBytes += written;
+        total -= written;
+        // skip what was written, partial writes resume in the middle of a buffer
+        while ((remaining > 0) && (static_cast<size_t>(written) >= next->iov_len))
+        {
+            written -= next->iov_len;
+            next++;
+            remaining--;
+        }
+        if (remaining > 0)
+        {
+            next->iov_base = static_cast<char*>(next->iov_base) + written;
+            next->iov_len -= written;
+        }
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        _free.push(batch[i]);
+    }
+    return true;
+}
+
+bool RawRecorder::openSegment()
+{
+    if (_fd != -1)
+    {
+        close(_fd);
+    }
+
+    _segment++;
+    _segmentSize = 0;
+    std::string path = segmentPath(_segment);
+    _fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0664);
+    if (_fd == -1)
+    {
+        _log->write(LogLevel::ERROR, "failed to open raw output file %s, error=%d\n", path.c_str(), errno);
+        return false;
+    }
+    _log->write(LogLevel::DEBUG, "RawRecorder: recording to %s\n", path.c_str());
+
+    if (_timestamps)
+    {
+        if (write(_fd, TIMESTAMPED_MAGIC, sizeof(TIMESTAMPED_MAGIC)) != sizeof(TIMESTAMPED_MAGIC))
+        {
+            _log->write(LogLevel::ERROR, "RawRecorder failed to write to %s, error=%d\n", path.c_str(), errno);
+            return false;
+        }
+        _segmentSize = sizeof(TIMESTAMPED_MAGIC);
+    }
+    return true;
+}
+
+void RawRecorder::removeOldSegments()
+{
+    if ((_maxSegments == 0) || (_segment <= _maxSegments))
+    {
+        return;
+    }
+
+    // older segments are normally gone already, except after a restart with lower retention
+    for (uint64_t segment = _segment - _maxSegments; segment > 0; segment--)
+    {
+        if ((unlink(segmentPath(segment).c_str()) == -1) && (errno == ENOENT))
+        {
+            break;
+        }
+    }
+}
+
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef RAWRECORDER_HPP
+#define RAWRECORDER_HPP
+
+#include "SingleThread.hpp"
+#include "SPSCQueue.hpp"
+#include "Log.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace ship_position
+{
+
+// records raw receiver output on its own thread into numbered segments <path>.000001, <path>.000002, ...
+class RawRecorder : public SingleThread
+{
+public:
+    struct Buffer
+    {
+        char *data;
+        size_t length;
+        // CLOCK_MONOTONIC time of submit(), nanoseconds
+        uint64_t timestamp;
+    };
+
+    struct RecordHeader
+    {
+        uint64_t timestamp;
+        uint32_t length;
+        uint32_t reserved;
+    };
+
+    static constexpr char TIMESTAMPED_MAGIC[8] = {'S', 'P', 'R', 'A', 'W', 'T', 'S', '1'};
+
+    static constexpr size_t NUM_BUFFERS = 64;
+    // how often the writer wakes up to flush queued buffers
+    static constexpr int FLUSH_INTERVAL_MS = 200;
+
+    // maxSegmentSize 0 means a single segment without rotation, maxSegments 0 keeps all segments
+    RawRecorder(const std::string &path, size_t bufferSize, uint64_t maxSegmentSize, uint32_t maxSegments,
+        bool timestamps);
+    virtual ~RawRecorder();
+
+    virtual void run();
+    // flushes everything submitted before stopping
+    virtual void stop();
+
+    // reader side: returns an empty buffer of bufferSize bytes, or nullptr if all are queued
+    Buffer *acquire();
+    // reader side: queues length bytes of the buffer for writing
+    void submit(Buffer *buffer, size_t length);
+    // reader side: counts data which couldn't be recorded because no buffer was free
+    void drop(size_t length) { _droppedBytes += length; }
+
+    uint64_t writtenBytes() const { return _writtenBytes; }
+    uint64_t droppedBytes() const { return _droppedBytes; }
+    // path of the segment with the given number
+    std::string segmentPath(uint64_t segment) const;
+
+protected:
+    // writes out all queued buffers, returns false if nothing was queued
+    bool flush();
+    bool openSegment();
+    // deletes segments beyond the retention count
+    void removeOldSegments();
+
+    std::string _path;
+    size_t _bufferSize;
+    uint64_t _maxSegmentSize;
+    uint32_t _maxSegments;
+    bool _timestamps;
+    Log *_log;
+    int _fd;
+    uint64_t _segment;
+    uint64_t _segmentSize;
+    char *_storage;
+    Buffer _buffers[NUM_BUFFERS];
+    // buffers flow from reader to writer through _filled and back through _free
+    SPSCQueue<Buffer*, NUM_BUFFERS> _filled;
+    SPSCQueue<Buffer*, NUM_BUFFERS> _free;
+    std::atomic<uint64_t> _writtenBytes;
+    std::atomic<uint64_t> _droppedBytes;
+    std::mutex _stopMutex;
+    std::condition_variable _stopCondition;
+    bool _stopRequested;
+};
+
+}
+
+#endif // RAWRECORDER_HPP
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SPSCQUEUE_HPP
+#define SPSCQUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+
+namespace ship_position
+{
+
+// bounded lock-free single producer single consumer queue, capacity must be a power of two
+template <typename T, size_t Capacity>
+class SPSCQueue
+{
+public:
+    static_assert((Capacity != 0) && ((Capacity & (Capacity - 1)) == 0), "capacity must be a power of two");
+
+    SPSCQueue() : _head(0), _tail(0) {}
+
+    // producer side, returns false if the queue is full
+    bool push(const T &item)
+    {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _head.load(std::memory_order_acquire) == Capacity)
+        {
+            return false;
+        }
+        _items[tail & (Capacity - 1)] = item;
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer side, returns false if the queue is empty
+    bool pop(T &item)
+    {
+        size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        item = _items[head & (Capacity - 1)];
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // approximate when called concurrently with push() or pop()
+    size_t size() const
+    {
+        return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire);
+    }
+
+private:
+    // head and tail on separate cache lines
+    alignas(64) std::atomic<size_t> _head;
+    alignas(64) std::atomic<size_t> _tail;
+    alignas(64) T _items[Capacity];
+};
+
+}
+
+#endif // SPSCQUEUE_HPP
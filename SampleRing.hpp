@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SAMPLERING_HPP
+#define SAMPLERING_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace ship_position
+{
+
+// last Capacity values pushed by one writer thread, read without locking
+template <typename T, size_t Capacity>
+class SampleRing
+{
+public:
+    static_assert(std::is_trivially_copyable_v<T>, "samples are copied bytewise");
+    static_assert((Capacity != 0) && ((Capacity & (Capacity - 1)) == 0), "capacity must be a power of two");
+
+    SampleRing() : _begun(0), _done(0) {}
+
+    SampleRing(const SampleRing &other) = delete;
+
+    // writer side
+    void push(const T &value)
+    {
+        uint64_t words[NUM_WORDS] = {};
+        std::memcpy(words, &value, sizeof(T));
+
+        // readers drop what they copy from a slot being overwritten
+        uint64_t index = _begun.load(std::memory_order_relaxed);
+        _begun.store(index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::atomic<uint64_t> *slot = _slots[index & (Capacity - 1)];
+        for (size_t i = 0; i < NUM_WORDS; i++)
+        {
+            slot[i].store(words[i], std::memory_order_relaxed);
+        }
+        _done.store(index + 1, std::memory_order_release);
+    }
+
+    // reader side, copies up to count newest values, oldest first, and returns how many were copied
+    size_t read(T *values, size_t count) const
+    {
+        uint64_t done = _done.load(std::memory_order_acquire);
+        count = std::min<uint64_t>({count, done, Capacity});
+        uint64_t first = done - count;
+        for (uint64_t index = first; index < done; index++)
+        {
+            uint64_t words[NUM_WORDS];
+            const std::atomic<uint64_t> *slot = _slots[index & (Capacity - 1)];
+            for (size_t i = 0; i < NUM_WORDS; i++)
+            {
+                words[i] = slot[i].load(std::memory_order_relaxed);
+            }
+            std::memcpy(&values[index - first], words, sizeof(T));
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        // values the writer started to overwrite meanwhile are the oldest ones, drop them
+        uint64_t begun = _begun.load(std::memory_order_relaxed);
+        uint64_t valid = (begun >= Capacity) ? begun - Capacity : 0;
+        if (first >= valid)
+        {
+            return count;
+        }
+        uint64_t overwritten = std::min<uint64_t>(valid - first, count);
+        std::memmove(values, values + overwritten, (count - overwritten) * sizeof(T));
+        return count - overwritten;
+    }
+
+    // number of values pushed so far
+    uint64_t pushed() const
+    {
+        return _done.load(std::memory_order_acquire);
+    }
+
+private:
+    static constexpr size_t NUM_WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    alignas(64) std::atomic<uint64_t> _begun;
+    alignas(64) std::atomic<uint64_t> _done;
+    alignas(64) std::atomic<uint64_t> _slots[Capacity][NUM_WORDS];
+};
+
+}
+
+#endif // SAMPLERING_HPP
@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "SensorFusion.hpp"
+#include "Clock.hpp"
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace ship_position
+{
+
+SensorFusion::SensorFusion(const FusionConfig &config, GPSReader &gpsReader, MagnetometerReader &magnetometerReader) :
+_config(config),
+_gpsReader(gpsReader),
+_magnetometerReader(magnetometerReader),
+_eventfd(-1),
+_filter(config),
+_filterNs(0),
+_lastFixNs(0),
+_lastPositionNs(0),
+_lastHeadingNs(0),
+_deadReckoning(false)
+{
+    _log = Log::getInstance();
+    _eventfd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+}
+
+SensorFusion::~SensorFusion()
+{
+    Log::release();
+
+    if (_eventfd != -1)
+    {
+        close(_eventfd);
+    }
+}
+
+void SensorFusion::run()
+{
+    double rate = _config.publishRate;
+    if (rate <= 0.0)
+    {
+        _log->write(LogLevel::ERROR, "fusion: invalid publish rate %f, using 1 Hz\n", rate);
+        rate = 1.0;
+    }
+    uint64_t period = static_cast<uint64_t>(1e9 / rate);
+    uint64_t deadline = monotonicNs();
+
+    while (!need_to_stop())
+    {
+        if (waitForStopUntil(deadline))
+        {
+            break;
+        }
+
+        uint64_t now = monotonicNs();
+        cycle(now);
+
+        deadline += period;
+        if (deadline <= now)
+        {
+            deadline = now + period;
+        }
+    }
+}
+
+void SensorFusion::stop()
+{
+    if (_eventfd != -1)
+    {
+        uint64_t value = 1;
+        if (write(_eventfd, &value, sizeof(value)) == -1)
+        {
+            _log->write(LogLevel::ERROR, "SensorFusion failed to signal eventfd, error=%d\n", errno);
+        }
+    }
+
+    SingleThread::stop();
+
+    // drain the eventfd, so that the fusion can be started again
+    if (_eventfd != -1)
+    {
+        uint64_t value;
+        if ((read(_eventfd, &value, sizeof(value)) == -1) && (errno != EAGAIN))
+        {
+            _log->write(LogLevel::ERROR, "SensorFusion failed to drain eventfd, error=%d\n", errno);
+        }
+    }
+}
+
+void SensorFusion::getFusedState(FusedState &state)
+{
+    _state.load(state);
+}
+
+void SensorFusion::getFusionStatistics(FusionStatistics &statistics)
+{
+    _statistics.load(statistics);
+}
+
+void SensorFusion::cycle(uint64_t nowNs)
+{
+    FusionStatistics counters = _counters;
+
+    GPSInfo gpsInfo;
+    _gpsReader.getGPSInfo(gpsInfo);
+    // every sentence of an epoch republishes the fix, only a new valid position is stamped
+    bool newFix = (gpsInfo.positionArrivalNs != 0) && (gpsInfo.positionArrivalNs != _lastPositionNs);
+
+    HeadingData heading;
+    bool newHeading = false;
+    if (_config.useCompass)
+    {
+        _magnetometerReader.getHeading(heading);
+        newHeading = (heading.arrivalNs != 0) && (heading.arrivalNs != _lastHeadingNs);
+    }
+
+    // in the order they arrived, so that the filter only ever predicts forward
+    if (newHeading && (!newFix || (heading.arrivalNs < gpsInfo.positionArrivalNs)))
+    {
+        fuseHeading(heading);
+        newHeading = false;
+    }
+    if (newFix)
+    {
+        fuseFix(gpsInfo);
+    }
+    if (newHeading)
+    {
+        fuseHeading(heading);
+    }
+
+    FusedState state;
+    if (_filter.initialized())
+    {
+        uint64_t fixAgeNs = (nowNs > _lastFixNs) ? nowNs - _lastFixNs : 0;
+        if (fixAgeNs > _config.maxDeadReckoning * 1e9)
+        {
+            _log->write(LogLevel::NOTICE, "fusion: no GPS fix for %.1f s, position lost\n", fixAgeNs / 1e9);
+            _filter.reset();
+            _counters.resets++;
+            _deadReckoning = false;
+        }
+        else
+        {
+            bool deadReckoning = fixAgeNs > _config.gpsTimeout * 1e9;
+            if (deadReckoning != _deadReckoning)
+            {
+                _log->write(LogLevel::NOTICE, deadReckoning ? "fusion: GPS fix lost, dead reckoning\n" :
+                    "fusion: GPS fix regained\n");
+                _deadReckoning = deadReckoning;
+            }
+
+            // the filter itself stays at the last measurement, later ones may still arrive out of order
+            PositionFilter predicted = _filter;
+            if (nowNs > _filterNs)
+            {
+                predicted.predict((nowNs - _filterNs) / 1e9);
+            }
+            predicted.getState(state);
+            state.deadReckoning = deadReckoning;
+            state.fixArrivalNs = _lastFixNs;
+        }
+    }
+    state.arrivalNs = nowNs;
+    state.publishNs = monotonicNs();
+    _state.store(state);
+
+    if ((counters.fixes != _counters.fixes) || (counters.headings != _counters.headings) ||
+        (counters.rejectedFixes != _counters.rejectedFixes) || (counters.resets != _counters.resets))
+    {
+        _statistics.store(_counters);
+    }
+}
+
+void SensorFusion::fuseFix(const GPSInfo &gpsInfo)
+{
+    bool initialized = _filter.initialized();
+    advance(gpsInfo.positionArrivalNs);
+    if (_filter.updateGPS(gpsInfo.latitude, gpsInfo.longitude, gpsInfo.speedKnots, gpsInfo.courseOverGround,
+        gpsInfo.hdop))
+    {
+        _counters.fixes++;
+        _counters.lastArrivalNs = gpsInfo.positionArrivalNs;
+        _lastFixNs = gpsInfo.positionArrivalNs;
+        if (!initialized)
+        {
+            _log->write(LogLevel::NOTICE, "fusion: started at %f, %f\n", gpsInfo.latitude, gpsInfo.longitude);
+        }
+    }
+    else
+    {
+        _log->write(LogLevel::DEBUG, "fusion: fix %f, %f rejected\n", gpsInfo.latitude, gpsInfo.longitude);
+        _counters.rejectedFixes++;
+    }
+    _lastPositionNs = gpsInfo.positionArrivalNs;
+}
+
+void SensorFusion::fuseHeading(const HeadingData &heading)
+{
+    advance(heading.arrivalNs);
+    _filter.updateHeading(heading.trueHeading);
+    _counters.headings++;
+    _counters.lastArrivalNs = heading.arrivalNs;
+    _lastHeadingNs = heading.arrivalNs;
+}
+
+void SensorFusion::advance(uint64_t arrivalNs)
+{
+    if (arrivalNs > _filterNs)
+    {
+        _filter.predict((arrivalNs - _filterNs) / 1e9);
+        _filterNs = arrivalNs;
+    }
+}
+
+bool SensorFusion::waitForStopUntil(uint64_t deadlineNs)
+{
+    uint64_t now = monotonicNs();
+    struct timespec timeout = {0, 0};
+    if (deadlineNs > now)
+    {
+        timeout.tv_sec = (deadlineNs - now) / 1000000000ULL;
+        timeout.tv_nsec = (deadlineNs - now) % 1000000000ULL;
+    }
+
+    struct pollfd pfd;
+    pfd.fd = _eventfd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    return (ppoll(&pfd, 1, &timeout, nullptr) > 0) && (pfd.revents & POLLIN);
+}
+
+}
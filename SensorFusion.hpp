@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SENSORFUSION_HPP
+#define SENSORFUSION_HPP
+
+#include "SingleThread.hpp"
+#include "Log.hpp"
+#include "FusionConfig.hpp"
+#include "FusionReader.hpp"
+#include "GPSReader.hpp"
+#include "MagnetometerReader.hpp"
+#include "PositionFilter.hpp"
+#include "Seqlock.hpp"
+
+#include <cstdint>
+
+namespace ship_position
+{
+
+// fuses GPS fixes and compass headings in a PositionFilter and publishes the state at the configured rate
+class SensorFusion : public SingleThread, public FusionReader
+{
+public:
+    // the readers have to outlive the fusion
+    SensorFusion(const FusionConfig &config, GPSReader &gpsReader, MagnetometerReader &magnetometerReader);
+    virtual ~SensorFusion();
+    virtual void run();
+    virtual void stop();
+    virtual void getFusedState(FusedState &state);
+    virtual void getFusionStatistics(FusionStatistics &statistics);
+
+    // one publishing cycle at CLOCK_MONOTONIC nowNs
+    void cycle(uint64_t nowNs);
+
+protected:
+    // returns true if stop was requested before the CLOCK_MONOTONIC deadline
+    bool waitForStopUntil(uint64_t deadlineNs);
+    void fuseFix(const GPSInfo &gpsInfo);
+    void fuseHeading(const HeadingData &heading);
+    // predicts the filter forward to a measurement; older ones are fused as if they were current
+    void advance(uint64_t arrivalNs);
+
+    const FusionConfig &_config;
+    GPSReader &_gpsReader;
+    MagnetometerReader &_magnetometerReader;
+    Log *_log;
+    // used to wake up the fusion thread on stop()
+    int _eventfd;
+    // the rest is used by the thread calling cycle() only
+    PositionFilter _filter;
+    // time the filter state refers to, the published state is predicted further from it
+    uint64_t _filterNs;
+    uint64_t _lastFixNs;
+    // GPSInfo::positionArrivalNs of the last fix fused or rejected
+    uint64_t _lastPositionNs;
+    uint64_t _lastHeadingNs;
+    bool _deadReckoning;
+    FusionStatistics _counters;
+    Seqlock<FusedState> _state;
+    Seqlock<FusionStatistics> _statistics;
+};
+
+}
+
+#endif // SENSORFUSION_HPP
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SEQLOCK_HPP
+#define SEQLOCK_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace ship_position
+{
+
+// latest value published by one writer thread to any number of readers, neither side blocks
+template <typename T>
+class Seqlock
+{
+public:
+    static_assert(std::is_trivially_copyable_v<T>, "snapshot is copied bytewise");
+
+    Seqlock() : _sequence(0)
+    {
+        T value = T();
+        uint64_t words[NUM_WORDS] = {};
+        std::memcpy(words, &value, sizeof(T));
+        for (size_t i = 0; i < NUM_WORDS; i++)
+        {
+            _data[i].store(words[i], std::memory_order_relaxed);
+        }
+    }
+
+    Seqlock(const Seqlock &other) = delete;
+
+    // writer side
+    void store(const T &value)
+    {
+        uint64_t words[NUM_WORDS] = {};
+        std::memcpy(words, &value, sizeof(T));
+
+        // odd sequence marks a store in progress
+        uint64_t sequence = _sequence.load(std::memory_order_relaxed);
+        _sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < NUM_WORDS; i++)
+        {
+            _data[i].store(words[i], std::memory_order_relaxed);
+        }
+        _sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    // reader side
+    void load(T &value) const
+    {
+        uint64_t words[NUM_WORDS];
+        uint64_t before;
+        uint64_t after;
+        do
+        {
+            before = _sequence.load(std::memory_order_acquire);
+            for (size_t i = 0; i < NUM_WORDS; i++)
+            {
+                words[i] = _data[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = _sequence.load(std::memory_order_relaxed);
+        }
+        while ((before != after) || (before & 1));
+        std::memcpy(&value, words, sizeof(T));
+    }
+
+    // number of completed store() calls
+    uint64_t updates() const
+    {
+        return _sequence.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    static constexpr size_t NUM_WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    // atomic words, so that a reader racing with the writer isn't a data race
+    alignas(64) std::atomic<uint64_t> _sequence;
+    alignas(64) std::atomic<uint64_t> _data[NUM_WORDS];
+};
+
+}
+
+#endif // SEQLOCK_HPP
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2024 - 2025 Mikhail Sapozhnikov
+ * Copyright (C) 2024 - 2026 Mikhail Sapozhnikov
  *
  * This file is part of ship-position.
  *
@@ -35,9 +35,12 @@ ShipPosition::ShipPosition() :
 _syslog(nullptr),
 _consoleLog(nullptr),
 _config(nullptr),
+_replaySpeed(-1.0),
 _stopRequested(false),
 _bn880gpsReader(nullptr),
+_qmc5883lBus(nullptr),
 _qmc5883lReader(nullptr),
+_sensorFusion(nullptr),
 _unixListener(nullptr)
 {
     _log = Log::getInstance();
@@ -50,8 +53,10 @@ ShipPosition::~ShipPosition()
     delete _syslog;
     delete _consoleLog;
     delete _config;
+    delete _sensorFusion;
     delete _bn880gpsReader;
     delete _qmc5883lReader;
+    delete _qmc5883lBus;
     delete _unixListener;
 }
 
@@ -75,6 +80,7 @@ int ShipPosition::run(int argc, char **argv)
 
     _bn880gpsReader->start();
     _qmc5883lReader->start();
+    _sensorFusion->start();
     _unixListener->start();
 
     while (true)
@@ -83,6 +89,8 @@ int ShipPosition::run(int argc, char **argv)
         {
             _log->write(LogLevel::NOTICE, "Ship position stopping\n");
             _unixListener->stop();
+            _qmc5883lReader->stop();
+            _sensorFusion->stop();
             _bn880gpsReader->stop();
             break;
         }
@@ -129,14 +137,26 @@ int ShipPosition::init(int argc, char **argv)
     _log->set_level(_config->getLogLevel());
 
     _config->getBN880GPSConfig(_bn880gpsConfig);
+    if (_replayFile != "")
+    {
+        _bn880gpsConfig.replayFile = _replayFile;
+    }
+    if (_replaySpeed >= 0.0)
+    {
+        _bn880gpsConfig.replaySpeed = _replaySpeed;
+    }
     _config->getQMC5883LConfig(_qmc5883lConfig);
+    _config->getFusionConfig(_fusionConfig);
     _config->getIPCConfig(_ipcConfig);
 
     _bn880gpsReader = new BN880GPSReader(_bn880gpsConfig);
 
-    _qmc5883lReader = new QMC5883LReader(_qmc5883lConfig);
+    _qmc5883lBus = new LinuxI2CBus(_qmc5883lConfig.devPath, QMC5883L_I2C_ADDR);
+    _qmc5883lReader = new QMC5883LReader(_qmc5883lConfig, *_qmc5883lBus);
+
+    _sensorFusion = new SensorFusion(_fusionConfig, *_bn880gpsReader, *_qmc5883lReader);
 
-    _unixListener = new UnixListener(_ipcConfig, *_bn880gpsReader, *_qmc5883lReader);
+    _unixListener = new UnixListener(_ipcConfig, *_bn880gpsReader, *_qmc5883lReader, *_sensorFusion);
 
     setupSignals();
 
@@ -152,7 +172,9 @@ int ShipPosition::handleCmdLine(int argc, char **argv)
 
         opt_descr.add_options()
             ("help", "print help message")
-            ("config", po::value<std::string>(), "config file path");
+            ("config", po::value<std::string>(), "config file path")
+            ("replay", po::value<std::string>(), "replay recorded raw gps output instead of reading the receiver")
+            ("replay-speed", po::value<double>(), "replay speed: 1 - real time, N - N times faster, 0 - max");
 
         po::store(po::parse_command_line(argc, argv, opt_descr), opts);
         po::notify(opts);
@@ -171,6 +193,14 @@ int ShipPosition::handleCmdLine(int argc, char **argv)
         {
             _configPath = DEFAULT_CONFIG_PATH;
         }
+        if (opts.count("replay"))
+        {
+            _replayFile = opts["replay"].as<std::string>();
+        }
+        if (opts.count("replay-speed"))
+        {
+            _replaySpeed = opts["replay-speed"].as<double>();
+        }
 
         return RETVAL_OK;
     }
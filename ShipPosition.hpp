@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2024 - 2025 Mikhail Sapozhnikov
+ * Copyright (C) 2024 - 2026 Mikhail Sapozhnikov
  *
  * This file is part of ship-position.
  *
@@ -26,6 +26,8 @@
 #include "BN880GPSReader.hpp"
 #include "UnixListener.hpp"
 #include "QMC5883LReader.hpp"
+#include "LinuxI2CBus.hpp"
+#include "SensorFusion.hpp"
 #include <string>
 
 namespace ship_position
@@ -56,11 +58,17 @@ protected:
     ConsoleLog *_consoleLog;
     Config *_config;
     std::string _configPath;
+    // command line overrides of bn880GPSConfig replay settings, speed < 0 if not given
+    std::string _replayFile;
+    double _replaySpeed;
     bool _stopRequested;
     BN880GPSConfig _bn880gpsConfig;
     BN880GPSReader *_bn880gpsReader;
     QMC5883LConfig _qmc5883lConfig;
+    LinuxI2CBus *_qmc5883lBus;
     QMC5883LReader *_qmc5883lReader;
+    FusionConfig _fusionConfig;
+    SensorFusion *_sensorFusion;
     IPCConfig _ipcConfig;
     UnixListener *_unixListener;
 };
@@ -0,0 +1,266 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "UBXParser.hpp"
+
+namespace ship_position
+{
+
+namespace
+{
+
+// UBX payloads are little endian
+uint16_t getU2(const uint8_t *p)
+{
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t getU4(const uint8_t *p)
+{
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+        (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+int32_t getI4(const uint8_t *p)
+{
+    return static_cast<int32_t>(getU4(p));
+}
+
+constexpr size_t NAV_PVT_LENGTH = 92;
+constexpr size_t NAV_DOP_LENGTH = 18;
+constexpr double KNOTS_PER_MPS = 1.943844;
+constexpr double KMH_PER_MPS = 3.6;
+
+}
+
+UBXParser::UBXParser(MessageCallback onMessage) :
+    _onMessage(onMessage),
+    _state(State::SYNC1),
+    _msgClass(0),
+    _msgId(0),
+    _length(0),
+    _received(0),
+    _ckA(0),
+    _ckB(0),
+    _frames(0),
+    _checksumErrors(0)
+{
+}
+
+size_t UBXParser::feed(const char *data, size_t length)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        uint8_t byte = static_cast<uint8_t>(data[i]);
+
+        switch (_state)
+        {
+            case State::SYNC1:
+                if (byte == SYNC_CHAR_1)
+                {
+                    _state = State::SYNC2;
+                }
+                break;
+
+            case State::SYNC2:
+                if (byte != SYNC_CHAR_2)
+                {
+                    // not a frame, leave the byte to other parsers
+                    reset();
+                    return i;
+                }
+                _ckA = 0;
+                _ckB = 0;
+                _state = State::CLASS;
+                break;
+
+            case State::CLASS:
+                _msgClass = byte;
+                checksumAdd(byte);
+                _state = State::ID;
+                break;
+
+            case State::ID:
+                _msgId = byte;
+                checksumAdd(byte);
+                _state = State::LENGTH_LOW;
+                break;
+
+            case State::LENGTH_LOW:
+                _length = byte;
+                checksumAdd(byte);
+                _state = State::LENGTH_HIGH;
+                break;
+
+            case State::LENGTH_HIGH:
+                _length |= static_cast<size_t>(byte) << 8;
+                checksumAdd(byte);
+                if (_length > MAX_PAYLOAD_LENGTH)
+                {
+                    reset();
+                    return i + 1;
+                }
+                _received = 0;
+                _state = (_length == 0) ? State::CHECKSUM_A : State::PAYLOAD;
+                break;
+
+            case State::PAYLOAD:
+                _payload[_received++] = byte;
+                checksumAdd(byte);
+                if (_received == _length)
+                {
+                    _state = State::CHECKSUM_A;
+                }
+                break;
+
+            case State::CHECKSUM_A:
+                if (byte != _ckA)
+                {
+                    _checksumErrors++;
+                    reset();
+                    return i + 1;
+                }
+                _state = State::CHECKSUM_B;
+                break;
+
+            case State::CHECKSUM_B:
+                _state = State::SYNC1;
+                if (byte != _ckB)
+                {
+                    _checksumErrors++;
+                    return i + 1;
+                }
+                _frames++;
+                _onMessage(_msgClass, _msgId, _payload, _length);
+                return i + 1;
+        }
+    }
+
+    return length;
+}
+
+void UBXParser::reset()
+{
+    _state = State::SYNC1;
+    _length = 0;
+    _received = 0;
+}
+
+void UBXParser::checksumAdd(uint8_t byte)
+{
+    _ckA += byte;
+    _ckB += _ckA;
+}
+
+std::vector<uint8_t> UBXParser::makeFrame(uint8_t msgClass, uint8_t msgId, const std::vector<uint8_t> &payload)
+{
+    std::vector<uint8_t> frame;
+    frame.reserve(payload.size() + 8);
+    frame.push_back(SYNC_CHAR_1);
+    frame.push_back(SYNC_CHAR_2);
+    frame.push_back(msgClass);
+    frame.push_back(msgId);
+    frame.push_back(payload.size() & 0xff);
+    frame.push_back((payload.size() >> 8) & 0xff);
+    frame.insert(frame.end(), payload.begin(), payload.end());
+
+    uint8_t ckA = 0;
+    uint8_t ckB = 0;
+    for (size_t i = 2; i < frame.size(); i++)
+    {
+        ckA += frame[i];
+        ckB += ckA;
+    }
+    frame.push_back(ckA);
+    frame.push_back(ckB);
+    return frame;
+}
+
+bool UBXParser::decodeNavPVT(const uint8_t *payload, size_t length, GPSInfo &gpsInfo)
+{
+    if (length < NAV_PVT_LENGTH)
+    {
+        return false;
+    }
+
+    uint8_t valid = payload[11];
+    if (valid & 0x01)
+    {
+        gpsInfo.utcYear = getU2(payload + 4);
+        gpsInfo.utcMonth = payload[6];
+        gpsInfo.utcDay = payload[7];
+    }
+    if (valid & 0x02)
+    {
+        gpsInfo.utcHours = payload[8];
+        gpsInfo.utcMinutes = payload[9];
+        // nano is signed and corrects the rounded seconds
+        gpsInfo.utcSeconds = payload[10] + getI4(payload + 16) * 1e-9;
+    }
+
+    uint8_t fixType = payload[20];
+    bool fixOk = payload[21] & 0x01;
+    gpsInfo.fixQuality = fixOk ? 1 : 0;
+    if (fixType == 2)
+    {
+        gpsInfo.fixMode = 2;
+    }
+    else if ((fixType == 3) || (fixType == 4))
+    {
+        gpsInfo.fixMode = 3;
+    }
+    else
+    {
+        gpsInfo.fixMode = 1;
+    }
+    gpsInfo.numSatellites = payload[23];
+
+    // like with GGA, the last known position is kept while there is no fix
+    if (fixOk)
+    {
+        gpsInfo.longitude = getI4(payload + 24) * 1e-7;
+        gpsInfo.latitude = getI4(payload + 28) * 1e-7;
+        gpsInfo.altitude = getI4(payload + 36) / 1000.0;
+
+        double speed = getI4(payload + 60) / 1000.0;
+        gpsInfo.speedKnots = speed * KNOTS_PER_MPS;
+        gpsInfo.speedKm = speed * KMH_PER_MPS;
+        gpsInfo.courseOverGround = getI4(payload + 64) * 1e-5;
+        gpsInfo.positionArrivalNs = gpsInfo.arrivalNs;
+    }
+    gpsInfo.pdop = getU2(payload + 76) * 0.01;
+
+    return true;
+}
+
+bool UBXParser::decodeNavDOP(const uint8_t *payload, size_t length, GPSInfo &gpsInfo)
+{
+    if (length < NAV_DOP_LENGTH)
+    {
+        return false;
+    }
+
+    gpsInfo.pdop = getU2(payload + 6) * 0.01;
+    gpsInfo.vdop = getU2(payload + 10) * 0.01;
+    gpsInfo.hdop = getU2(payload + 12) * 0.01;
+    return true;
+}
+
+}
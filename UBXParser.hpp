@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef UBXPARSER_HPP
+#define UBXPARSER_HPP
+
+#include "GPSReader.hpp"
+#include <functional>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace ship_position
+{
+
+// resumable framing state machine for the u-blox UBX binary protocol
+class UBXParser
+{
+public:
+    typedef std::function<void(uint8_t msgClass, uint8_t msgId, const uint8_t *payload, size_t length)> MessageCallback;
+
+    static constexpr uint8_t SYNC_CHAR_1 = 0xb5;
+    static constexpr uint8_t SYNC_CHAR_2 = 0x62;
+    // longest message accepted, longer frames are dropped
+    static constexpr size_t MAX_PAYLOAD_LENGTH = 512;
+
+    static constexpr uint8_t CLASS_NAV = 0x01;
+    static constexpr uint8_t CLASS_ACK = 0x05;
+    static constexpr uint8_t CLASS_CFG = 0x06;
+    // standard NMEA sentences, for enabling/disabling them with CFG-MSG
+    static constexpr uint8_t CLASS_NMEA = 0xf0;
+    static constexpr uint8_t ID_NAV_DOP = 0x04;
+    static constexpr uint8_t ID_NAV_PVT = 0x07;
+    static constexpr uint8_t ID_CFG_PRT = 0x00;
+    static constexpr uint8_t ID_CFG_MSG = 0x01;
+    static constexpr uint8_t ID_CFG_RATE = 0x08;
+
+    UBXParser(MessageCallback onMessage);
+
+    // returns number of bytes consumed, stops after each frame and before non-UBX bytes
+    size_t feed(const char *data, size_t length);
+    // drops the partially received frame
+    void reset();
+    // true if no frame is being received
+    bool idle() const { return _state == State::SYNC1; }
+
+    uint64_t frames() const { return _frames; }
+    uint64_t checksumErrors() const { return _checksumErrors; }
+
+    // builds a complete frame, ready to be sent to the receiver
+    static std::vector<uint8_t> makeFrame(uint8_t msgClass, uint8_t msgId, const std::vector<uint8_t> &payload);
+    // NAV-PVT: position, velocity, time; returns false if the payload is too short
+    static bool decodeNavPVT(const uint8_t *payload, size_t length, GPSInfo &gpsInfo);
+    // NAV-DOP: dilution of precision
+    static bool decodeNavDOP(const uint8_t *payload, size_t length, GPSInfo &gpsInfo);
+
+protected:
+    enum class State
+    {
+        SYNC1,
+        SYNC2,
+        CLASS,
+        ID,
+        LENGTH_LOW,
+        LENGTH_HIGH,
+        PAYLOAD,
+        CHECKSUM_A,
+        CHECKSUM_B
+    };
+
+    void checksumAdd(uint8_t byte);
+
+    MessageCallback _onMessage;
+    State _state;
+    uint8_t _msgClass;
+    uint8_t _msgId;
+    size_t _length;
+    size_t _received;
+    uint8_t _ckA;
+    uint8_t _ckB;
+    uint8_t _payload[MAX_PAYLOAD_LENGTH];
+    uint64_t _frames;
+    uint64_t _checksumErrors;
+};
+
+}
+
+#endif // UBXPARSER_HPP
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2024 - 2025 Mikhail Sapozhnikov
+ * Copyright (C) 2024 - 2026 Mikhail Sapozhnikov
  *
  * This file is part of ship-position.
  *
@@ -28,12 +28,14 @@
 namespace ship_position
 {
 
-UnixListener::UnixListener(const IPCConfig &config, GPSReader &gpsReader, MagnetometerReader &magnetometerReader)
+UnixListener::UnixListener(const IPCConfig &config, GPSReader &gpsReader, MagnetometerReader &magnetometerReader,
+    FusionReader &fusionReader)
 : _config(config),
   _fd(-1),
+  _nextClientId(1),
   _gpsReader(gpsReader),
   _magnetometerReader(magnetometerReader),
-  _nextClientId(1)
+  _fusionReader(fusionReader)
 {
     _log = Log::getInstance();
 }
@@ -69,8 +71,8 @@ void UnixListener::run()
             continue;
         }
 
-        IPCClient *client = new IPCClient(_nextClientId++, clientsock, _config, _gpsReader,
-            _magnetometerReader, methodWrapper<UnixListener, void, int>(this, &UnixListener::onClientStopped));
+        IPCClient *client = new IPCClient(_nextClientId++, clientsock, _config, _gpsReader, _magnetometerReader,
+            _fusionReader, methodWrapper<UnixListener, void, int>(this, &UnixListener::onClientStopped));
         _clients.push_back(client);
         client->start();
     }
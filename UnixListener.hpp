@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2024 - 2025 Mikhail Sapozhnikov
+ * Copyright (C) 2024 - 2026 Mikhail Sapozhnikov
  *
  * This file is part of ship-position.
  *
@@ -27,6 +27,7 @@
 #include "IPCClient.hpp"
 #include "GPSReader.hpp"
 #include "MagnetometerReader.hpp"
+#include "FusionReader.hpp"
 #include "MethodWrapper.hpp"
 #include <list>
 #include <mutex>
@@ -37,7 +38,8 @@ namespace ship_position
 class UnixListener : public SingleThread
 {
 public:
-    UnixListener(const IPCConfig &config, GPSReader &gpsReader, MagnetometerReader &magnetometerReader);
+    UnixListener(const IPCConfig &config, GPSReader &gpsReader, MagnetometerReader &magnetometerReader,
+        FusionReader &fusionReader);
     virtual ~UnixListener();
 
     virtual void run();
@@ -59,6 +61,7 @@ protected:
     std::vector<int> _stoppedClients;
     GPSReader &_gpsReader;
     MagnetometerReader &_magnetometerReader;
+    FusionReader &_fusionReader;
 };
 
 }
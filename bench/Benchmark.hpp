@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ship_position_bench
+{
+
+// registry of benchmarks compiled into ship-position-bench
+class Benchmarks
+{
+public:
+    struct Entry
+    {
+        std::string name;
+        std::function<void()> func;
+    };
+
+    static std::vector<Entry> &entries()
+    {
+        static std::vector<Entry> _entries;
+        return _entries;
+    }
+
+    static bool add(const std::string &name, std::function<void()> func)
+    {
+        entries().push_back({name, func});
+        return true;
+    }
+};
+
+#define BENCHMARK(name) \
+    static void name##_bench(); \
+    static bool name##_registered = ship_position_bench::Benchmarks::add(#name, name##_bench); \
+    static void name##_bench()
+
+inline uint64_t nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// prints min/median/p99/max of nanosecond samples, in microseconds or nanoseconds
+inline void report(const char *label, std::vector<uint64_t> samples, bool nanoseconds = false)
+{
+    if (samples.empty())
+    {
+        std::printf("  %-40s no samples\n", label);
+        return;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    double scale = nanoseconds ? 1.0 : 1000.0;
+    const char *unit = nanoseconds ? "ns" : "us";
+    auto percentile = [&samples, scale](double p) -> double
+    {
+        size_t idx = static_cast<size_t>(p * (samples.size() - 1));
+        return samples[idx] / scale;
+    };
+
+    std::printf("  %-40s n=%zu min=%.1f%s median=%.1f%s p99=%.1f%s max=%.1f%s\n", label, samples.size(),
+        percentile(0.0), unit, percentile(0.5), unit, percentile(0.99), unit, percentile(1.0), unit);
+}
+
+// prevents the compiler from optimizing away a benchmarked computation
+template<typename T>
+inline void doNotOptimize(const T &value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+}
+
+#endif // BENCHMARK_HPP
@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Benchmark.hpp"
+#include "BN880GPSReader.hpp"
+#include "IPCMessages.hpp"
+#include "UnixListener.hpp"
+#include "sim/GPSSimulator.hpp"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+namespace sp = ship_position;
+namespace spb = ship_position_bench;
+using json = nlohmann::json;
+
+namespace
+{
+
+class NullMagnetometerReader : public sp::MagnetometerReader
+{
+public:
+    virtual void getMagnetometerData(sp::MagnetometerData &) {}
+    virtual void getMagnetometerSamples(size_t, std::vector<sp::MagnetometerData> &) {}
+    virtual void getHeading(sp::HeadingData &) {}
+    virtual void getMagnetometerStatistics(sp::MagnetometerStatistics &) {}
+    virtual void getCalibrationStatus(sp::CalibrationStatus &) {}
+    virtual void getTemperatureCompensation(sp::TemperatureCompensation &) {}
+    virtual void startCalibration() {}
+    virtual bool stopCalibration() { return true; }
+};
+
+class NullFusionReader : public sp::FusionReader
+{
+public:
+    virtual void getFusedState(sp::FusedState &) {}
+    virtual void getFusionStatistics(sp::FusionStatistics &) {}
+};
+
+int connectClient(const std::string &socketPath)
+{
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1)
+    {
+        return -1;
+    }
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+    if (connect(fd, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) == -1)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+}
+
+// time from the simulator writing a GGA into the pty until a client polling GetGPSData sees its fix
+BENCHMARK(SensorToClient)
+{
+    constexpr double RATE = 20.0;
+    constexpr int DURATION_MS = 5000;
+    constexpr int POLL_INTERVAL_US = 100;
+
+    sp::GPSSimulatorConfig simConfig;
+    simConfig.rate = RATE;
+    simConfig.baudRate = 115200;
+    simConfig.splitProbability = 0.1;
+    simConfig.splitDelayUs = 500;
+    sp::GPSSimulator simulator(simConfig);
+    if (!simulator.isOk())
+    {
+        std::printf("  failed to open pty\n");
+        return;
+    }
+
+    std::mutex emitMutex;
+    std::vector<uint64_t> emitted;
+    simulator.setEpochCallback([&emitMutex, &emitted](uint64_t epoch, uint64_t timestampNs)
+    {
+        std::lock_guard<std::mutex> lock(emitMutex);
+        emitted.resize(epoch + 1, 0);
+        emitted[epoch] = timestampNs;
+    });
+
+    sp::BN880GPSConfig config;
+    config.devPath = simulator.slavePath();
+    config.bufferSize = 4096;
+    config.maxRetries = 3;
+    config.rawOutput = "";
+    config.maxRawFileSize = 0;
+    config.rawSegments = 0;
+    config.rawTimestamps = false;
+    config.replayFile = "";
+    config.replaySpeed = 1.0;
+    config.protocol = "nmea";
+    config.measurementRate = 0;
+    config.baudRate = 0;
+    config.messages = {};
+    config.portBaudRate = 0;
+    config.vmin = 1;
+    config.vtime = 0;
+    config.lowLatency = false;
+
+    sp::IPCConfig ipcConfig;
+    ipcConfig.bufSize = 4096;
+    ipcConfig.socketPath = "/tmp/ship-position-bench.socket";
+
+    sp::BN880GPSReader reader(config);
+    NullMagnetometerReader magnetometerReader;
+    NullFusionReader fusionReader;
+    sp::UnixListener listener(ipcConfig, reader, magnetometerReader, fusionReader);
+    reader.start();
+    listener.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    int fd = connectClient(ipcConfig.socketPath);
+    if (fd == -1)
+    {
+        std::printf("  failed to connect to %s\n", ipcConfig.socketPath.c_str());
+        listener.stop();
+        reader.stop();
+        return;
+    }
+
+    sp::IPCRequest rq;
+    rq.cmd = rq.cmdGetGPS;
+    std::string rqStr = json(rq).dump();
+    std::vector<std::pair<uint64_t, uint64_t>> seen;
+    std::vector<uint64_t> roundTrips;
+    char buf[4096];
+
+    simulator.start();
+    uint64_t end = spb::nowNs() + DURATION_MS * 1000000ULL;
+    uint64_t lastEpoch = UINT64_MAX;
+    while (spb::nowNs() < end)
+    {
+        uint64_t sent = spb::nowNs();
+        if (write(fd, rqStr.c_str(), rqStr.length()) == -1)
+        {
+            break;
+        }
+        ssize_t numRead = read(fd, buf, sizeof(buf) - 1);
+        if (numRead <= 0)
+        {
+            break;
+        }
+        uint64_t received = spb::nowNs();
+        roundTrips.push_back(received - sent);
+        buf[numRead] = '\0';
+
+        sp::GPSInfoResponse resp = json::parse(buf).get<sp::GPSInfoResponse>();
+        if (resp.fixQuality != 0)
+        {
+            uint64_t epoch = sp::GPSSimulator::epochFromTime(RATE, resp.utcHours, resp.utcMinutes, resp.utcSeconds);
+            if (epoch != lastEpoch)
+            {
+                lastEpoch = epoch;
+                seen.push_back({epoch, received});
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(POLL_INTERVAL_US));
+    }
+
+    simulator.stop();
+    close(fd);
+    listener.stop();
+    reader.stop();
+
+    std::vector<uint64_t> samples;
+    for (const auto &[epoch, received] : seen)
+    {
+        if ((epoch < emitted.size()) && (emitted[epoch] != 0) && (received > emitted[epoch]))
+        {
+            samples.push_back(received - emitted[epoch]);
+        }
+    }
+    spb::report("GGA write to client, 20 Hz 115200 baud", samples);
+    spb::report("GetGPSData round trip", roundTrips);
+    std::printf("  %llu epochs, %zu seen by client, %llu split, %llu bytes overrun\n",
+        static_cast<unsigned long long>(simulator.epochs()), seen.size(),
+        static_cast<unsigned long long>(simulator.split()), static_cast<unsigned long long>(simulator.overruns()));
+}
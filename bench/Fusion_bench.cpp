@@ -0,0 +1,299 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Benchmark.hpp"
+#include "SensorFusion.hpp"
+#include "sim/GPSSimulator.hpp"
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace sp = ship_position;
+namespace spb = ship_position_bench;
+
+namespace
+{
+
+constexpr double METERS_PER_DEGREE = 6371008.8 * M_PI / 180.0;
+constexpr double MPS_PER_KNOT = 1852.0 / 3600.0;
+constexpr double LATITUDE = 56.317748;
+constexpr double LONGITUDE = 44.0187135;
+constexpr uint64_t TENTH_NS = 100000000ULL;
+// 20 minutes, fusion cycles and compass headings at 10 Hz, fixes at 1 Hz
+constexpr int TENTHS = 12000;
+// the receiver loses the sky for 30 s every 5 minutes
+constexpr int OUTAGE_PERIOD = 3000;
+constexpr int OUTAGE_LENGTH = 300;
+constexpr double POSITION_NOISE = 2.5;
+constexpr double VELOCITY_NOISE = 0.1;
+constexpr double HEADING_NOISE = 2.0;
+// set 120 degrees at 0.3 m/s
+constexpr double CURRENT_NORTH = -0.15;
+constexpr double CURRENT_EAST = 0.26;
+
+// what the readers published at one fusion cycle, and where the vessel really was
+struct RecordedTenth
+{
+    double north;
+    double east;
+    bool fix;
+    sp::GPSInfo gpsInfo;
+    sp::HeadingData heading;
+};
+
+class ReplayGPSReader : public sp::GPSReader
+{
+public:
+    virtual void getGPSInfo(sp::GPSInfo &gpsInfo) { gpsInfo = info; }
+    virtual void getNMEAStatistics(sp::NMEAStatistics &) {}
+    virtual void getSatellites(sp::SatelliteTable &) {}
+
+    sp::GPSInfo info;
+};
+
+class ReplayMagnetometerReader : public sp::MagnetometerReader
+{
+public:
+    virtual void getMagnetometerData(sp::MagnetometerData &) {}
+    virtual void getMagnetometerSamples(size_t, std::vector<sp::MagnetometerData> &) {}
+    virtual void getMagnetometerStatistics(sp::MagnetometerStatistics &) {}
+    virtual void getHeading(sp::HeadingData &data) { data = heading; }
+    virtual void getCalibrationStatus(sp::CalibrationStatus &) {}
+    virtual void getTemperatureCompensation(sp::TemperatureCompensation &) {}
+    virtual void startCalibration() {}
+    virtual bool stopCalibration() { return true; }
+
+    sp::HeadingData heading;
+};
+
+double metersPerDegreeLongitude()
+{
+    return METERS_PER_DEGREE * std::cos(LATITUDE * M_PI / 180.0);
+}
+
+bool outage(int tenth)
+{
+    return (tenth % OUTAGE_PERIOD) >= OUTAGE_PERIOD - OUTAGE_LENGTH;
+}
+
+// the simulator's default track with a current, noisy fixes and headings
+std::vector<RecordedTenth> record()
+{
+    sp::GPSSimulatorConfig simulatorConfig;
+    const std::vector<sp::SimulatorTrackLeg> &track = simulatorConfig.track;
+    std::mt19937 random(1);
+    std::normal_distribution<double> gauss(0.0, 1.0);
+
+    std::vector<RecordedTenth> recording;
+    double north = 0.0;
+    double east = 0.0;
+    size_t leg = 0;
+    double legTime = 0.0;
+    double heading = track[0].course;
+    sp::GPSInfo gpsInfo;
+    for (int tenth = 1; tenth <= TENTHS; tenth++)
+    {
+        double speed = track[leg].speedKnots * MPS_PER_KNOT;
+        for (int i = 0; i < 10; i++)
+        {
+            double h = (heading + track[leg].turnRate * 0.005) * M_PI / 180.0;
+            north += (speed * std::cos(h) + CURRENT_NORTH) * 0.01;
+            east += (speed * std::sin(h) + CURRENT_EAST) * 0.01;
+            heading = std::fmod(heading + track[leg].turnRate * 0.01 + 360.0, 360.0);
+        }
+        legTime += 0.1;
+        if (legTime >= track[leg].duration - 1e-9)
+        {
+            leg = (leg + 1) % track.size();
+            legTime = 0.0;
+            heading = track[leg].course;
+        }
+
+        RecordedTenth recorded;
+        recorded.north = north;
+        recorded.east = east;
+        uint64_t now = tenth * TENTH_NS;
+        recorded.fix = (tenth % 10 == 0) && !outage(tenth);
+        if (recorded.fix)
+        {
+            double h = heading * M_PI / 180.0;
+            double velocityNorth = speed * std::cos(h) + CURRENT_NORTH + VELOCITY_NOISE * gauss(random);
+            double velocityEast = speed * std::sin(h) + CURRENT_EAST + VELOCITY_NOISE * gauss(random);
+            double course = std::atan2(velocityEast, velocityNorth) * 180.0 / M_PI;
+            gpsInfo.fixQuality = 1;
+            gpsInfo.latitude = LATITUDE + (north + POSITION_NOISE * gauss(random)) / METERS_PER_DEGREE;
+            gpsInfo.longitude = LONGITUDE + (east + POSITION_NOISE * gauss(random)) / metersPerDegreeLongitude();
+            gpsInfo.speedKnots = std::hypot(velocityNorth, velocityEast) / MPS_PER_KNOT;
+            gpsInfo.courseOverGround = (course < 0.0) ? course + 360.0 : course;
+            gpsInfo.hdop = 1.0;
+            gpsInfo.arrivalNs = now;
+            gpsInfo.positionArrivalNs = now;
+        }
+        recorded.gpsInfo = gpsInfo;
+        recorded.heading.trueHeading = std::fmod(heading + HEADING_NOISE * gauss(random) + 360.0, 360.0);
+        recorded.heading.arrivalNs = now;
+        recording.push_back(recorded);
+    }
+    return recording;
+}
+
+double distance(double latitude, double longitude, const RecordedTenth &truth)
+{
+    double dn = (latitude - LATITUDE) * METERS_PER_DEGREE - truth.north;
+    double de = (longitude - LONGITUDE) * metersPerDegreeLongitude() - truth.east;
+    return std::hypot(dn, de);
+}
+
+struct ErrorSummary
+{
+    double sum2 = 0.0;
+    double max = 0.0;
+    size_t count = 0;
+
+    void add(double error)
+    {
+        sum2 += error * error;
+        max = std::max(max, error);
+        count++;
+    }
+
+    void print(const char *label) const
+    {
+        std::printf("  %-40s n=%zu rms=%.2fm max=%.2fm\n", label, count, std::sqrt(sum2 / std::max<size_t>(count, 1)),
+            max);
+    }
+};
+
+}
+
+// 20 minute passage with GPS outages at 10 Hz: position error against the last fix, CPU time per cycle
+BENCHMARK(FusionReplay)
+{
+    std::vector<RecordedTenth> recording = record();
+
+    sp::FusionConfig config;
+    config.publishRate = 10.0;
+    config.gpsTimeout = 2.5;
+    config.maxDeadReckoning = 60.0;
+    config.useCompass = true;
+    config.positionNoise = POSITION_NOISE;
+    config.velocityNoise = VELOCITY_NOISE;
+    config.headingNoise = HEADING_NOISE;
+    config.accelerationNoise = 0.2;
+    config.turnNoise = 2.0;
+    config.currentNoise = 0.01;
+
+    ReplayGPSReader gpsReader;
+    ReplayMagnetometerReader magnetometerReader;
+    sp::SensorFusion fusion(config, gpsReader, magnetometerReader);
+
+    ErrorSummary fixErrors;
+    ErrorSummary fusedErrors;
+    ErrorSummary outageFixErrors;
+    ErrorSummary outageFusedErrors;
+    std::vector<uint64_t> fixCycles;
+    std::vector<uint64_t> headingCycles;
+    for (size_t i = 0; i < recording.size(); i++)
+    {
+        const RecordedTenth &recorded = recording[i];
+        gpsReader.info = recorded.gpsInfo;
+        magnetometerReader.heading = recorded.heading;
+
+        uint64_t start = spb::nowNs();
+        fusion.cycle(recorded.heading.arrivalNs);
+        uint64_t elapsed = spb::nowNs() - start;
+        (recorded.fix ? fixCycles : headingCycles).push_back(elapsed);
+
+        sp::FusedState state;
+        fusion.getFusedState(state);
+        if (!state.valid)
+        {
+            continue;
+        }
+        double fixError = distance(recorded.gpsInfo.latitude, recorded.gpsInfo.longitude, recorded);
+        double fusedError = distance(state.latitude, state.longitude, recorded);
+        if (outage(static_cast<int>(i) + 1))
+        {
+            outageFixErrors.add(fixError);
+            outageFusedErrors.add(fusedError);
+        }
+        else
+        {
+            fixErrors.add(fixError);
+            fusedErrors.add(fusedError);
+        }
+    }
+
+    fixErrors.print("last fix, GPS available");
+    fusedErrors.print("fused, GPS available");
+    outageFixErrors.print("last fix, 30 s outages");
+    outageFusedErrors.print("fused, 30 s outages");
+    spb::report("cycle with fix and heading", fixCycles, true);
+    spb::report("cycle with heading", headingCycles, true);
+}
+
+// the filter steps alone
+BENCHMARK(FusionFilter)
+{
+    sp::FusionConfig config;
+    config.positionNoise = POSITION_NOISE;
+    config.velocityNoise = VELOCITY_NOISE;
+    config.headingNoise = HEADING_NOISE;
+    config.accelerationNoise = 0.2;
+    config.turnNoise = 2.0;
+    config.currentNoise = 0.01;
+    sp::PositionFilter filter(config);
+    filter.updateGPS(LATITUDE, LONGITUDE, 8.0, 45.0, 1.0);
+
+    const int ITERATIONS = 200;
+    const int BATCH = 1000;
+    std::vector<uint64_t> predicts;
+    std::vector<uint64_t> headings;
+    std::vector<uint64_t> fixes;
+    for (int i = 0; i < ITERATIONS; i++)
+    {
+        uint64_t start = spb::nowNs();
+        for (int k = 0; k < BATCH; k++)
+        {
+            filter.predict(0.01);
+        }
+        predicts.push_back((spb::nowNs() - start) / BATCH);
+
+        start = spb::nowNs();
+        for (int k = 0; k < BATCH; k++)
+        {
+            filter.updateHeading(45.0 + (k % 3));
+        }
+        headings.push_back((spb::nowNs() - start) / BATCH);
+
+        sp::FusedState state;
+        filter.getState(state);
+        start = spb::nowNs();
+        for (int k = 0; k < BATCH; k++)
+        {
+            filter.updateGPS(state.latitude, state.longitude, 8.0, 45.0, 1.0);
+        }
+        fixes.push_back((spb::nowNs() - start) / BATCH);
+    }
+
+    spb::report("PositionFilter::predict", predicts, true);
+    spb::report("PositionFilter::updateHeading", headings, true);
+    spb::report("PositionFilter::updateGPS", fixes, true);
+}
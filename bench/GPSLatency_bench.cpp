@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Benchmark.hpp"
+#include "BN880GPSReader.hpp"
+#include "NMEAParser.hpp"
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+namespace sp = ship_position;
+namespace spb = ship_position_bench;
+
+namespace
+{
+
+// builds a GGA sentence with valid checksum, latitude minutes are taken from the sequence number
+std::string makeGGA(int seq)
+{
+    char body[128];
+    std::snprintf(body, sizeof(body), "GNGGA,170257.00,56%02d.%05d,N,04401.12281,E,1,09,1.36,124.2,M,6.3,M,,",
+        (seq / 100000) % 60, seq % 100000);
+    unsigned char checksum = 0;
+    for (const char *c = body; *c != '\0'; c++)
+    {
+        checksum ^= static_cast<unsigned char>(*c);
+    }
+    char sentence[160];
+    std::snprintf(sentence, sizeof(sentence), "$%s*%02X\r\n", body, checksum);
+    return sentence;
+}
+
+int openPty(std::string &slavePath)
+{
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if ((master == -1) || (grantpt(master) == -1) || (unlockpt(master) == -1))
+    {
+        return -1;
+    }
+    slavePath = ptsname(master);
+    return master;
+}
+
+// the reader loop as it was before switching to poll(): blocking read followed by 1 s sleep
+class LegacyGPSReader
+{
+public:
+    LegacyGPSReader(const std::string &devPath) : _stop(false)
+    {
+        _fd = open(devPath.c_str(), O_RDWR | O_NOCTTY);
+        struct termios options;
+        tcgetattr(_fd, &options);
+        options.c_lflag &= ~(ECHO | ECHONL | ICANON | ISIG | IEXTEN);
+        options.c_oflag &= ~(ONLCR | OCRNL);
+        tcsetattr(_fd, TCSANOW, &options);
+        _thread = std::thread(&LegacyGPSReader::run, this);
+    }
+
+    ~LegacyGPSReader()
+    {
+        _stop = true;
+        _thread.join();
+        close(_fd);
+    }
+
+    void getGPSInfo(sp::GPSInfo &gpsInfo)
+    {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        gpsInfo = _gpsInfo;
+    }
+
+private:
+    void run()
+    {
+        char buf[4096];
+        sp::NMEAParser parser;
+        while (!_stop)
+        {
+            struct pollfd pfd = { _fd, POLLIN, 0 };
+            if (poll(&pfd, 1, 100) <= 0)
+            {
+                continue;
+            }
+            int numRead = read(_fd, buf, sizeof(buf));
+            if (numRead > 0)
+            {
+                std::unique_lock<std::shared_mutex> lock(_mutex);
+                parser.parse(std::string(buf, numRead), _gpsInfo);
+            }
+            for (int i = 0; (i < 10) && !_stop; i++)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+        }
+    }
+
+    int _fd;
+    std::atomic<bool> _stop;
+    std::thread _thread;
+    sp::GPSInfo _gpsInfo;
+    std::shared_mutex _mutex;
+};
+
+// writes sentences to the pty master at the given period and measures the time until they are published
+template<typename Reader>
+std::vector<uint64_t> measure(int master, Reader &reader, int iterations, int periodMs, int &seq)
+{
+    std::vector<uint64_t> samples;
+
+    for (int i = 0; i < iterations; i++)
+    {
+        seq++;
+        std::string sentence = makeGGA(seq);
+        double expected = 56.0 + (((seq / 100000) % 60) + (seq % 100000) / 100000.0) / 60.0;
+
+        uint64_t start = spb::nowNs();
+        if (write(master, sentence.c_str(), sentence.length()) == -1)
+        {
+            break;
+        }
+
+        while (true)
+        {
+            sp::GPSInfo gpsInfo;
+            reader.getGPSInfo(gpsInfo);
+            if (std::abs(gpsInfo.latitude - expected) < 1e-9)
+            {
+                samples.push_back(spb::nowNs() - start);
+                break;
+            }
+            if (spb::nowNs() - start > 5000000000ULL)
+            {
+                break;
+            }
+            std::this_thread::yield();
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(periodMs));
+    }
+
+    return samples;
+}
+
+}
+
+// arrival-to-publish latency of the poll() based reader compared to the legacy read/sleep loop
+BENCHMARK(GPSArrivalToPublish)
+{
+    std::string slavePath;
+    int master = openPty(slavePath);
+    if (master == -1)
+    {
+        std::printf("  failed to open pty\n");
+        return;
+    }
+
+    int seq = 0;
+
+    {
+        sp::BN880GPSConfig config;
+        config.devPath = slavePath;
+        config.bufferSize = 4096;
+        config.maxRetries = 3;
+        config.rawOutput = "";
+        config.maxRawFileSize = 0;
+        config.rawSegments = 0;
+        config.rawTimestamps = false;
+        config.replayFile = "";
+        config.replaySpeed = 1.0;
+        config.protocol = "nmea";
+        config.measurementRate = 0;
+        config.baudRate = 0;
+        config.messages = {};
+        config.portBaudRate = 0;
+        config.vmin = 1;
+        config.vtime = 0;
+        config.lowLatency = false;
+
+        sp::BN880GPSReader reader(config);
+        reader.start();
+        spb::report("poll() reader, 10 Hz", measure(master, reader, 200, 100, seq));
+
+        uint64_t start = spb::nowNs();
+        reader.stop();
+        std::printf("  %-40s %.1fus\n", "poll() reader stop()", (spb::nowNs() - start) / 1000.0);
+    }
+
+    {
+        LegacyGPSReader reader(slavePath);
+        spb::report("read()/sleep(1 s) reader, 3.3 Hz", measure(master, reader, 10, 300, seq));
+    }
+
+    close(master);
+}
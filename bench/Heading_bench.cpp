@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Benchmark.hpp"
+#include "Heading.hpp"
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace sp = ship_position;
+namespace spb = ship_position_bench;
+
+namespace
+{
+
+const int ITERATIONS = 200;
+const size_t BATCH = 1000;
+
+// time per call over batches of field vectors as the sensor reports them
+template <typename Func>
+std::vector<uint64_t> measure(const std::vector<std::pair<double, double>> &vectors, Func func)
+{
+    std::vector<uint64_t> samples;
+    for (int i = 0; i < ITERATIONS; i++)
+    {
+        double sum = 0.0;
+        uint64_t start = spb::nowNs();
+        for (const auto &[y, x] : vectors)
+        {
+            sum += func(y, x);
+        }
+        samples.push_back((spb::nowNs() - start) / vectors.size());
+        spb::doNotOptimize(sum);
+    }
+    return samples;
+}
+
+}
+
+// heading trig: std::atan2 vs the polynomial approximation, and the full per sample heading
+BENCHMARK(HeadingTrig)
+{
+    std::mt19937 random(1);
+    std::uniform_int_distribution<int32_t> field(-8000, 8000);
+    std::vector<std::pair<double, double>> vectors;
+    std::vector<sp::MagnetometerData> samples;
+    for (size_t i = 0; i < BATCH; i++)
+    {
+        sp::MagnetometerData data;
+        data.x = field(random);
+        data.y = field(random);
+        samples.push_back(data);
+        vectors.push_back({static_cast<double>(data.y), static_cast<double>(data.x)});
+    }
+
+    double maxError = 0.0;
+    for (const auto &[y, x] : vectors)
+    {
+        maxError = std::max(maxError, std::fabs(sp::fastAtan2(y, x) - std::atan2(y, x)));
+    }
+
+    spb::report("std::atan2", measure(vectors, [](double y, double x) { return std::atan2(y, x); }), true);
+    spb::report("fastAtan2", measure(vectors, [](double y, double x) { return sp::fastAtan2(y, x); }), true);
+
+    sp::HeadingCalculator calculator(90.0, true, 11.5);
+    std::vector<uint64_t> headingSamples;
+    for (int i = 0; i < ITERATIONS; i++)
+    {
+        double sum = 0.0;
+        uint64_t start = spb::nowNs();
+        for (const sp::MagnetometerData &data : samples)
+        {
+            sum += calculator.compute(data).trueHeading;
+        }
+        headingSamples.push_back((spb::nowNs() - start) / samples.size());
+        spb::doNotOptimize(sum);
+    }
+    spb::report("HeadingCalculator::compute", headingSamples, true);
+    std::printf("  fastAtan2 max error %.2e rad (%.2e deg)\n", maxError, maxError * 180.0 / M_PI);
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Benchmark.hpp"
+#include "CalibrationCollector.hpp"
+#include "MagnetometerCalibration.hpp"
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace sp = ship_position;
+namespace spb = ship_position_bench;
+
+// ellipsoid fit, collector add() and solve(), and the correction applied to every sample
+BENCHMARK(CalibrationFit)
+{
+    std::mt19937 random(3);
+    std::normal_distribution<double> gauss(0.0, 1.0);
+    std::vector<sp::MagnetometerData> samples;
+    for (size_t i = 0; i < 4096; i++)
+    {
+        double v[3] = {gauss(random), gauss(random), gauss(random)};
+        double norm = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]) / 3000.0;
+        sp::MagnetometerData data;
+        data.x = std::lround(1.2 * v[0] / norm + 0.1 * v[1] / norm + 420.0);
+        data.y = std::lround(0.85 * v[1] / norm - 310.0);
+        data.z = std::lround(v[2] / norm + 150.0);
+        samples.push_back(data);
+    }
+
+    sp::MagnetometerCalibration calibration;
+    std::vector<uint64_t> fitSamples;
+    for (int i = 0; i < 50; i++)
+    {
+        uint64_t start = spb::nowNs();
+        bool ok = sp::fitEllipsoid(samples, calibration);
+        fitSamples.push_back(spb::nowNs() - start);
+        spb::doNotOptimize(ok);
+    }
+    spb::report("fitEllipsoid, 4096 samples", fitSamples);
+
+    // most samples are accepted while the cells fill up
+    sp::CalibrationCollector collector(0.75, 0.015);
+    std::vector<uint64_t> collectSamples;
+    for (const sp::MagnetometerData &data : samples)
+    {
+        uint64_t start = spb::nowNs();
+        bool accepted = collector.add(data.x, data.y, data.z, data.temperature);
+        uint64_t end = spb::nowNs();
+        if (accepted)
+        {
+            collectSamples.push_back(end - start);
+        }
+    }
+    spb::report("CalibrationCollector::add, accepted", collectSamples, true);
+
+    std::vector<uint64_t> solveSamples;
+    for (int i = 0; i < 50; i++)
+    {
+        uint64_t start = spb::nowNs();
+        collector.solve();
+        solveSamples.push_back(spb::nowNs() - start);
+    }
+    spb::doNotOptimize(collector.snapshot().status.complete);
+    spb::report("CalibrationCollector::solve", solveSamples, true);
+
+    std::vector<uint64_t> applySamples;
+    for (int i = 0; i < 200; i++)
+    {
+        sp::MagnetometerData corrected;
+        int64_t sum = 0;
+        uint64_t start = spb::nowNs();
+        for (const sp::MagnetometerData &data : samples)
+        {
+            calibration.apply(data.x, data.y, data.z, data.temperature, corrected);
+            sum += corrected.x;
+        }
+        applySamples.push_back((spb::nowNs() - start) / samples.size());
+        spb::doNotOptimize(sum);
+    }
+    spb::report("MagnetometerCalibration::apply", applySamples, true);
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Benchmark.hpp"
+#include "NMEAParser.hpp"
+#include <string>
+#include <vector>
+
+namespace sp = ship_position;
+namespace spb = ship_position_bench;
+
+namespace
+{
+
+// sentences recorded from a BN-880 receiver
+const std::vector<std::string> corpus = {
+    "$GNRMC,170257.00,A,5619.06488,N,04401.12281,E,0.071,,300324,,,A*68",
+    "$GNVTG,,T,,M,0.071,N,0.131,K,A*38",
+    "$GNGGA,170257.00,5619.06488,N,04401.12281,E,1,09,1.36,124.2,M,6.3,M,,*79",
+    "$GNGSA,A,3,02,23,10,14,22,32,21,,,,,,2.67,1.36,2.29*17",
+    "$GNGSA,A,3,78,85,,,,,,,,,,,2.67,1.36,2.29*10",
+    "$GPGSV,3,1,09,02,27,297,26,10,72,079,34,14,11,333,27,18,00,120,*79",
+    "$GPGSV,3,2,09,21,44,293,31,22,07,352,27,23,33,074,36,24,19,052,*70",
+    "$GPGSV,3,3,09,32,50,156,28*4C",
+    "$GLGSV,3,1,10,69,12,039,,70,75,070,17,71,46,206,22,72,01,214,*67",
+    "$GLGSV,3,2,10,77,04,303,,78,17,357,30,79,07,045,,85,48,146,18*69",
+    "$GLGSV,3,3,10,86,74,300,23,87,20,314,*60",
+    "$GNGLL,5619.06488,N,04401.12281,E,170257.00,A,A*71"
+};
+
+// coordinate fields of the corpus
+const std::vector<std::pair<std::string, std::string>> coordinates = {
+    {"5619.06488", "N"}, {"04401.12281", "E"}, {"5619.06490", "N"}, {"04401.12277", "E"},
+    {"5619.06501", "N"}, {"04401.12263", "E"}, {"5619.06512", "N"}, {"04401.12250", "E"}
+};
+
+// the conversion as it was done before switching to from_chars
+double legacyParseCoordinates(const std::string &digits, const std::string &direction)
+{
+    std::string trimmedDigits = digits.substr(digits.find_first_not_of("0"));
+    double coordinates = std::stod(trimmedDigits.substr(0, 2)) + (std::stod(trimmedDigits.substr(2)) / 60);
+    if ((direction == "S") || (direction == "W"))
+    {
+        coordinates *= -1;
+    }
+
+    return coordinates;
+}
+
+class NMEAParserAdapter : public sp::NMEAParser
+{
+public:
+    using NMEAParser::parseCoordinates;
+};
+
+const int ITERATIONS = 200000;
+
+}
+
+// coordinate conversion: std::stod on substrings vs from_chars
+BENCHMARK(NMEACoordinates)
+{
+    std::vector<uint64_t> legacy;
+    std::vector<uint64_t> current;
+
+    for (int round = 0; round < 10; round++)
+    {
+        uint64_t start = spb::nowNs();
+        for (int i = 0; i < ITERATIONS; i++)
+        {
+            auto &c = coordinates[i % coordinates.size()];
+            spb::doNotOptimize(legacyParseCoordinates(c.first, c.second));
+        }
+        legacy.push_back((spb::nowNs() - start) / ITERATIONS);
+
+        start = spb::nowNs();
+        for (int i = 0; i < ITERATIONS; i++)
+        {
+            auto &c = coordinates[i % coordinates.size()];
+            double value = 0.0;
+            NMEAParserAdapter::parseCoordinates(c.first, c.second, value);
+            spb::doNotOptimize(value);
+        }
+        current.push_back((spb::nowNs() - start) / ITERATIONS);
+    }
+
+    spb::report("stod, per call", legacy, true);
+    spb::report("from_chars, per call", current, true);
+}
+
+// full parse of the corpus, one sentence at a time
+BENCHMARK(NMEASentences)
+{
+    sp::NMEAParser parser;
+    sp::GPSInfo gpsInfo;
+    std::vector<uint64_t> samples;
+
+    for (int round = 0; round < 10; round++)
+    {
+        uint64_t start = spb::nowNs();
+        for (int i = 0; i < ITERATIONS; i++)
+        {
+            parser.parseSentence(corpus[i % corpus.size()], gpsInfo);
+        }
+        samples.push_back((spb::nowNs() - start) / ITERATIONS);
+        spb::doNotOptimize(gpsInfo);
+    }
+
+    spb::report("parseSentence(), per sentence", samples, true);
+}
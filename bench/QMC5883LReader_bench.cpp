@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Benchmark.hpp"
+#include "QMC5883LReader.hpp"
+#include "sim/SimulatedQMC5883L.hpp"
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace sp = ship_position;
+namespace spb = ship_position_bench;
+
+// simulated chip at 200 Hz: measurements read, their age in the chip and time to publish
+BENCHMARK(MagnetometerThroughput)
+{
+    const int seconds = 2;
+
+    sp::SimulatedQMC5883LConfig deviceConfig;
+    deviceConfig.noise = 20.0;
+    sp::SimulatedQMC5883L device(deviceConfig);
+    std::vector<uint64_t> readDelays;
+    readDelays.reserve(1000 * seconds);
+    device.setDataReadCallback([&readDelays](uint64_t delay) { readDelays.push_back(delay); });
+
+    sp::QMC5883LConfig config;
+    config.devPath = "simulated";
+    config.pollTimeout = 10;
+    config.outputDataRate = 200;
+    config.fieldRange = 2;
+    config.oversampling = 512;
+    config.filter = "median";
+    config.filterWindow = 5;
+    config.filterAlpha = 0.2;
+    config.mountingRotation = 0.0;
+    config.mountingFlipped = false;
+    config.declination = 11.5;
+    config.calibrationFile = "";
+    config.calibrationMinCoverage = 0.5;
+    config.calibrationMaxResidual = 0.02;
+    sp::QMC5883LReader reader(config, device);
+
+    reader.start();
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    reader.stop();
+
+    sp::MagnetometerStatistics statistics;
+    reader.getMagnetometerStatistics(statistics);
+    std::vector<sp::MagnetometerData> samples;
+    reader.getMagnetometerSamples(sp::QMC5883LReader::SAMPLE_RING_CAPACITY, samples);
+    std::vector<uint64_t> publishDelays;
+    for (const sp::MagnetometerData &data : samples)
+    {
+        publishDelays.push_back(data.publishNs - data.arrivalNs);
+    }
+
+    spb::report("measurement to read", readDelays);
+    spb::report("read to publish", publishDelays, true);
+    uint64_t measurements = device.measurements();
+    std::printf("  measurements %llu, samples %llu (%.1f%%), dropped %llu, duplicate polls %llu, read errors %llu\n",
+        static_cast<unsigned long long>(measurements), static_cast<unsigned long long>(statistics.samples),
+        measurements ? 100.0 * statistics.samples / measurements : 0.0,
+        static_cast<unsigned long long>(statistics.dropped), static_cast<unsigned long long>(statistics.duplicates),
+        static_cast<unsigned long long>(statistics.readErrors));
+}
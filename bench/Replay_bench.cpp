@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Benchmark.hpp"
+#include "BN880GPSReader.hpp"
+#include <stdlib.h>
+#include <unistd.h>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sp = ship_position;
+namespace spb = ship_position_bench;
+
+namespace
+{
+
+// one epoch of BN-880 output at factory settings
+const char *EPOCH =
+    "$GNRMC,170257.00,A,5619.06488,N,04401.12281,E,0.071,,300324,,,A*68\r\n"
+    "$GNVTG,,T,,M,0.071,N,0.131,K,A*38\r\n"
+    "$GNGGA,170257.00,5619.06488,N,04401.12281,E,1,09,1.36,124.2,M,6.3,M,,*79\r\n"
+    "$GNGSA,A,3,02,23,10,14,22,32,21,,,,,,2.67,1.36,2.29*17\r\n"
+    "$GNGSA,A,3,78,85,,,,,,,,,,,2.67,1.36,2.29*10\r\n"
+    "$GPGSV,3,1,09,02,27,297,26,10,72,079,34,14,11,333,27,18,00,120,*79\r\n"
+    "$GPGSV,3,2,09,21,44,293,31,22,07,352,27,23,33,074,36,24,19,052,*70\r\n"
+    "$GPGSV,3,3,09,32,50,156,28*4C\r\n"
+    "$GLGSV,3,1,10,69,12,039,,70,75,070,17,71,46,206,22,72,01,214,*67\r\n"
+    "$GLGSV,3,2,10,77,04,303,,78,17,357,30,79,07,045,,85,48,146,18*69\r\n"
+    "$GLGSV,3,3,10,86,74,300,23,87,20,314,*60\r\n"
+    "$GNGLL,5619.06488,N,04401.12281,E,170257.00,A,A*71\r\n";
+
+const int EPOCHS = 20000;
+const int RUNS = 5;
+
+}
+
+// whole pipeline fed from a recording at max speed: stream parser, NMEA parser, GPSInfo updates
+BENCHMARK(ReplayThroughput)
+{
+    char path[] = "/tmp/replay_benchXXXXXX";
+    int fd = mkstemp(path);
+    if (fd == -1)
+    {
+        std::printf("  failed to create replay file\n");
+        return;
+    }
+    close(fd);
+    {
+        std::ofstream file(path, std::ios::binary);
+        for (int i = 0; i < EPOCHS; i++)
+        {
+            file << EPOCH;
+        }
+    }
+
+    sp::BN880GPSConfig config;
+    config.devPath = "";
+    config.bufferSize = 4096;
+    config.maxRetries = 3;
+    config.rawOutput = "";
+    config.maxRawFileSize = 0;
+    config.rawSegments = 0;
+    config.rawTimestamps = false;
+    config.replayFile = path;
+    config.replaySpeed = 0.0;
+    config.protocol = "nmea";
+    config.measurementRate = 0;
+    config.baudRate = 0;
+    config.messages = {};
+    config.portBaudRate = 0;
+    config.vmin = 1;
+    config.vtime = 0;
+    config.lowLatency = false;
+
+    std::vector<uint64_t> perEpoch;
+    double megabytesPerSecond = 0.0;
+    for (int run = 0; run < RUNS; run++)
+    {
+        sp::BN880GPSReader reader(config);
+        reader.start();
+        sp::ReplayStatistics statistics;
+        do
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            reader.getReplayStatistics(statistics);
+        }
+        while (!statistics.finished);
+        reader.stop();
+
+        perEpoch.push_back(statistics.elapsedNs / EPOCHS);
+        megabytesPerSecond = std::max(megabytesPerSecond, statistics.bytes * 1e3 / statistics.elapsedNs);
+    }
+
+    spb::report("replay, per 12-sentence epoch", perEpoch, true);
+    std::printf("  %-40s %.2f MB/s\n", "replay, best throughput", megabytesPerSecond);
+    unlink(path);
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Benchmark.hpp"
+#include "GPSReader.hpp"
+#include "Seqlock.hpp"
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+namespace sp = ship_position;
+namespace spb = ship_position_bench;
+
+namespace
+{
+
+// publication as it was done before the seqlock: a copy guarded by a shared_mutex
+template <typename T>
+class SharedMutexSnapshot
+{
+public:
+    void store(const T &value)
+    {
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        _value = value;
+    }
+
+    void load(T &value)
+    {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        value = _value;
+    }
+
+private:
+    T _value;
+    std::shared_mutex _mutex;
+};
+
+const int RUN_MS = 300;
+// the writer publishes a fix every WRITER_PERIOD_US, as a receiver at a high rate with bursts of reads would
+const int WRITER_PERIOD_US = 20;
+// per thread, to keep memory bounded
+const size_t MAX_SAMPLES = 200000;
+
+// one writer publishing GPSInfo and numReaders threads polling it as fast as they can
+template <typename Snapshot>
+void contention(const char *name, int numReaders)
+{
+    Snapshot snapshot;
+    std::atomic<bool> done(false);
+    std::vector<std::vector<uint64_t>> readerSamples(numReaders);
+    std::vector<uint64_t> writerSamples;
+    writerSamples.reserve(MAX_SAMPLES);
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < numReaders; r++)
+    {
+        readers.emplace_back([&snapshot, &done, &samples = readerSamples[r]]()
+        {
+            samples.reserve(MAX_SAMPLES);
+            while (!done)
+            {
+                sp::GPSInfo gpsInfo;
+                uint64_t start = spb::nowNs();
+                snapshot.load(gpsInfo);
+                uint64_t elapsed = spb::nowNs() - start;
+                spb::doNotOptimize(gpsInfo);
+                if (samples.size() < MAX_SAMPLES)
+                {
+                    samples.push_back(elapsed);
+                }
+            }
+        });
+    }
+
+    sp::GPSInfo gpsInfo;
+    uint64_t end = spb::nowNs() + RUN_MS * 1000000ULL;
+    uint64_t next = spb::nowNs();
+    while (next < end)
+    {
+        while (spb::nowNs() < next)
+        {
+        }
+        gpsInfo.latitude += 1e-7;
+        gpsInfo.arrivalNs = next;
+        uint64_t start = spb::nowNs();
+        snapshot.store(gpsInfo);
+        if (writerSamples.size() < MAX_SAMPLES)
+        {
+            writerSamples.push_back(spb::nowNs() - start);
+        }
+        next += WRITER_PERIOD_US * 1000ULL;
+    }
+    done = true;
+
+    std::vector<uint64_t> samples;
+    for (int r = 0; r < numReaders; r++)
+    {
+        readers[r].join();
+        samples.insert(samples.end(), readerSamples[r].begin(), readerSamples[r].end());
+    }
+
+    char label[64];
+    std::snprintf(label, sizeof(label), "%s read, %d readers", name, numReaders);
+    spb::report(label, samples, true);
+    std::snprintf(label, sizeof(label), "%s publish, %d readers", name, numReaders);
+    spb::report(label, writerSamples, true);
+}
+
+}
+
+// GPSInfo publication under reader contention: shared_mutex vs seqlock
+BENCHMARK(SnapshotContention)
+{
+    for (int numReaders : {1, 4, 16})
+    {
+        contention<SharedMutexSnapshot<sp::GPSInfo>>("shared_mutex", numReaders);
+        contention<sp::Seqlock<sp::GPSInfo>>("seqlock", numReaders);
+    }
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Benchmark.hpp"
+#include <cstring>
+
+namespace spb = ship_position_bench;
+
+// runs all registered benchmarks or only those, whose names are given on the command line
+int main(int argc, char *argv[])
+{
+    for (auto &entry : spb::Benchmarks::entries())
+    {
+        bool selected = (argc < 2);
+        for (int i = 1; i < argc; i++)
+        {
+            if (entry.name == argv[i])
+            {
+                selected = true;
+            }
+        }
+
+        if (selected)
+        {
+            std::printf("[ %s ]\n", entry.name.c_str());
+            entry.func();
+        }
+    }
+
+    return 0;
+}
+
+// ShipPosition.cpp refers to the daemon's signal handler, defined in main.cpp
+void signal_handler(int) {}
@@ -0,0 +1,438 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GPSSimulator.hpp"
+#include "NMEAChecksum.hpp"
+#include "UBXParser.hpp"
+#include "Clock.hpp"
+#include <fcntl.h>
+#include <errno.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+
+namespace ship_position
+{
+
+namespace
+{
+
+constexpr double EARTH_RADIUS = 6371000.0;
+constexpr double METERS_PER_KNOT_SECOND = 0.514444;
+constexpr double PI = 3.14159265358979323846;
+
+// ddmm.mmmmm or dddmm.mmmmm with hemisphere
+void formatCoordinate(double value, int degreeDigits, char positive, char negative, char *out, size_t size,
+    char &hemisphere)
+{
+    hemisphere = (value < 0.0) ? negative : positive;
+    // rounded to the printed precision first, so that minutes never read 60
+    long long hundredThousandths = std::llround(std::fabs(value) * 60.0 * 100000.0);
+    long long degrees = hundredThousandths / (60LL * 100000LL);
+    double minutes = (hundredThousandths % (60LL * 100000LL)) / 100000.0;
+    std::snprintf(out, size, "%0*lld%08.5f", degreeDigits, degrees, minutes);
+}
+
+void putU2(std::string &payload, size_t offset, uint16_t value)
+{
+    payload[offset] = static_cast<char>(value & 0xff);
+    payload[offset + 1] = static_cast<char>(value >> 8);
+}
+
+void putI4(std::string &payload, size_t offset, int32_t value)
+{
+    uint32_t v = static_cast<uint32_t>(value);
+    for (int i = 0; i < 4; i++)
+    {
+        payload[offset + i] = static_cast<char>((v >> (8 * i)) & 0xff);
+    }
+}
+
+}
+
+GPSSimulator::GPSSimulator(const GPSSimulatorConfig &config) :
+    _config(config),
+    _master(-1),
+    _slave(-1),
+    _eventfd(-1),
+    _random(config.seed),
+    _leg(0),
+    _legTime(0.0),
+    _epochs(0),
+    _corrupted(0),
+    _split(0),
+    _overruns(0)
+{
+    _log = Log::getInstance();
+
+    if (_config.track.empty())
+    {
+        _config.track.push_back({1.0, 0.0, 0.0, 0.0});
+    }
+    _state.latitude = _config.startLatitude;
+    _state.longitude = _config.startLongitude;
+    _state.speedKnots = _config.track[0].speedKnots;
+    _state.course = _config.track[0].course;
+
+    _eventfd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    _master = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if ((_master == -1) || (grantpt(_master) == -1) || (unlockpt(_master) == -1))
+    {
+        _log->write(LogLevel::ERROR, "GPSSimulator failed to create pty, error=%d\n", errno);
+        if (_master != -1)
+        {
+            close(_master);
+            _master = -1;
+        }
+        return;
+    }
+    _slavePath = ptsname(_master);
+
+    // the slave is kept open, so that line settings and buffered data survive reader restarts
+    _slave = open(_slavePath.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (_slave != -1)
+    {
+        struct termios options;
+        tcgetattr(_slave, &options);
+        cfmakeraw(&options);
+        tcsetattr(_slave, TCSANOW, &options);
+    }
+}
+
+GPSSimulator::~GPSSimulator()
+{
+    if (_slave != -1)
+    {
+        close(_slave);
+    }
+    if (_master != -1)
+    {
+        close(_master);
+    }
+    if (_eventfd != -1)
+    {
+        close(_eventfd);
+    }
+    Log::release();
+}
+
+void GPSSimulator::run()
+{
+    _log->write(LogLevel::DEBUG, "GPSSimulator::run(), %s\n", _slavePath.c_str());
+    if (!isOk() || (_config.rate <= 0.0))
+    {
+        return;
+    }
+
+    uint64_t start = monotonicNs();
+    uint64_t period = static_cast<uint64_t>(1e9 / _config.rate);
+    bool saturated = false;
+
+    for (uint64_t epoch = 0; ; epoch++)
+    {
+        uint64_t epochStart = start + epoch * period;
+        if (!waitUntil(epochStart))
+        {
+            break;
+        }
+        if (!saturated && (monotonicNs() > epochStart + period))
+        {
+            saturated = true;
+            _log->write(LogLevel::ERROR, "GPSSimulator: epochs don't fit into %u baud at %.1f Hz\n",
+                _config.baudRate, _config.rate);
+        }
+
+        std::uniform_real_distribution<double> probability(0.0, 1.0);
+        uint64_t lineTime = epochStart;
+        uint64_t firstWrite = 0;
+        bool stopped = false;
+        for (const std::string &part : makeEpoch())
+        {
+            // a sentence becomes available when its last byte is on the wire
+            if (_config.baudRate != 0)
+            {
+                lineTime += part.length() * 10ULL * 1000000000ULL / _config.baudRate;
+                if (!waitUntil(lineTime))
+                {
+                    stopped = true;
+                    break;
+                }
+            }
+
+            if (firstWrite == 0)
+            {
+                firstWrite = monotonicNs();
+            }
+            if ((part.length() > 1) && (probability(_random) < _config.splitProbability))
+            {
+                std::uniform_int_distribution<size_t> cut(1, part.length() - 1);
+                size_t length = cut(_random);
+                _split++;
+                writeAll(part.data(), length);
+                if (!waitUntil(monotonicNs() + _config.splitDelayUs * 1000ULL))
+                {
+                    stopped = true;
+                    break;
+                }
+                writeAll(part.data() + length, part.length() - length);
+            }
+            else
+            {
+                writeAll(part.data(), part.length());
+            }
+        }
+        if (stopped)
+        {
+            break;
+        }
+
+        _epochs++;
+        if (_onEpoch)
+        {
+            _onEpoch(epoch, firstWrite);
+        }
+        advance();
+    }
+
+    _log->write(LogLevel::DEBUG, "GPSSimulator::run() stopping\n");
+}
+
+void GPSSimulator::stop()
+{
+    if (_eventfd != -1)
+    {
+        uint64_t value = 1;
+        write(_eventfd, &value, sizeof(value));
+    }
+
+    SingleThread::stop();
+
+    if (_eventfd != -1)
+    {
+        uint64_t value;
+        read(_eventfd, &value, sizeof(value));
+    }
+}
+
+bool GPSSimulator::waitUntil(uint64_t deadlineNs)
+{
+    uint64_t now = monotonicNs();
+    struct timespec timeout = {0, 0};
+    if (deadlineNs > now)
+    {
+        timeout.tv_sec = (deadlineNs - now) / 1000000000ULL;
+        timeout.tv_nsec = (deadlineNs - now) % 1000000000ULL;
+    }
+
+    struct pollfd pfd;
+    pfd.fd = _eventfd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    return !((ppoll(&pfd, 1, &timeout, nullptr) > 0) && (pfd.revents & POLLIN));
+}
+
+void GPSSimulator::writeAll(const char *data, size_t length)
+{
+    while (length > 0)
+    {
+        ssize_t written = write(_master, data, length);
+        if (written == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            // nobody reads the slave fast enough
+            _overruns += length;
+            return;
+        }
+        data += written;
+        length -= written;
+    }
+}
+
+void GPSSimulator::advance()
+{
+    double dt = 1.0 / _config.rate;
+    const SimulatorTrackLeg &leg = _config.track[_leg];
+
+    double distance = _state.speedKnots * METERS_PER_KNOT_SECOND * dt;
+    double course = _state.course * PI / 180.0;
+    double latitude = _state.latitude * PI / 180.0;
+    _state.latitude += distance * std::cos(course) / EARTH_RADIUS * 180.0 / PI;
+    _state.longitude += distance * std::sin(course) / (EARTH_RADIUS * std::cos(latitude)) * 180.0 / PI;
+    _state.course = std::fmod(_state.course + leg.turnRate * dt + 360.0, 360.0);
+
+    _legTime += dt;
+    if (_legTime >= leg.duration)
+    {
+        _leg = (_leg + 1) % _config.track.size();
+        _legTime = 0.0;
+        _state.speedKnots = _config.track[_leg].speedKnots;
+        _state.course = _config.track[_leg].course;
+    }
+}
+
+std::vector<std::string> GPSSimulator::makeEpoch()
+{
+    std::vector<std::string> parts;
+
+    // time of day from the epoch number, in hundredths of a second
+    long long centiseconds = std::llround((_epochs / _config.rate) * 100.0) + START_HOURS * 360000LL;
+    int hours = (centiseconds / 360000) % 24;
+    int minutes = (centiseconds / 6000) % 60;
+    double seconds = (centiseconds % 6000) / 100.0;
+
+    double latitude = _state.latitude;
+    double longitude = _state.longitude;
+    if (_config.positionNoise > 0.0)
+    {
+        std::normal_distribution<double> noise(0.0, _config.positionNoise);
+        latitude += noise(_random) / EARTH_RADIUS * 180.0 / PI;
+        longitude += noise(_random) / (EARTH_RADIUS * std::cos(latitude * PI / 180.0)) * 180.0 / PI;
+    }
+
+    if (_config.nmea)
+    {
+        char time[16];
+        std::snprintf(time, sizeof(time), "%02d%02d%05.2f", hours, minutes, seconds);
+        char lat[16];
+        char lon[16];
+        char ns;
+        char ew;
+        formatCoordinate(latitude, 2, 'N', 'S', lat, sizeof(lat), ns);
+        formatCoordinate(longitude, 3, 'E', 'W', lon, sizeof(lon), ew);
+        double speedKm = _state.speedKnots * 1.852;
+
+        char body[128];
+        std::snprintf(body, sizeof(body), "GPGGA,%s,%s,%c,%s,%c,1,10,0.90,%.1f,M,0.0,M,,", time, lat, ns, lon, ew,
+            _config.altitude);
+        parts.push_back(makeSentence(body));
+        std::snprintf(body, sizeof(body), "GPVTG,%.1f,T,,M,%.3f,N,%.3f,K,A", _state.course, _state.speedKnots,
+            speedKm);
+        parts.push_back(makeSentence(body));
+        std::snprintf(body, sizeof(body), "GPRMC,%s,A,%s,%c,%s,%c,%.3f,%.1f,161026,,,A", time, lat, ns, lon, ew,
+            _state.speedKnots, _state.course);
+        parts.push_back(makeSentence(body));
+    }
+
+    if (_config.ubx)
+    {
+        parts.push_back(makeNavPVT(latitude, longitude, hours, minutes, seconds));
+    }
+
+    std::uniform_real_distribution<double> probability(0.0, 1.0);
+    for (std::string &part : parts)
+    {
+        if ((part.length() > 8) && (probability(_random) < _config.corruptProbability))
+        {
+            // one character of the body, the framing is left intact
+            std::uniform_int_distribution<size_t> position(6, part.length() - 6);
+            char &c = part[position(_random)];
+            c = ((c >= '0') && (c <= '9')) ? static_cast<char>('0' + (c - '0' + 1) % 10) : static_cast<char>(c ^ 0x01);
+            if ((c == '*') || (c == '$') || (c == '\r') || (c == '\n'))
+            {
+                c = 'X';
+            }
+            _corrupted++;
+        }
+    }
+
+    return parts;
+}
+
+std::string GPSSimulator::makeSentence(const char *body)
+{
+    std::string sentence = "$";
+    sentence += body;
+    char checksum[8];
+    std::snprintf(checksum, sizeof(checksum), "*%02X\r\n", nmeaChecksum(body, sentence.length() - 1));
+    return sentence + checksum;
+}
+
+std::string GPSSimulator::makeNavPVT(double latitude, double longitude, int hours, int minutes, double seconds)
+{
+    std::string payload(92, '\0');
+    putU2(payload, 4, 2026);
+    payload[6] = 10;
+    payload[7] = 16;
+    payload[8] = static_cast<char>(hours);
+    payload[9] = static_cast<char>(minutes);
+    payload[10] = static_cast<char>(static_cast<int>(seconds));
+    // valid date and time
+    payload[11] = 0x03;
+    putI4(payload, 16, static_cast<int32_t>(std::llround((seconds - static_cast<int>(seconds)) * 1e9)));
+    // 3D fix, gnssFixOK
+    payload[20] = 3;
+    payload[21] = 0x01;
+    payload[23] = 10;
+    putI4(payload, 24, static_cast<int32_t>(std::llround(longitude * 1e7)));
+    putI4(payload, 28, static_cast<int32_t>(std::llround(latitude * 1e7)));
+    putI4(payload, 36, static_cast<int32_t>(std::llround(_config.altitude * 1000.0)));
+    putI4(payload, 60, static_cast<int32_t>(std::llround(_state.speedKnots * METERS_PER_KNOT_SECOND * 1000.0)));
+    putI4(payload, 64, static_cast<int32_t>(std::llround(_state.course * 1e5)));
+    putU2(payload, 76, 150);
+
+    std::vector<uint8_t> frame = UBXParser::makeFrame(UBXParser::CLASS_NAV, UBXParser::ID_NAV_PVT,
+        std::vector<uint8_t>(payload.begin(), payload.end()));
+    return std::string(frame.begin(), frame.end());
+}
+
+bool GPSSimulator::loadTrack(const std::string &path, std::vector<SimulatorTrackLeg> &track)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        return false;
+    }
+
+    track.clear();
+    std::string line;
+    while (std::getline(file, line))
+    {
+        line = line.substr(0, line.find('#'));
+        std::istringstream stream(line);
+        SimulatorTrackLeg leg;
+        if (stream >> leg.duration >> leg.speedKnots >> leg.course >> leg.turnRate)
+        {
+            track.push_back(leg);
+        }
+        else if (line.find_first_not_of(" \t\r") != std::string::npos)
+        {
+            return false;
+        }
+    }
+    return !track.empty();
+}
+
+uint64_t GPSSimulator::epochFromTime(double rate, int hours, int minutes, double seconds)
+{
+    double time = (hours - START_HOURS) * 3600.0 + minutes * 60.0 + seconds;
+    return static_cast<uint64_t>(std::llround(time * rate));
+}
+
+}
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GPSSIMULATOR_HPP
+#define GPSSIMULATOR_HPP
+
+#include "SingleThread.hpp"
+#include "Log.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace ship_position
+{
+
+// part of a scripted track, the track is repeated from the start when it ends
+struct SimulatorTrackLeg
+{
+    // seconds
+    double duration;
+    double speedKnots;
+    // course over ground at the start of the leg, degrees true
+    double course;
+    // degrees per second, positive turns starboard
+    double turnRate;
+};
+
+struct GPSSimulatorConfig
+{
+    double startLatitude;
+    double startLongitude;
+    double altitude;
+    std::vector<SimulatorTrackLeg> track;
+    // epochs per second
+    double rate;
+    // bytes are paced as on a 8N1 line at this speed, 0 writes every epoch at once
+    uint32_t baudRate;
+    // GGA, VTG and RMC sentences
+    bool nmea;
+    // NAV-PVT messages
+    bool ubx;
+    // standard deviation of reported position around the track, meters
+    double positionNoise;
+    // probability of a sentence having a corrupted character
+    double corruptProbability;
+    // probability of a sentence being written in two parts with splitDelayUs in between
+    double splitProbability;
+    uint32_t splitDelayUs;
+    uint32_t seed;
+
+    GPSSimulatorConfig()
+    {
+        startLatitude = 56.317748;
+        startLongitude = 44.0187135;
+        altitude = 124.2;
+        track = {{60.0, 10.0, 90.0, 0.0}, {36.0, 10.0, 90.0, 5.0}};
+        rate = 1.0;
+        baudRate = 9600;
+        nmea = true;
+        ubx = false;
+        positionNoise = 0.0;
+        corruptProbability = 0.0;
+        splitProbability = 0.0;
+        splitDelayUs = 5000;
+        seed = 1;
+    }
+};
+
+// emits synthetic receiver output into a pseudo-terminal, BN880GPSReader reads slavePath()
+class GPSSimulator : public SingleThread
+{
+public:
+    // called after an epoch was written, with the CLOCK_MONOTONIC nanoseconds of its first sentence
+    typedef std::function<void(uint64_t epoch, uint64_t timestampNs)> EpochCallback;
+
+    // UTC time of day of epoch 0, later epochs are 1/rate seconds apart
+    static constexpr int START_HOURS = 12;
+
+    GPSSimulator(const GPSSimulatorConfig &config);
+    virtual ~GPSSimulator();
+
+    virtual void run();
+    virtual void stop();
+
+    bool isOk() const { return _master != -1; }
+    const std::string &slavePath() const { return _slavePath; }
+    void setEpochCallback(EpochCallback callback) { _onEpoch = callback; }
+
+    uint64_t epochs() const { return _epochs; }
+    uint64_t corrupted() const { return _corrupted; }
+    uint64_t split() const { return _split; }
+    // bytes dropped because the pty was full
+    uint64_t overruns() const { return _overruns; }
+
+    // reads legs from a text file, one "duration speedKnots course turnRate" per line, # starts a comment
+    static bool loadTrack(const std::string &path, std::vector<SimulatorTrackLeg> &track);
+    // epoch number the UTC time of a simulated fix belongs to
+    static uint64_t epochFromTime(double rate, int hours, int minutes, double seconds);
+
+protected:
+    struct State
+    {
+        double latitude;
+        double longitude;
+        double speedKnots;
+        double course;
+    };
+
+    // moves the true position along the track by one epoch
+    void advance();
+    // sentences and messages of the current epoch, noise and corruption included
+    std::vector<std::string> makeEpoch();
+    std::string makeSentence(const char *body);
+    std::string makeNavPVT(double latitude, double longitude, int hours, int minutes, double seconds);
+    // returns false if stop was requested before the deadline
+    bool waitUntil(uint64_t deadlineNs);
+    void writeAll(const char *data, size_t length);
+
+    GPSSimulatorConfig _config;
+    Log *_log;
+    int _master;
+    int _slave;
+    int _eventfd;
+    std::string _slavePath;
+    EpochCallback _onEpoch;
+    std::mt19937 _random;
+    State _state;
+    size_t _leg;
+    double _legTime;
+    std::atomic<uint64_t> _epochs;
+    std::atomic<uint64_t> _corrupted;
+    std::atomic<uint64_t> _split;
+    std::atomic<uint64_t> _overruns;
+};
+
+}
+
+#endif // GPSSIMULATOR_HPP
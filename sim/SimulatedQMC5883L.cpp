@@ -0,0 +1,266 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "SimulatedQMC5883L.hpp"
+#include "Clock.hpp"
+#include <errno.h>
+#include <algorithm>
+#include <cmath>
+
+namespace ship_position
+{
+
+namespace
+{
+
+constexpr double PI = 3.14159265358979323846;
+
+constexpr uint8_t REG_STATUS = 0x06;
+constexpr uint8_t REG_TEMPERATURE = 0x07;
+constexpr uint8_t REG_CONTROL_1 = 0x09;
+constexpr uint8_t REG_CONTROL_2 = 0x0A;
+constexpr uint8_t REG_SET_RESET_PERIOD = 0x0B;
+constexpr uint8_t STATUS_DRDY = 0x01;
+constexpr uint8_t STATUS_OVL = 0x02;
+constexpr uint8_t STATUS_DOR = 0x04;
+constexpr uint8_t CONTROL_1_MODE_MASK = 0x03;
+constexpr uint8_t MODE_CONTINUOUS = 0x01;
+constexpr uint8_t CONTROL_1_RANGE_8G = 0x10;
+constexpr uint8_t CONTROL_2_ROL_PNT = 0x40;
+constexpr uint8_t CONTROL_2_SOFT_RST = 0x80;
+// indexed by the ODR bits of control register 1
+constexpr uint64_t OUTPUT_DATA_RATES[] = {10, 50, 100, 200};
+// LSB per gauss
+constexpr double SENSITIVITY_2G = 12000.0;
+constexpr double SENSITIVITY_8G = 3000.0;
+constexpr double TEMPERATURE_LSB_PER_DEGREE = 100.0;
+
+}
+
+SimulatedQMC5883L::SimulatedQMC5883L(const SimulatedQMC5883LConfig &config) :
+_config(config),
+_clock(monotonicNs),
+_random(config.seed),
+_noise(0.0, 1.0),
+_failTransfers(0),
+_startNs(0),
+_measurement(0),
+_readMeasurement(0)
+{
+    std::fill(_registers, _registers + NUM_REGISTERS, 0);
+    _registers[REG_CHIP_ID] = CHIP_ID;
+}
+
+bool SimulatedQMC5883L::writeRegister(uint8_t reg, uint8_t value)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if ((_failTransfers > 0) || (reg >= NUM_REGISTERS))
+    {
+        _failTransfers = std::max(_failTransfers - 1, 0);
+        errno = EIO;
+        return false;
+    }
+
+    uint64_t now = _clock();
+    update(now);
+
+    if ((reg == REG_CONTROL_2) && (value & CONTROL_2_SOFT_RST))
+    {
+        std::fill(_registers, _registers + NUM_REGISTERS, 0);
+        _registers[REG_CHIP_ID] = CHIP_ID;
+        return true;
+    }
+    if ((reg == REG_CONTROL_1) && ((value & CONTROL_1_MODE_MASK) == MODE_CONTINUOUS) &&
+        ((_registers[REG_CONTROL_1] & CONTROL_1_MODE_MASK) != MODE_CONTINUOUS))
+    {
+        _startNs = now;
+        _measurement = 0;
+        _readMeasurement = 0;
+    }
+    if ((reg == REG_CONTROL_1) || (reg == REG_CONTROL_2) || (reg == REG_SET_RESET_PERIOD))
+    {
+        _registers[reg] = value;
+    }
+    // the rest is read only
+    return true;
+}
+
+int SimulatedQMC5883L::readRegisters(uint8_t reg, uint8_t length, uint8_t *data)
+{
+    uint64_t delay = 0;
+    bool newData = false;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if ((_failTransfers > 0) || (reg >= NUM_REGISTERS))
+        {
+            _failTransfers = std::max(_failTransfers - 1, 0);
+            errno = EIO;
+            return -1;
+        }
+
+        uint64_t now = _clock();
+        update(now);
+
+        bool dataRead = false;
+        uint8_t pointer = reg;
+        for (uint8_t i = 0; i < length; i++)
+        {
+            data[i] = _registers[pointer];
+            dataRead = dataRead || (pointer < REG_STATUS);
+            pointer++;
+            if ((pointer == REG_STATUS + 1) && (_registers[REG_CONTROL_2] & CONTROL_2_ROL_PNT))
+            {
+                pointer = 0;
+            }
+            else if (pointer == NUM_REGISTERS)
+            {
+                pointer = 0;
+            }
+        }
+
+        if (dataRead)
+        {
+            _registers[REG_STATUS] &= ~(STATUS_DRDY | STATUS_DOR);
+            if (_measurement > _readMeasurement)
+            {
+                uint64_t odr = OUTPUT_DATA_RATES[(_registers[REG_CONTROL_1] >> 2) & 0x03];
+                delay = now - (_startNs + _measurement * 1000000000ULL / odr);
+                newData = true;
+            }
+            _readMeasurement = _measurement;
+        }
+    }
+
+    if (newData && _onDataRead)
+    {
+        _onDataRead(delay);
+    }
+    return length;
+}
+
+void SimulatedQMC5883L::failTransfers(int count)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _failTransfers = count;
+}
+
+uint64_t SimulatedQMC5883L::measurements()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    update(_clock());
+    return _measurement;
+}
+
+double SimulatedQMC5883L::heading(double seconds) const
+{
+    double total = 0.0;
+    for (const SimulatorTrackLeg &leg : _config.track)
+    {
+        total += leg.duration;
+    }
+    if (total <= 0.0)
+    {
+        return 0.0;
+    }
+
+    double t = std::fmod(seconds, total);
+    for (const SimulatorTrackLeg &leg : _config.track)
+    {
+        if ((t < leg.duration) || (&leg == &_config.track.back()))
+        {
+            double heading = std::fmod(leg.course + leg.turnRate * t, 360.0);
+            return (heading < 0.0) ? heading + 360.0 : heading;
+        }
+        t -= leg.duration;
+    }
+    return 0.0;
+}
+
+void SimulatedQMC5883L::update(uint64_t nowNs)
+{
+    if ((_registers[REG_CONTROL_1] & CONTROL_1_MODE_MASK) != MODE_CONTINUOUS)
+    {
+        return;
+    }
+
+    uint64_t odr = OUTPUT_DATA_RATES[(_registers[REG_CONTROL_1] >> 2) & 0x03];
+    uint64_t due = (nowNs - _startNs) * odr / 1000000000ULL;
+    if (due <= _measurement)
+    {
+        return;
+    }
+
+    // only the latest measurement is kept, any made after the last read but this one is lost
+    if (due > _readMeasurement + 1)
+    {
+        _registers[REG_STATUS] |= STATUS_DOR;
+    }
+    _registers[REG_STATUS] |= STATUS_DRDY;
+    _measurement = due;
+    measure(static_cast<double>(due) / odr);
+}
+
+void SimulatedQMC5883L::measure(double seconds)
+{
+    double sensitivity = (_registers[REG_CONTROL_1] & CONTROL_1_RANGE_8G) ? SENSITIVITY_8G : SENSITIVITY_2G;
+    double heading = SimulatedQMC5883L::heading(seconds) * PI / 180.0;
+    double temperature = SimulatedQMC5883L::temperature(seconds);
+    double warming = temperature - _config.temperature;
+    // magnetic north seen from a level sensor pointing to heading
+    double field[3] = {
+        _config.horizontalField * std::cos(heading) + _config.hardIron[0] + _config.thermalDrift[0] * warming,
+        _config.horizontalField * std::sin(heading) + _config.hardIron[1] + _config.thermalDrift[1] * warming,
+        _config.verticalField + _config.hardIron[2] + _config.thermalDrift[2] * warming
+    };
+
+    bool overflow = false;
+    for (size_t axis = 0; axis < 3; axis++)
+    {
+        double value = field[axis] * sensitivity;
+        if (_config.noise > 0.0)
+        {
+            value += _config.noise * _noise(_random);
+        }
+        value = std::round(value);
+        if ((value > INT16_MAX) || (value < INT16_MIN))
+        {
+            overflow = true;
+            value = std::clamp(value, static_cast<double>(INT16_MIN), static_cast<double>(INT16_MAX));
+        }
+        uint16_t word = static_cast<uint16_t>(static_cast<int16_t>(value));
+        _registers[axis * 2] = word & 0xff;
+        _registers[axis * 2 + 1] = word >> 8;
+    }
+
+    uint16_t word = static_cast<uint16_t>(static_cast<int16_t>(std::lround(temperature * TEMPERATURE_LSB_PER_DEGREE)));
+    _registers[REG_TEMPERATURE] = word & 0xff;
+    _registers[REG_TEMPERATURE + 1] = word >> 8;
+
+    if (overflow)
+    {
+        _registers[REG_STATUS] |= STATUS_OVL;
+    }
+    else
+    {
+        _registers[REG_STATUS] &= ~STATUS_OVL;
+    }
+}
+
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SIMULATEDQMC5883L_HPP
+#define SIMULATEDQMC5883L_HPP
+
+#include "I2CBus.hpp"
+#include "GPSSimulator.hpp"
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <vector>
+
+namespace ship_position
+{
+
+struct SimulatedQMC5883LConfig
+{
+    // the sensor heading follows the course of the legs, speeds are ignored
+    std::vector<SimulatorTrackLeg> track;
+    // earth field at the sensor, gauss
+    double horizontalField;
+    double verticalField;
+    // hard iron added to every measurement, gauss
+    double hardIron[3];
+    // standard deviation of every axis, LSB
+    double noise;
+    // die temperature when continuous mode is set, degrees C, and its change per second
+    double temperature;
+    double temperatureRate;
+    // hard iron change per degree C away from the start temperature, gauss
+    double thermalDrift[3];
+    uint32_t seed;
+
+    SimulatedQMC5883LConfig()
+    {
+        track = {{60.0, 0.0, 0.0, 6.0}};
+        horizontalField = 0.18;
+        verticalField = 0.48;
+        hardIron[0] = 0.0;
+        hardIron[1] = 0.0;
+        hardIron[2] = 0.0;
+        noise = 0.0;
+        temperature = 25.0;
+        temperatureRate = 0.0;
+        thermalDrift[0] = 0.0;
+        thermalDrift[1] = 0.0;
+        thermalDrift[2] = 0.0;
+        seed = 1;
+    }
+};
+
+// QMC5883L register file behind an in-process bus, measuring at the configured ODR; X forward, Y to port
+class SimulatedQMC5883L : public I2CBus
+{
+public:
+    // called when the data registers were read, with the age of the measurement in them
+    typedef std::function<void(uint64_t delayNs)> DataReadCallback;
+    typedef std::function<uint64_t()> ClockFunction;
+
+    static constexpr uint8_t NUM_REGISTERS = 0x0E;
+    static constexpr uint8_t REG_CHIP_ID = 0x0D;
+    static constexpr uint8_t CHIP_ID = 0xFF;
+
+    SimulatedQMC5883L(const SimulatedQMC5883LConfig &config);
+
+    virtual bool writeRegister(uint8_t reg, uint8_t value);
+    virtual int readRegisters(uint8_t reg, uint8_t length, uint8_t *data);
+
+    // CLOCK_MONOTONIC by default, tests step their own clock
+    void setClock(ClockFunction clock) { _clock = clock; }
+    void setDataReadCallback(DataReadCallback callback) { _onDataRead = callback; }
+    // the next count transfers fail with EIO
+    void failTransfers(int count);
+
+    // measurements made since continuous mode was set
+    uint64_t measurements();
+    // degrees, at the given time since continuous mode was set
+    double heading(double seconds) const;
+    // degrees C, at the given time since continuous mode was set
+    double temperature(double seconds) const { return _config.temperature + _config.temperatureRate * seconds; }
+
+protected:
+    // makes the measurements due by nowNs
+    void update(uint64_t nowNs);
+    void measure(double seconds);
+
+    SimulatedQMC5883LConfig _config;
+    ClockFunction _clock;
+    DataReadCallback _onDataRead;
+    std::mt19937 _random;
+    // standard normal, scaled by the configured noise
+    std::normal_distribution<double> _noise;
+    // transfers may come from a reader thread while the test thread looks at the device
+    std::mutex _mutex;
+    uint8_t _registers[NUM_REGISTERS];
+    int _failTransfers;
+    // when continuous mode was set, measurement n is made 1/ODR * n later
+    uint64_t _startNs;
+    uint64_t _measurement;
+    // last measurement whose data was read
+    uint64_t _readMeasurement;
+};
+
+}
+
+#endif // SIMULATEDQMC5883L_HPP
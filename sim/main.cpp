@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GPSSimulator.hpp"
+#include <signal.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <boost/program_options.hpp>
+
+namespace sp = ship_position;
+namespace po = boost::program_options;
+
+static std::atomic<bool> stopRequested(false);
+
+static void signal_handler(int)
+{
+    stopRequested = true;
+}
+
+int main(int argc, char *argv[])
+{
+    sp::GPSSimulatorConfig config;
+    std::string link;
+
+    try
+    {
+        po::variables_map opts;
+        po::options_description opt_descr("Available options:");
+
+        opt_descr.add_options()
+            ("help", "print help message")
+            ("link", po::value<std::string>(), "create a symlink to the pty slave, to be used as devPath")
+            ("rate", po::value<double>(), "epochs per second")
+            ("baud", po::value<uint32_t>(), "pace output as on a serial line at this speed, 0 - no pacing")
+            ("no-nmea", "don't emit GGA, VTG and RMC")
+            ("ubx", "emit NAV-PVT")
+            ("lat", po::value<double>(), "start latitude")
+            ("lon", po::value<double>(), "start longitude")
+            ("speed", po::value<double>(), "speed, knots, for a single leg track")
+            ("course", po::value<double>(), "course, degrees, for a single leg track")
+            ("turn", po::value<double>(), "turn rate, degrees per second, for a single leg track")
+            ("track", po::value<std::string>(), "track file, lines of: duration speed course turnRate")
+            ("noise", po::value<double>(), "position noise, meters")
+            ("corrupt", po::value<double>(), "probability of a corrupted sentence")
+            ("split", po::value<double>(), "probability of a sentence split into two writes")
+            ("seed", po::value<uint32_t>(), "random seed");
+
+        po::store(po::parse_command_line(argc, argv, opt_descr), opts);
+        po::notify(opts);
+
+        if (opts.count("help"))
+        {
+            std::cout << "Usage: " << argv[0] << " [options]\n";
+            std::cout << opt_descr << "\n";
+            return 0;
+        }
+
+        if (opts.count("link"))
+        {
+            link = opts["link"].as<std::string>();
+        }
+        if (opts.count("rate"))
+        {
+            config.rate = opts["rate"].as<double>();
+        }
+        if (opts.count("baud"))
+        {
+            config.baudRate = opts["baud"].as<uint32_t>();
+        }
+        if (opts.count("no-nmea"))
+        {
+            config.nmea = false;
+        }
+        if (opts.count("ubx"))
+        {
+            config.ubx = true;
+        }
+        if (opts.count("lat"))
+        {
+            config.startLatitude = opts["lat"].as<double>();
+        }
+        if (opts.count("lon"))
+        {
+            config.startLongitude = opts["lon"].as<double>();
+        }
+        if (opts.count("noise"))
+        {
+            config.positionNoise = opts["noise"].as<double>();
+        }
+        if (opts.count("corrupt"))
+        {
+            config.corruptProbability = opts["corrupt"].as<double>();
+        }
+        if (opts.count("split"))
+        {
+            config.splitProbability = opts["split"].as<double>();
+        }
+        if (opts.count("seed"))
+        {
+            config.seed = opts["seed"].as<uint32_t>();
+        }
+
+        if (opts.count("track"))
+        {
+            if (!sp::GPSSimulator::loadTrack(opts["track"].as<std::string>(), config.track))
+            {
+                std::cerr << "failed to load track " << opts["track"].as<std::string>() << "\n";
+                return 1;
+            }
+        }
+        else if (opts.count("speed") || opts.count("course") || opts.count("turn"))
+        {
+            sp::SimulatorTrackLeg leg = {3600.0, 0.0, 0.0, 0.0};
+            if (opts.count("speed"))
+            {
+                leg.speedKnots = opts["speed"].as<double>();
+            }
+            if (opts.count("course"))
+            {
+                leg.course = opts["course"].as<double>();
+            }
+            if (opts.count("turn"))
+            {
+                leg.turnRate = opts["turn"].as<double>();
+            }
+            config.track = {leg};
+        }
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << "Error processing command line: " << e.what() << "\n";
+        return 2;
+    }
+
+    sp::GPSSimulator simulator(config);
+    if (!simulator.isOk())
+    {
+        std::cerr << "failed to create pty\n";
+        return 1;
+    }
+
+    if (!link.empty())
+    {
+        unlink(link.c_str());
+        if (symlink(simulator.slavePath().c_str(), link.c_str()) == -1)
+        {
+            std::cerr << "failed to create symlink " << link << "\n";
+            return 1;
+        }
+    }
+    std::cout << "simulating gps on " << simulator.slavePath() << std::endl;
+
+    struct sigaction act = {};
+    act.sa_handler = signal_handler;
+    sigaction(SIGINT, &act, nullptr);
+    sigaction(SIGTERM, &act, nullptr);
+
+    simulator.start();
+    while (!stopRequested)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    simulator.stop();
+
+    std::cout << simulator.epochs() << " epochs, " << simulator.corrupted() << " corrupted, "
+        << simulator.split() << " split, " << simulator.overruns() << " bytes overrun" << std::endl;
+
+    if (!link.empty())
+    {
+        unlink(link.c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,561 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "BN880GPSReader.hpp"
+#include "Clock.hpp"
+#include <gtest/gtest.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+namespace sp = ship_position;
+
+class BN880GPSReaderAdapter : public sp::BN880GPSReader
+{
+public:
+    BN880GPSReaderAdapter(const sp::BN880GPSConfig &config) : sp::BN880GPSReader(config) {}
+    uint64_t numReads() const { return _numReads; }
+    int readErrors() const { return _readErrors; }
+};
+
+class BN880GPSReaderTest : public ::testing::Test
+{
+public:
+    virtual void SetUp();
+    virtual void TearDown();
+protected:
+    void send(const std::string &data);
+    bool waitForLatitude(double latitude);
+    // UBX messages sent to the receiver, as class, id and payload
+    std::vector<std::vector<uint8_t>> readFrames(size_t count);
+
+    int _master;
+    sp::BN880GPSConfig _config;
+    // replaces the reader started by SetUp()
+    void restart(const sp::BN880GPSConfig &config);
+
+    BN880GPSReaderAdapter *_reader;
+};
+
+void BN880GPSReaderTest::SetUp()
+{
+    _master = posix_openpt(O_RDWR | O_NOCTTY);
+    ASSERT_NE(-1, _master);
+    ASSERT_EQ(0, grantpt(_master));
+    ASSERT_EQ(0, unlockpt(_master));
+
+    _config.devPath = ptsname(_master);
+    _config.bufferSize = 4096;
+    _config.maxRetries = 3;
+    _config.rawOutput = "";
+    _config.maxRawFileSize = 0;
+    _config.rawSegments = 0;
+    _config.rawTimestamps = false;
+    _config.replayFile = "";
+    _config.replaySpeed = 1.0;
+    _config.protocol = "nmea";
+    _config.measurementRate = 0;
+    _config.baudRate = 0;
+    _config.messages = {};
+    _config.portBaudRate = 0;
+    _config.vmin = 1;
+    _config.vtime = 0;
+    _config.lowLatency = false;
+
+    _reader = new BN880GPSReaderAdapter(_config);
+    _reader->start();
+}
+
+void BN880GPSReaderTest::restart(const sp::BN880GPSConfig &config)
+{
+    _reader->stop();
+    delete _reader;
+    _reader = new BN880GPSReaderAdapter(config);
+    _reader->start();
+}
+
+void BN880GPSReaderTest::TearDown()
+{
+    _reader->stop();
+    delete _reader;
+    close(_master);
+}
+
+void BN880GPSReaderTest::send(const std::string &data)
+{
+    ASSERT_EQ(data.length(), write(_master, data.c_str(), data.length()));
+}
+
+bool BN880GPSReaderTest::waitForLatitude(double latitude)
+{
+    for (int i = 0; i < 200; i++)
+    {
+        sp::GPSInfo gpsInfo;
+        _reader->getGPSInfo(gpsInfo);
+        if (gpsInfo.latitude == latitude)
+        {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return false;
+}
+
+std::vector<std::vector<uint8_t>> BN880GPSReaderTest::readFrames(size_t count)
+{
+    std::vector<std::vector<uint8_t>> frames;
+    sp::UBXParser parser([&frames](uint8_t msgClass, uint8_t msgId, const uint8_t *payload, size_t length)
+    {
+        std::vector<uint8_t> frame = {msgClass, msgId};
+        frame.insert(frame.end(), payload, payload + length);
+        frames.push_back(frame);
+    });
+
+    char buf[256];
+    while (frames.size() < count)
+    {
+        ssize_t numRead = read(_master, buf, sizeof(buf));
+        if (numRead <= 0)
+        {
+            break;
+        }
+        for (ssize_t pos = 0; pos < numRead; )
+        {
+            pos += parser.feed(buf + pos, numRead - pos);
+        }
+    }
+    return frames;
+}
+
+TEST_F(BN880GPSReaderTest, PublishesWithoutDelay)
+{
+    auto start = std::chrono::steady_clock::now();
+    send("$GNGGA,170257.00,5619.06488,N,04401.12281,E,1,09,1.36,124.2,M,6.3,M,,*79\r\n");
+    ASSERT_TRUE(waitForLatitude(56.317748));
+    // the old loop slept for a second after every read
+    ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(500));
+
+    sp::GPSInfo gpsInfo;
+    _reader->getGPSInfo(gpsInfo);
+    ASSERT_EQ(44.0187135, gpsInfo.longitude);
+    ASSERT_EQ(9, gpsInfo.numSatellites);
+}
+
+TEST_F(BN880GPSReaderTest, SentenceSplitBetweenReads)
+{
+    send("$GNGGA,170257.00,5619.06488,N,04401.122");
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    send("81,W,1,09,1.36,124.2,M,6.3,M,,*6B\r\n");
+    ASSERT_TRUE(waitForLatitude(56.317748));
+
+    sp::GPSInfo gpsInfo;
+    _reader->getGPSInfo(gpsInfo);
+    ASSERT_EQ(-44.0187135, gpsInfo.longitude);
+}
+
+TEST_F(BN880GPSReaderTest, StopIsImmediate)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    auto start = std::chrono::steady_clock::now();
+    _reader->stop();
+    ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(100));
+}
+
+TEST_F(BN880GPSReaderTest, EndOfFileIsReadError)
+{
+    // a regular file polls readable and reads nothing, like a device that went away
+    char path[] = "/tmp/bn880_eofXXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_NE(-1, fd);
+    close(fd);
+    sp::BN880GPSConfig config = _config;
+    config.devPath = path;
+    config.maxRetries = 2;
+    restart(config);
+
+    // one retry after backing off, then the reader gives up instead of spinning
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    ASSERT_EQ(1, _reader->readErrors());
+    std::this_thread::sleep_for(std::chrono::milliseconds(sp::BN880GPSReader::RETRY_TIMEOUT_MS));
+    ASSERT_EQ(2, _reader->readErrors());
+    ASSERT_EQ(0, _reader->numReads());
+    unlink(path);
+}
+
+TEST_F(BN880GPSReaderTest, StampsArrivalAndPublishTime)
+{
+    sp::GPSInfo gpsInfo;
+    _reader->getGPSInfo(gpsInfo);
+    ASSERT_EQ(0, gpsInfo.arrivalNs);
+    ASSERT_EQ(0, gpsInfo.publishNs);
+
+    uint64_t before = sp::monotonicNs();
+    send("$GNGGA,170257.00,5619.06488,N,04401.12281,E,1,09,1.36,124.2,M,6.3,M,,*79\r\n");
+    ASSERT_TRUE(waitForLatitude(56.317748));
+    uint64_t after = sp::monotonicNs();
+
+    _reader->getGPSInfo(gpsInfo);
+    ASSERT_LE(before, gpsInfo.arrivalNs);
+    ASSERT_LE(gpsInfo.arrivalNs, gpsInfo.publishNs);
+    ASSERT_LE(gpsInfo.publishNs, after);
+    ASSERT_EQ(gpsInfo.arrivalNs, gpsInfo.positionArrivalNs);
+    ASSERT_EQ(17, gpsInfo.utcHours);
+    sp::NMEAStatistics statistics;
+    _reader->getNMEAStatistics(statistics);
+    ASSERT_EQ(gpsInfo.arrivalNs, statistics.lastArrivalNs);
+
+    // a corrupted sentence is counted, but doesn't refresh the fix
+    send("$GNGGA,170258.00,5619.06488,N,04401.12281,E,1,09,1.36,124.2,M,6.3,M,,*79\r\n");
+    for (int i = 0; (i < 200) && (statistics.counters[0].invalid == 0); i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        _reader->getNMEAStatistics(statistics);
+    }
+    ASSERT_EQ(1, statistics.counters[0].invalid);
+    ASSERT_LT(gpsInfo.arrivalNs, statistics.lastArrivalNs);
+    sp::GPSInfo sameInfo;
+    _reader->getGPSInfo(sameInfo);
+    ASSERT_EQ(gpsInfo.arrivalNs, sameInfo.arrivalNs);
+    ASSERT_EQ(gpsInfo.publishNs, sameInfo.publishNs);
+}
+
+TEST_F(BN880GPSReaderTest, MixedNMEAAndUBX)
+{
+    // NAV-PVT with date and 3D fix, position is then overwritten by GGA
+    std::vector<uint8_t> payload(92, 0);
+    payload[4] = 2026 & 0xff;
+    payload[5] = 2026 >> 8;
+    payload[6] = 10;
+    payload[7] = 16;
+    payload[11] = 0x01;
+    payload[20] = 3;
+    payload[21] = 0x01;
+    std::vector<uint8_t> frame = sp::UBXParser::makeFrame(0x01, 0x07, payload);
+
+    send("\r\n" + std::string(frame.begin(), frame.end()) +
+        "$GNGGA,170257.00,5619.06488,N,04401.12281,E,1,09,1.36,124.2,M,6.3,M,,*79\r\n");
+    ASSERT_TRUE(waitForLatitude(56.317748));
+
+    sp::GPSInfo gpsInfo;
+    _reader->getGPSInfo(gpsInfo);
+    ASSERT_EQ(2026, gpsInfo.utcYear);
+    ASSERT_EQ(3, gpsInfo.fixMode);
+    ASSERT_EQ(9, gpsInfo.numSatellites);
+}
+
+TEST_F(BN880GPSReaderTest, ConfiguresUBXOutput)
+{
+    sp::BN880GPSConfig config = _config;
+    config.protocol = "ubx";
+    sp::BN880GPSReader reader(config);
+
+    // 9 CFG-MSG, CFG-PRT
+    std::vector<std::vector<uint8_t>> frames = readFrames(10);
+    ASSERT_EQ(10, frames.size());
+
+    std::vector<uint8_t> pvt = {0x06, 0x01, 0x01, 0x07, 1};
+    std::vector<uint8_t> dop = {0x06, 0x01, 0x01, 0x04, 1};
+    std::vector<uint8_t> gga = {0x06, 0x01, 0xf0, 0x00, 0};
+    ASSERT_NE(frames.end(), std::find(frames.begin(), frames.end(), pvt));
+    ASSERT_NE(frames.end(), std::find(frames.begin(), frames.end(), dop));
+    ASSERT_NE(frames.end(), std::find(frames.begin(), frames.end(), gga));
+
+    // CFG-PRT, UART1, UBX only output
+    ASSERT_EQ(0x00, frames[9][1]);
+    ASSERT_EQ(1, frames[9][2]);
+    ASSERT_EQ(0x01, frames[9][2 + 14]);
+}
+
+TEST_F(BN880GPSReaderTest, ConfiguresRateAndBaud)
+{
+    sp::BN880GPSConfig config = _config;
+    config.measurementRate = 10;
+    config.baudRate = 115200;
+    config.messages = {"GGA", "NAV-PVT"};
+    sp::BN880GPSReader reader(config);
+
+    // 9 CFG-MSG, CFG-RATE, CFG-PRT
+    std::vector<std::vector<uint8_t>> frames = readFrames(11);
+    ASSERT_EQ(11, frames.size());
+
+    std::vector<uint8_t> gga = {0x06, 0x01, 0xf0, 0x00, 1};
+    std::vector<uint8_t> vtg = {0x06, 0x01, 0xf0, 0x05, 0};
+    std::vector<uint8_t> pvt = {0x06, 0x01, 0x01, 0x07, 1};
+    ASSERT_NE(frames.end(), std::find(frames.begin(), frames.end(), gga));
+    ASSERT_NE(frames.end(), std::find(frames.begin(), frames.end(), vtg));
+    ASSERT_NE(frames.end(), std::find(frames.begin(), frames.end(), pvt));
+
+    // 100 ms measurement period
+    std::vector<uint8_t> rate = {0x06, 0x08, 100, 0, 1, 0, 0, 0};
+    ASSERT_EQ(rate, frames[9]);
+
+    // CFG-PRT with 115200 baud, NMEA output kept
+    ASSERT_EQ(0x00, frames[10][1]);
+    ASSERT_EQ(0x00, frames[10][2 + 8]);
+    ASSERT_EQ(0xc2, frames[10][2 + 9]);
+    ASSERT_EQ(0x01, frames[10][2 + 10]);
+    ASSERT_EQ(0x03, frames[10][2 + 14]);
+
+    // the local port follows
+    struct termios options;
+    int fd = open(config.devPath.c_str(), O_RDWR | O_NOCTTY);
+    ASSERT_NE(-1, fd);
+    ASSERT_EQ(0, tcgetattr(fd, &options));
+    close(fd);
+    ASSERT_EQ(B115200, cfgetospeed(&options));
+}
+
+TEST_F(BN880GPSReaderTest, FindsReceiverAtConfiguredBaud)
+{
+    // the receiver kept the speed it was switched to by the previous run
+    _reader->stop();
+    std::atomic<bool> configured(false);
+    std::thread receiver([this, &configured]()
+    {
+        std::string sentence = "$GNGGA,170257.00,5619.06488,N,04401.12281,E,1,09,1.36,124.2,M,6.3,M,,*79\r\n";
+        while (!configured)
+        {
+            ASSERT_EQ(sentence.length(), write(_master, sentence.c_str(), sentence.length()));
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+    });
+    sp::BN880GPSConfig config = _config;
+    config.baudRate = 115200;
+    config.messages = {"GGA"};
+    auto start = std::chrono::steady_clock::now();
+    sp::BN880GPSReader reader(config);
+    configured = true;
+    receiver.join();
+    ASSERT_LT(std::chrono::steady_clock::now() - start,
+        std::chrono::milliseconds(sp::BN880GPSReader::PROBE_TIMEOUT_MS));
+
+    // 9 CFG-MSG, CFG-PRT, all at the new speed
+    std::vector<std::vector<uint8_t>> frames = readFrames(10);
+    ASSERT_EQ(10, frames.size());
+    ASSERT_EQ(0x00, frames[9][1]);
+    struct termios options;
+    ASSERT_EQ(0, tcgetattr(_master, &options));
+    ASSERT_EQ(B115200, cfgetospeed(&options));
+}
+
+TEST_F(BN880GPSReaderTest, RejectsMeasurementRate)
+{
+    _reader->stop();
+    sp::BN880GPSConfig config = _config;
+    config.measurementRate = 2000;
+    config.messages = {"GGA"};
+    sp::BN880GPSReader reader(config);
+
+    // 9 CFG-MSG and no CFG-RATE
+    std::vector<std::vector<uint8_t>> frames = readFrames(9);
+    ASSERT_EQ(9, frames.size());
+    int flags = fcntl(_master, F_GETFL);
+    ASSERT_EQ(0, fcntl(_master, F_SETFL, flags | O_NONBLOCK));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT_TRUE(readFrames(1).empty());
+    ASSERT_EQ(0, fcntl(_master, F_SETFL, flags));
+}
+
+TEST_F(BN880GPSReaderTest, RawMode)
+{
+    struct termios options;
+    int fd = open(_config.devPath.c_str(), O_RDWR | O_NOCTTY);
+    ASSERT_NE(-1, fd);
+    ASSERT_EQ(0, tcgetattr(fd, &options));
+    close(fd);
+
+    ASSERT_EQ(0, options.c_lflag & (ICANON | ECHO | ISIG | IEXTEN));
+    ASSERT_EQ(0, options.c_iflag & (ICRNL | IXON | ISTRIP));
+    ASSERT_EQ(0, options.c_oflag & OPOST);
+    ASSERT_EQ(CS8, options.c_cflag & CSIZE);
+    ASSERT_EQ(1, options.c_cc[VMIN]);
+    ASSERT_EQ(0, options.c_cc[VTIME]);
+}
+
+TEST_F(BN880GPSReaderTest, BurstInOneRead)
+{
+    std::string sentence = "$GNGGA,,5619.06488,N,04401.12281,E,1,09*67\r\n";
+    sp::BN880GPSConfig config = _config;
+    config.vmin = sentence.length();
+    config.vtime = 5;
+    restart(config);
+
+    // the sentence trickles in, but is returned by a single read as soon as it's complete
+    auto start = std::chrono::steady_clock::now();
+    send(sentence.substr(0, 15));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    send(sentence.substr(15, 15));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    send(sentence.substr(30));
+    ASSERT_TRUE(waitForLatitude(56.317748));
+    ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(300));
+    ASSERT_EQ(1, _reader->numReads());
+}
+
+TEST_F(BN880GPSReaderTest, RecordsRawOutput)
+{
+    char dir[] = "/tmp/bn880_testXXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(dir));
+    sp::BN880GPSConfig config = _config;
+    config.rawOutput = std::string(dir) + "/rawgps.log";
+    restart(config);
+
+    std::string sentence = "$GNGGA,170257.00,5619.06488,N,04401.12281,E,1,09,1.36,124.2,M,6.3,M,,*79\r\n";
+    send(sentence);
+    ASSERT_TRUE(waitForLatitude(56.317748));
+    // stop() flushes the recorder
+    _reader->stop();
+
+    std::ifstream file(config.rawOutput + ".000001");
+    std::string recorded((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    ASSERT_EQ(sentence, recorded);
+    std::filesystem::remove_all(dir);
+}
+
+class BN880GPSReplayTest : public BN880GPSReaderTest
+{
+public:
+    virtual void SetUp()
+    {
+        BN880GPSReaderTest::SetUp();
+        char path[] = "/tmp/bn880_replayXXXXXX";
+        int fd = mkstemp(path);
+        ASSERT_NE(-1, fd);
+        close(fd);
+        _replayFile = path;
+    }
+
+    virtual void TearDown()
+    {
+        BN880GPSReaderTest::TearDown();
+        unlink(_replayFile.c_str());
+    }
+
+protected:
+    // timestamped recording with the given data and times in milliseconds
+    void writeRecords(const std::vector<std::pair<std::string, uint64_t>> &records)
+    {
+        std::ofstream file(_replayFile, std::ios::binary);
+        file.write(sp::RawRecorder::TIMESTAMPED_MAGIC, sizeof(sp::RawRecorder::TIMESTAMPED_MAGIC));
+        for (const auto &record : records)
+        {
+            sp::RawRecorder::RecordHeader header;
+            header.timestamp = 1000000000ULL + record.second * 1000000ULL;
+            header.length = record.first.length();
+            header.reserved = 0;
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(record.first.data(), record.first.length());
+        }
+    }
+
+    void replay(double speed)
+    {
+        // the reader keeps a reference to its config
+        _replayConfig = _config;
+        _replayConfig.replayFile = _replayFile;
+        _replayConfig.replaySpeed = speed;
+        restart(_replayConfig);
+    }
+
+    bool waitForReplay(sp::ReplayStatistics &statistics)
+    {
+        for (int i = 0; i < 400; i++)
+        {
+            _reader->getReplayStatistics(statistics);
+            if (statistics.finished)
+            {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return false;
+    }
+
+    std::string _replayFile;
+    sp::BN880GPSConfig _replayConfig;
+};
+
+TEST_F(BN880GPSReplayTest, PlainRecordingAtMaxSpeed)
+{
+    std::string data;
+    for (int i = 0; i < 100; i++)
+    {
+        data += "$GNVTG,,T,,M,0.071,N,0.131,K,A*38\r\n";
+    }
+    data += "$GNGGA,170257.00,5619.06488,N,04401.12281,E,1,09,1.36,124.2,M,6.3,M,,*79\r\n";
+    std::ofstream(_replayFile, std::ios::binary) << data;
+
+    replay(0.0);
+    sp::ReplayStatistics statistics;
+    ASSERT_TRUE(waitForReplay(statistics));
+    ASSERT_EQ(data.length(), statistics.bytes);
+
+    sp::GPSInfo gpsInfo;
+    _reader->getGPSInfo(gpsInfo);
+    ASSERT_EQ(56.317748, gpsInfo.latitude);
+    sp::NMEAStatistics nmeaStatistics;
+    _reader->getNMEAStatistics(nmeaStatistics);
+    ASSERT_EQ(100, nmeaStatistics.counters[sp::NMEAStatistics::typeIndex("GNVTG")].valid);
+}
+
+TEST_F(BN880GPSReplayTest, TimestampedRecordingKeepsTiming)
+{
+    writeRecords({
+        {"$GNGGA,170257.00,5619.06488,N,04401.12281,E,1,09,1.36,124.2,M,6.3,M,,*79\r\n", 0},
+        {"$GNGGA,170257.00,5619.06488,N,04401.122", 200},
+        {"81,W,1,09,1.36,124.2,M,6.3,M,,*6B\r\n", 400}});
+
+    // twice as fast: 400 ms of recording in 200 ms
+    replay(2.0);
+    sp::ReplayStatistics statistics;
+    ASSERT_TRUE(waitForReplay(statistics));
+    ASSERT_EQ(3, statistics.records);
+    ASSERT_GE(statistics.elapsedNs, 200000000ULL);
+    ASSERT_LT(statistics.elapsedNs, 400000000ULL);
+
+    sp::GPSInfo gpsInfo;
+    _reader->getGPSInfo(gpsInfo);
+    ASSERT_EQ(-44.0187135, gpsInfo.longitude);
+}
+
+TEST_F(BN880GPSReplayTest, StopIsImmediate)
+{
+    writeRecords({{"$GNVTG,,T,,M,0.071,N,0.131,K,A*38\r\n", 0}, {"$GNVTG,,T,,M,0.071,N,0.131,K,A*38\r\n", 10000}});
+    replay(1.0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    auto start = std::chrono::steady_clock::now();
+    _reader->stop();
+    ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(100));
+
+    sp::ReplayStatistics statistics;
+    _reader->getReplayStatistics(statistics);
+    ASSERT_EQ(1, statistics.records);
+    ASSERT_FALSE(statistics.finished);
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "BackgroundTask.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace sp = ship_position;
+
+namespace
+{
+
+bool waitFor(const std::atomic<int> &runs, int expected)
+{
+    for (int i = 0; (i < 200) && (runs < expected); i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return runs == expected;
+}
+
+}
+
+TEST(BackgroundTask, RunsOnItsOwnThread)
+{
+    std::atomic<int> runs(0);
+    std::thread::id taskThread;
+    sp::BackgroundTask task([&runs, &taskThread]()
+    {
+        taskThread = std::this_thread::get_id();
+        runs++;
+    });
+    task.start();
+
+    // nothing runs until triggered
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(0, runs);
+
+    task.trigger();
+    ASSERT_TRUE(waitFor(runs, 1));
+    EXPECT_NE(std::this_thread::get_id(), taskThread);
+    task.trigger();
+    ASSERT_TRUE(waitFor(runs, 2));
+    task.stop();
+}
+
+TEST(BackgroundTask, MergesPendingTriggers)
+{
+    std::atomic<int> runs(0);
+    std::atomic<bool> release(false);
+    sp::BackgroundTask task([&runs, &release]()
+    {
+        runs++;
+        while (!release)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    task.start();
+
+    // triggers while the task runs make it run once more, not once each
+    task.trigger();
+    ASSERT_TRUE(waitFor(runs, 1));
+    for (int i = 0; i < 10; i++)
+    {
+        task.trigger();
+    }
+    release = true;
+    ASSERT_TRUE(waitFor(runs, 2));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(2, runs);
+    task.stop();
+}
+
+TEST(BackgroundTask, RunsPendingTaskOnStop)
+{
+    std::atomic<int> runs(0);
+    sp::BackgroundTask task([&runs]()
+    {
+        runs++;
+    });
+    task.trigger();
+    task.start();
+    task.stop();
+    EXPECT_EQ(1, runs);
+
+    // can be started again
+    task.start();
+    task.trigger();
+    ASSERT_TRUE(waitFor(runs, 2));
+    task.stop();
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "CalibrationCollector.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+
+namespace sp = ship_position;
+
+namespace
+{
+
+// sensor with some hard and soft iron turned around, pitch and roll up to maxTilt degrees
+void turn(sp::CalibrationCollector &collector, size_t count, double maxTilt)
+{
+    std::mt19937 random(11);
+    std::uniform_real_distribution<double> heading(-M_PI, M_PI);
+    std::uniform_real_distribution<double> tilt(-std::sin(maxTilt * M_PI / 180.0), std::sin(maxTilt * M_PI / 180.0));
+    std::normal_distribution<double> noise(0.0, 3.0);
+    for (size_t i = 0; i < count; i++)
+    {
+        double z = tilt(random);
+        double h = heading(random);
+        double r = std::sqrt(1.0 - z * z) * 3000.0;
+        collector.add(std::lround(1.1 * r * std::cos(h) + 420.0 + noise(random)),
+            std::lround(0.9 * r * std::sin(h) - 310.0 + noise(random)),
+            std::lround(z * 3000.0 + 150.0 + noise(random)), 25.0);
+    }
+}
+
+}
+
+TEST(CalibrationCollector, FullRotationCompletes)
+{
+    sp::CalibrationCollector collector(0.75, 0.015);
+    ASSERT_EQ(0, collector.snapshot().status.samples);
+    ASSERT_EQ(-1.0, collector.snapshot().status.residual);
+    ASSERT_FALSE(collector.snapshot().fitValid);
+
+    turn(collector, 20, 90.0);
+    collector.solve();
+    ASSERT_FALSE(collector.snapshot().status.complete);
+    ASSERT_FALSE(collector.snapshot().fitValid);
+
+    turn(collector, 5000, 90.0);
+    // adding samples only updates the coverage
+    ASSERT_FALSE(collector.snapshot().fitValid);
+    collector.solve();
+    const sp::CalibrationSnapshot &snapshot = collector.snapshot();
+    ASSERT_TRUE(snapshot.status.complete);
+    ASSERT_TRUE(snapshot.fitValid);
+    ASSERT_FALSE(snapshot.horizontalFit);
+    ASSERT_GE(snapshot.status.coverage, 0.75);
+    ASSERT_EQ(1.0, snapshot.status.headingCoverage);
+    ASSERT_LT(snapshot.status.residual, 0.015);
+    // every cell is full, the rest of the samples were dropped
+    ASSERT_LE(snapshot.status.samples, sp::CalibrationCollector::NUM_CELLS * sp::CalibrationCollector::CELL_CAPACITY);
+    EXPECT_NEAR(420.0, snapshot.calibration.offset[0], 5.0);
+    EXPECT_NEAR(-310.0, snapshot.calibration.offset[1], 5.0);
+    EXPECT_NEAR(150.0, snapshot.calibration.offset[2], 5.0);
+
+    collector.reset();
+    ASSERT_EQ(0, collector.snapshot().status.samples);
+    ASSERT_EQ(0.0, collector.snapshot().status.coverage);
+    ASSERT_FALSE(collector.snapshot().status.complete);
+}
+
+TEST(CalibrationCollector, LevelTurnsComplete)
+{
+    // a boat turning in circles sees every heading, but only a belt of directions
+    sp::CalibrationCollector collector(1.0, 0.015);
+    turn(collector, 5000, 15.0);
+    collector.solve();
+    const sp::CalibrationSnapshot &snapshot = collector.snapshot();
+    ASSERT_EQ(1.0, snapshot.status.headingCoverage);
+    ASSERT_LT(snapshot.status.coverage, 0.5);
+    ASSERT_TRUE(snapshot.status.complete);
+    ASSERT_TRUE(snapshot.fitValid);
+    ASSERT_TRUE(snapshot.horizontalFit);
+    EXPECT_NEAR(420.0, snapshot.calibration.offset[0], 5.0);
+    EXPECT_NEAR(-310.0, snapshot.calibration.offset[1], 5.0);
+}
+
+TEST(CalibrationCollector, PartialTurnDoesntComplete)
+{
+    sp::CalibrationCollector collector(1.0, 0.015);
+    for (int i = 0; i < 1000; i++)
+    {
+        // a quarter of the circle
+        double h = (i % 90) * M_PI / 180.0;
+        collector.add(std::lround(3000.0 * std::cos(h)), std::lround(3000.0 * std::sin(h)), 0, 25.0);
+    }
+    collector.solve();
+    ASSERT_LT(collector.snapshot().status.headingCoverage, 1.0);
+    ASSERT_FALSE(collector.snapshot().status.complete);
+}
+
+TEST(CalibrationCollector, CellCapacity)
+{
+    sp::CalibrationCollector collector(0.75, 0.015);
+    // the first sample is the centre estimate itself and has no direction
+    ASSERT_FALSE(collector.add(3000, 0, 0, 25.0));
+    for (int i = 0; i < 1000; i++)
+    {
+        collector.add(3000, 0, 0, 25.0);
+        collector.add(-3000, 0, 0, 25.0);
+    }
+    ASSERT_EQ(2 * sp::CalibrationCollector::CELL_CAPACITY, collector.snapshot().status.samples);
+    ASSERT_FALSE(collector.add(-3000, 0, 0, 25.0));
+    ASSERT_TRUE(collector.add(0, 3000, 0, 25.0));
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2024 - 2025 Mikhail Sapozhnikov
+ * Copyright (C) 2024 - 2026 Mikhail Sapozhnikov
  *
  * This file is part of ship-position.
  *
@@ -20,6 +20,8 @@
 
 #include "Config.hpp"
 #include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
 
 namespace sp = ship_position;
 
@@ -37,13 +39,51 @@ TEST(Config, ConfigTest)
     ASSERT_EQ(3, gpsConfig.maxRetries);
     ASSERT_EQ("/var/run/rawgps.log", gpsConfig.rawOutput);
     ASSERT_EQ(1073741824, gpsConfig.maxRawFileSize);
+    ASSERT_EQ(4, gpsConfig.rawSegments);
+    ASSERT_TRUE(gpsConfig.rawTimestamps);
+    ASSERT_EQ("/var/run/rawgps.log.000001", gpsConfig.replayFile);
+    ASSERT_EQ(2.5, gpsConfig.replaySpeed);
+    ASSERT_EQ("nmea", gpsConfig.protocol);
+    ASSERT_EQ(5, gpsConfig.measurementRate);
+    ASSERT_EQ(38400, gpsConfig.baudRate);
+    std::vector<std::string> messages = {"GGA", "NAV-PVT"};
+    ASSERT_EQ(messages, gpsConfig.messages);
+    ASSERT_EQ(9600, gpsConfig.portBaudRate);
+    ASSERT_EQ(200, gpsConfig.vmin);
+    ASSERT_EQ(1, gpsConfig.vtime);
+    ASSERT_TRUE(gpsConfig.lowLatency);
 
     sp::QMC5883LConfig qmcConfig;
     config.getQMC5883LConfig(qmcConfig);
 
     ASSERT_EQ("/dev/i2c-99", qmcConfig.devPath);
     ASSERT_EQ(274, qmcConfig.pollTimeout);
-    ASSERT_EQ(111, qmcConfig.calibrationPollTimeout);
+    ASSERT_EQ(200, qmcConfig.outputDataRate);
+    ASSERT_EQ(2, qmcConfig.fieldRange);
+    ASSERT_EQ(128, qmcConfig.oversampling);
+    ASSERT_EQ("exponential", qmcConfig.filter);
+    ASSERT_EQ(9, qmcConfig.filterWindow);
+    ASSERT_EQ(0.35, qmcConfig.filterAlpha);
+    ASSERT_EQ(90.0, qmcConfig.mountingRotation);
+    ASSERT_TRUE(qmcConfig.mountingFlipped);
+    ASSERT_EQ(-3.25, qmcConfig.declination);
+    ASSERT_EQ("/tmp/qmc5883l-calibration-test.json", qmcConfig.calibrationFile);
+    ASSERT_EQ(0.75, qmcConfig.calibrationMinCoverage);
+    ASSERT_EQ(0.015, qmcConfig.calibrationMaxResidual);
+
+    sp::FusionConfig fusionConfig;
+    config.getFusionConfig(fusionConfig);
+
+    ASSERT_EQ(20.0, fusionConfig.publishRate);
+    ASSERT_EQ(1.5, fusionConfig.gpsTimeout);
+    ASSERT_EQ(45.0, fusionConfig.maxDeadReckoning);
+    ASSERT_FALSE(fusionConfig.useCompass);
+    ASSERT_EQ(2.5, fusionConfig.positionNoise);
+    ASSERT_EQ(0.15, fusionConfig.velocityNoise);
+    ASSERT_EQ(4.0, fusionConfig.headingNoise);
+    ASSERT_EQ(0.3, fusionConfig.accelerationNoise);
+    ASSERT_EQ(1.5, fusionConfig.turnNoise);
+    ASSERT_EQ(0.02, fusionConfig.currentNoise);
 
     sp::IPCConfig ipcConfig;
     config.getIPCConfig(ipcConfig);
@@ -54,4 +94,56 @@ TEST(Config, ConfigTest)
     ASSERT_EQ(sp::LogLevel::DEBUG, config.getLogLevel());
     ASSERT_TRUE(config.isConsoleLogEnabled());
     ASSERT_TRUE(config.isSyslogEnabled());
-}
\ No newline at end of file
+}
+TEST(Config, MissingKeysKeepDefaults)
+{
+    // config of a version without the raw recorder, receiver configuration, magnetometer settings and fusion
+    sp::Config config("./oldconfig.conf");
+
+    ASSERT_TRUE(config.isOk());
+
+    sp::BN880GPSConfig gpsConfig;
+    config.getBN880GPSConfig(gpsConfig);
+
+    ASSERT_EQ("/dev/testdevice", gpsConfig.devPath);
+    ASSERT_EQ(52428800, gpsConfig.maxRawFileSize);
+    ASSERT_EQ(1, gpsConfig.rawSegments);
+    ASSERT_FALSE(gpsConfig.rawTimestamps);
+    ASSERT_EQ("", gpsConfig.replayFile);
+    ASSERT_EQ("nmea", gpsConfig.protocol);
+    ASSERT_EQ(0, gpsConfig.measurementRate);
+    ASSERT_EQ(0, gpsConfig.baudRate);
+    ASSERT_TRUE(gpsConfig.messages.empty());
+    ASSERT_EQ(0, gpsConfig.portBaudRate);
+    ASSERT_EQ(1, gpsConfig.vmin);
+    ASSERT_EQ(0, gpsConfig.vtime);
+    ASSERT_FALSE(gpsConfig.lowLatency);
+
+    sp::QMC5883LConfig qmcConfig;
+    config.getQMC5883LConfig(qmcConfig);
+
+    ASSERT_EQ("/dev/i2c-1", qmcConfig.devPath);
+    ASSERT_EQ(10, qmcConfig.outputDataRate);
+    ASSERT_EQ(2, qmcConfig.fieldRange);
+    ASSERT_EQ(512, qmcConfig.oversampling);
+    ASSERT_EQ("none", qmcConfig.filter);
+    ASSERT_EQ("", qmcConfig.calibrationFile);
+
+    sp::FusionConfig fusionConfig;
+    config.getFusionConfig(fusionConfig);
+
+    ASSERT_EQ(10.0, fusionConfig.publishRate);
+    ASSERT_TRUE(fusionConfig.useCompass);
+}
+
+TEST(Config, InvalidConfig)
+{
+    const char *path = "/tmp/ship-position-invalid-test.conf";
+    std::ofstream out(path);
+    out << "{\"bn880GPSConfig\": {\"bufferSize\": \"large\"}}";
+    out.close();
+
+    sp::Config config(path);
+    ASSERT_FALSE(config.isOk());
+    std::remove(path);
+}
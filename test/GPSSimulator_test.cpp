@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "sim/GPSSimulator.hpp"
+#include "BN880GPSReader.hpp"
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <thread>
+
+namespace sp = ship_position;
+
+class GPSSimulatorTest : public ::testing::Test
+{
+public:
+    GPSSimulatorTest()
+    {
+        _config.bufferSize = 4096;
+        _config.maxRetries = 3;
+        _config.rawOutput = "";
+        _config.maxRawFileSize = 0;
+        _config.rawSegments = 0;
+        _config.rawTimestamps = false;
+        _config.replayFile = "";
+        _config.replaySpeed = 1.0;
+        _config.protocol = "nmea";
+        _config.measurementRate = 0;
+        _config.baudRate = 0;
+        _config.messages = {};
+        _config.portBaudRate = 0;
+        _config.vmin = 1;
+        _config.vtime = 0;
+        _config.lowLatency = false;
+    }
+
+protected:
+    // valid + invalid + truncated of all sentence types
+    uint64_t countSentences(sp::BN880GPSReader &reader, uint64_t sp::NMEASentenceCounters::*counter)
+    {
+        sp::NMEAStatistics statistics;
+        reader.getNMEAStatistics(statistics);
+        uint64_t count = 0;
+        for (size_t i = 0; i < sp::NMEAStatistics::NUM_TYPES; i++)
+        {
+            count += statistics.counters[i].*counter;
+        }
+        return count;
+    }
+
+    sp::BN880GPSConfig _config;
+};
+
+TEST_F(GPSSimulatorTest, FollowsTrack)
+{
+    sp::GPSSimulatorConfig simConfig;
+    simConfig.rate = 20.0;
+    simConfig.baudRate = 0;
+    // due north at 10 knots
+    simConfig.track = {{100.0, 10.0, 0.0, 0.0}};
+    sp::GPSSimulator simulator(simConfig);
+    ASSERT_TRUE(simulator.isOk());
+
+    _config.devPath = simulator.slavePath();
+    sp::BN880GPSReader reader(_config);
+    reader.start();
+    simulator.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(520));
+    simulator.stop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    reader.stop();
+
+    sp::GPSInfo gpsInfo;
+    reader.getGPSInfo(gpsInfo);
+    uint64_t epoch = sp::GPSSimulator::epochFromTime(simConfig.rate, gpsInfo.utcHours, gpsInfo.utcMinutes,
+        gpsInfo.utcSeconds);
+    ASSERT_EQ(simulator.epochs() - 1, epoch);
+
+    // 10 knots for epoch / 20 seconds, a minute of latitude is a nautical mile
+    double expected = simConfig.startLatitude + 10.0 * epoch / simConfig.rate / 3600.0 / 60.0;
+    ASSERT_NEAR(expected, gpsInfo.latitude, 1e-6);
+    ASSERT_NEAR(simConfig.startLongitude, gpsInfo.longitude, 1e-6);
+    ASSERT_NEAR(10.0, gpsInfo.speedKnots, 1e-3);
+    ASSERT_EQ(0, countSentences(reader, &sp::NMEASentenceCounters::invalid));
+}
+
+TEST_F(GPSSimulatorTest, NoiseAndSplitSentences)
+{
+    sp::GPSSimulatorConfig simConfig;
+    simConfig.rate = 50.0;
+    simConfig.baudRate = 0;
+    simConfig.ubx = true;
+    simConfig.corruptProbability = 0.3;
+    simConfig.splitProbability = 0.5;
+    simConfig.splitDelayUs = 1000;
+    sp::GPSSimulator simulator(simConfig);
+
+    _config.devPath = simulator.slavePath();
+    sp::BN880GPSReader reader(_config);
+    reader.start();
+    simulator.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    simulator.stop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    reader.stop();
+
+    ASSERT_GT(simulator.corrupted(), 0);
+    ASSERT_GT(simulator.split(), 0);
+    // split sentences are reassembled, corrupted ones are rejected by checksum
+    uint64_t valid = countSentences(reader, &sp::NMEASentenceCounters::valid);
+    uint64_t invalid = countSentences(reader, &sp::NMEASentenceCounters::invalid);
+    ASSERT_EQ(0, countSentences(reader, &sp::NMEASentenceCounters::truncated));
+    ASSERT_GT(valid, 0);
+    ASSERT_GT(invalid, 0);
+    ASSERT_LE(invalid, simulator.corrupted());
+    // the rest of the corrupted messages are NAV-PVT
+    ASSERT_GE(valid + invalid + simulator.epochs(), 4 * simulator.epochs());
+}
+
+TEST_F(GPSSimulatorTest, BaudPacing)
+{
+    sp::GPSSimulatorConfig simConfig;
+    simConfig.rate = 1.0;
+    simConfig.baudRate = 9600;
+    sp::GPSSimulator simulator(simConfig);
+
+    uint64_t epochTime = 0;
+    simulator.setEpochCallback([&epochTime](uint64_t epoch, uint64_t timestampNs)
+    {
+        if (epoch == 0)
+        {
+            epochTime = timestampNs;
+        }
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t startNs = std::chrono::duration_cast<std::chrono::nanoseconds>(start.time_since_epoch()).count();
+    simulator.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(400));
+    simulator.stop();
+
+    // GGA is about 75 bytes, 10 bits each at 9600 baud
+    ASSERT_EQ(1, simulator.epochs());
+    ASSERT_GT(epochTime - startNs, 60000000ULL);
+    ASSERT_LT(epochTime - startNs, 150000000ULL);
+}
+
+TEST(GPSSimulator, LoadTrack)
+{
+    char path[] = "/tmp/gps_trackXXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_NE(-1, fd);
+    close(fd);
+    std::ofstream(path) << "# duration speed course turn\n60 10 90 0\n\n30 5.5 180 -2 # turn to port\n";
+
+    std::vector<sp::SimulatorTrackLeg> track;
+    ASSERT_TRUE(sp::GPSSimulator::loadTrack(path, track));
+    ASSERT_EQ(2, track.size());
+    ASSERT_EQ(30.0, track[1].duration);
+    ASSERT_EQ(5.5, track[1].speedKnots);
+    ASSERT_EQ(180.0, track[1].course);
+    ASSERT_EQ(-2.0, track[1].turnRate);
+
+    std::ofstream(path) << "60 10 ninety 0\n";
+    ASSERT_FALSE(sp::GPSSimulator::loadTrack(path, track));
+    unlink(path);
+}
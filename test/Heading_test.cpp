@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Heading.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+
+namespace sp = ship_position;
+
+namespace
+{
+
+sp::MagnetometerData makeSample(int32_t x, int32_t y)
+{
+    sp::MagnetometerData data;
+    data.x = x;
+    data.y = y;
+    data.z = -3000;
+    data.arrivalNs = 42;
+    return data;
+}
+
+}
+
+TEST(Heading, FastAtan2Error)
+{
+    double maxError = 0.0;
+    for (int i = 0; i < 3600; i++)
+    {
+        double angle = i * M_PI / 1800.0 + 0.0001;
+        for (double radius : {1e-3, 1.0, 3000.0})
+        {
+            double y = radius * std::sin(angle);
+            double x = radius * std::cos(angle);
+            maxError = std::max(maxError, std::fabs(sp::fastAtan2(y, x) - std::atan2(y, x)));
+        }
+    }
+    ASSERT_LT(maxError, 1e-7);
+
+    ASSERT_EQ(0.0, sp::fastAtan2(0.0, 0.0));
+    ASSERT_NEAR(M_PI / 2.0, sp::fastAtan2(5.0, 0.0), 1e-7);
+    ASSERT_NEAR(-M_PI / 2.0, sp::fastAtan2(-5.0, 0.0), 1e-7);
+    ASSERT_NEAR(M_PI, sp::fastAtan2(0.0, -5.0), 1e-7);
+    ASSERT_NEAR(M_PI / 4.0, sp::fastAtan2(2.0, 2.0), 1e-7);
+}
+
+TEST(Heading, MagneticAndTrue)
+{
+    sp::HeadingCalculator calculator(0.0, false, 11.5);
+
+    // bow to magnetic north, the field is along X
+    sp::HeadingData heading = calculator.compute(makeSample(2000, 0));
+    ASSERT_NEAR(0.0, heading.magneticHeading, 1e-5);
+    ASSERT_NEAR(11.5, heading.trueHeading, 1e-5);
+    ASSERT_EQ(42, heading.arrivalNs);
+
+    // heading east, north is on the port side
+    heading = calculator.compute(makeSample(0, 2000));
+    ASSERT_NEAR(90.0, heading.magneticHeading, 1e-5);
+    ASSERT_NEAR(101.5, heading.trueHeading, 1e-5);
+
+    heading = calculator.compute(makeSample(1000, -1000));
+    ASSERT_NEAR(315.0, heading.magneticHeading, 1e-5);
+    ASSERT_NEAR(326.5, heading.trueHeading, 1e-5);
+
+    // west declination crossing north
+    sp::HeadingCalculator west(0.0, false, -10.0);
+    heading = west.compute(makeSample(2000, 100));
+    ASSERT_NEAR(std::atan2(100.0, 2000.0) * 180.0 / M_PI + 350.0, heading.trueHeading, 1e-5);
+}
+
+TEST(Heading, Mounting)
+{
+    // sensor X points to starboard, the field seen along X means the bow points west
+    sp::HeadingCalculator rotated(90.0, false, 0.0);
+    ASSERT_NEAR(270.0, rotated.compute(makeSample(2000, 0)).magneticHeading, 1e-5);
+
+    // upside down, Y points to starboard and the field on it means heading west
+    sp::HeadingCalculator flipped(0.0, true, 0.0);
+    ASSERT_NEAR(270.0, flipped.compute(makeSample(0, 2000)).magneticHeading, 1e-5);
+    ASSERT_NEAR(0.0, flipped.compute(makeSample(2000, 0)).magneticHeading, 1e-5);
+}
@@ -0,0 +1,331 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "MagnetometerCalibration.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <unistd.h>
+
+namespace sp = ship_position;
+
+namespace
+{
+
+constexpr double FIELD = 3000.0;
+constexpr double OFFSET[3] = {420.0, -310.0, 150.0};
+constexpr double SOFT_IRON[3][3] = {{1.2, 0.1, 0.0}, {0.1, 0.85, 0.05}, {0.0, 0.05, 1.0}};
+
+constexpr double DRIFT[3] = {-12.0, 7.5, 4.0};
+
+// raw readings distorted by soft and hard iron, flat keeps them level, hard iron drifts with temperature
+std::vector<sp::MagnetometerData> makeSamples(size_t count, bool flat, double noise, double span = 0.0)
+{
+    std::mt19937 random(7);
+    std::normal_distribution<double> gauss(0.0, 1.0);
+    std::normal_distribution<double> error(0.0, noise);
+    std::vector<sp::MagnetometerData> samples;
+    for (size_t i = 0; i < count; i++)
+    {
+        double v[3] = {gauss(random), gauss(random), flat ? 0.0 : gauss(random)};
+        double norm = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+        double temperature = 20.0 + span * i / count;
+        double raw[3];
+        for (size_t k = 0; k < 3; k++)
+        {
+            raw[k] = OFFSET[k] + DRIFT[k] * (temperature - 20.0) + error(random);
+            for (size_t j = 0; j < 3; j++)
+            {
+                raw[k] += SOFT_IRON[k][j] * v[j] / norm * FIELD;
+            }
+        }
+        sp::MagnetometerData data;
+        data.x = std::lround(raw[0]);
+        data.y = std::lround(raw[1]);
+        data.z = std::lround(raw[2]);
+        data.temperature = temperature;
+        samples.push_back(data);
+    }
+    return samples;
+}
+
+double magnitude(const sp::MagnetometerData &data)
+{
+    return std::sqrt(double(data.x) * data.x + double(data.y) * data.y + double(data.z) * data.z);
+}
+
+}
+
+TEST(MagnetometerCalibration, Identity)
+{
+    sp::MagnetometerCalibration calibration;
+    sp::MagnetometerData data;
+    calibration.apply(1234, -567, 89, 25.0, data);
+    ASSERT_EQ(1234, data.x);
+    ASSERT_EQ(-567, data.y);
+    ASSERT_EQ(89, data.z);
+}
+
+TEST(MagnetometerCalibration, FitEllipsoid)
+{
+    std::vector<sp::MagnetometerData> samples = makeSamples(500, false, 3.0);
+    sp::MagnetometerCalibration calibration;
+    ASSERT_TRUE(sp::fitEllipsoid(samples, calibration));
+
+    for (size_t k = 0; k < 3; k++)
+    {
+        EXPECT_NEAR(OFFSET[k], calibration.offset[k], 5.0);
+    }
+
+    // raw magnitudes vary by a third, corrected ones lie on a sphere
+    double minMagnitude = 1e9;
+    double maxMagnitude = 0.0;
+    for (const sp::MagnetometerData &sample : samples)
+    {
+        sp::MagnetometerData corrected;
+        calibration.apply(sample.x, sample.y, sample.z, sample.temperature, corrected);
+        minMagnitude = std::min(minMagnitude, magnitude(corrected));
+        maxMagnitude = std::max(maxMagnitude, magnitude(corrected));
+    }
+    EXPECT_LT((maxMagnitude - minMagnitude) / maxMagnitude, 0.01);
+    // the volume is kept, the radius stays near the geometric mean of the distorted axes
+    EXPECT_NEAR(FIELD * std::cbrt(1.2 * 0.85 * 1.0), (maxMagnitude + minMagnitude) / 2.0, 100.0);
+}
+
+TEST(MagnetometerCalibration, Residual)
+{
+    // radial noise relative to the radius of about 3000
+    for (double noise : {0.0, 15.0, 30.0})
+    {
+        sp::EllipsoidFit fit;
+        for (const sp::MagnetometerData &sample : makeSamples(2000, false, noise))
+        {
+            fit.add(sample.x, sample.y, sample.z, sample.temperature);
+        }
+        ASSERT_EQ(2000, fit.samples());
+
+        sp::MagnetometerCalibration calibration;
+        double residual = -1.0;
+        ASSERT_TRUE(fit.solve(calibration, residual));
+        EXPECT_NEAR(noise / 3000.0, residual, 0.2 * noise / 3000.0 + 0.0005);
+    }
+}
+
+TEST(MagnetometerCalibration, ApplyTemperature)
+{
+    sp::MagnetometerCalibration calibration;
+    calibration.offset[0] = 100.0;
+    calibration.temperatureCoefficients[0] = -10.0;
+    calibration.temperatureCoefficients[2] = 5.0;
+    calibration.referenceTemperature = 20.0;
+
+    sp::MagnetometerData data;
+    calibration.apply(1000, 0, 0, 30.0, data);
+    ASSERT_EQ(1000, data.x);
+    ASSERT_EQ(0, data.y);
+    ASSERT_EQ(-50, data.z);
+
+    sp::TemperatureCompensation compensation = calibration.compensation(30.0);
+    ASSERT_DOUBLE_EQ(30.0, compensation.temperature);
+    ASSERT_DOUBLE_EQ(20.0, compensation.referenceTemperature);
+    ASSERT_DOUBLE_EQ(-10.0, compensation.coefficients[0]);
+    ASSERT_DOUBLE_EQ(-100.0, compensation.correction[0]);
+    ASSERT_DOUBLE_EQ(0.0, compensation.correction[1]);
+    ASSERT_DOUBLE_EQ(50.0, compensation.correction[2]);
+}
+
+TEST(MagnetometerCalibration, FitTemperatureDrift)
+{
+    std::vector<sp::MagnetometerData> samples = makeSamples(2000, false, 3.0, 15.0);
+    sp::EllipsoidFit fit;
+    for (const sp::MagnetometerData &sample : samples)
+    {
+        fit.add(sample.x, sample.y, sample.z, sample.temperature);
+    }
+    ASSERT_NEAR(15.0, fit.temperatureSpan(), 0.01);
+    ASSERT_TRUE(fit.fitsTemperature());
+
+    sp::MagnetometerCalibration calibration;
+    double residual = -1.0;
+    ASSERT_TRUE(fit.solve(calibration, residual));
+    EXPECT_LT(residual, 0.002);
+    ASSERT_DOUBLE_EQ(20.0, calibration.referenceTemperature);
+    for (size_t k = 0; k < 3; k++)
+    {
+        EXPECT_NEAR(OFFSET[k], calibration.offset[k], 5.0);
+        EXPECT_NEAR(DRIFT[k], calibration.temperatureCoefficients[k], 0.5);
+    }
+
+    // the drift of up to 180 units is removed, the corrected samples lie on a sphere
+    double minMagnitude = 1e9;
+    double maxMagnitude = 0.0;
+    for (const sp::MagnetometerData &sample : samples)
+    {
+        sp::MagnetometerData corrected;
+        calibration.apply(sample.x, sample.y, sample.z, sample.temperature, corrected);
+        minMagnitude = std::min(minMagnitude, magnitude(corrected));
+        maxMagnitude = std::max(maxMagnitude, magnitude(corrected));
+    }
+    EXPECT_LT((maxMagnitude - minMagnitude) / maxMagnitude, 0.01);
+}
+
+TEST(MagnetometerCalibration, SmallTemperatureSpan)
+{
+    sp::EllipsoidFit fit;
+    for (const sp::MagnetometerData &sample : makeSamples(2000, false, 3.0, 2.0))
+    {
+        fit.add(sample.x, sample.y, sample.z, sample.temperature);
+    }
+    ASSERT_FALSE(fit.fitsTemperature());
+
+    // the offset is that at the mean temperature, no drift is claimed
+    sp::MagnetometerCalibration calibration;
+    double residual = -1.0;
+    ASSERT_TRUE(fit.solve(calibration, residual));
+    EXPECT_NEAR(21.0, calibration.referenceTemperature, 0.01);
+    for (size_t k = 0; k < 3; k++)
+    {
+        EXPECT_NEAR(OFFSET[k] + DRIFT[k], calibration.offset[k], 5.0);
+        ASSERT_EQ(0.0, calibration.temperatureCoefficients[k]);
+    }
+}
+
+TEST(MagnetometerCalibration, InheritTemperatureDrift)
+{
+    sp::MagnetometerCalibration previous;
+    previous.offset[0] = 100.0;
+    previous.offset[1] = 50.0;
+    previous.temperatureCoefficients[2] = 3.0;
+    previous.referenceTemperature = 10.0;
+
+    // far enough from the previous calibration, the drift follows from the two offsets
+    sp::MagnetometerCalibration calibration;
+    calibration.offset[0] = 40.0;
+    calibration.offset[1] = 50.0;
+    calibration.offset[2] = 20.0;
+    calibration.referenceTemperature = 30.0;
+    sp::inheritTemperatureDrift(previous, calibration);
+    ASSERT_DOUBLE_EQ(-3.0, calibration.temperatureCoefficients[0]);
+    ASSERT_DOUBLE_EQ(0.0, calibration.temperatureCoefficients[1]);
+    ASSERT_DOUBLE_EQ(1.0, calibration.temperatureCoefficients[2]);
+    ASSERT_DOUBLE_EQ(40.0, calibration.offset[0]);
+
+    // too close, the previous coefficients are kept
+    calibration.referenceTemperature = 12.0;
+    sp::inheritTemperatureDrift(previous, calibration);
+    ASSERT_DOUBLE_EQ(0.0, calibration.temperatureCoefficients[0]);
+    ASSERT_DOUBLE_EQ(3.0, calibration.temperatureCoefficients[2]);
+}
+
+TEST(MagnetometerCalibration, FitHorizontal)
+{
+    // turned around the vertical axis only
+    for (double span : {0.0, 10.0})
+    {
+        std::vector<sp::MagnetometerData> samples = makeSamples(500, true, 3.0, span);
+        sp::EllipsoidFit fit;
+        for (const sp::MagnetometerData &sample : samples)
+        {
+            fit.add(sample.x, sample.y, sample.z, sample.temperature);
+        }
+        ASSERT_TRUE(fit.isHorizontal());
+
+        sp::MagnetometerCalibration calibration;
+        double residual = -1.0;
+        ASSERT_TRUE(fit.solve(calibration, residual));
+        EXPECT_LT(residual, 0.005);
+        for (size_t k = 0; k < 2; k++)
+        {
+            EXPECT_NEAR(OFFSET[k], calibration.offset[k] - calibration.temperatureCoefficients[k] *
+                (calibration.referenceTemperature - 20.0), 5.0);
+            EXPECT_NEAR(span > 0.0 ? DRIFT[k] : 0.0, calibration.temperatureCoefficients[k], 1.0);
+        }
+        EXPECT_EQ(1.0, calibration.matrix[2][2]);
+
+        // corrected horizontal components lie on a circle
+        double minMagnitude = 1e9;
+        double maxMagnitude = 0.0;
+        for (const sp::MagnetometerData &sample : samples)
+        {
+            sp::MagnetometerData corrected;
+            calibration.apply(sample.x, sample.y, sample.z, sample.temperature, corrected);
+            double horizontal = std::hypot(corrected.x, corrected.y);
+            minMagnitude = std::min(minMagnitude, horizontal);
+            maxMagnitude = std::max(maxMagnitude, horizontal);
+        }
+        EXPECT_LT((maxMagnitude - minMagnitude) / maxMagnitude, 0.01);
+    }
+}
+
+TEST(MagnetometerCalibration, FitRejectsDegenerateSamples)
+{
+    sp::MagnetometerCalibration calibration;
+    ASSERT_FALSE(sp::fitEllipsoid(makeSamples(sp::CALIBRATION_MIN_SAMPLES - 1, false, 3.0), calibration));
+    ASSERT_FALSE(sp::fitEllipsoid(std::vector<sp::MagnetometerData>(100), calibration));
+
+    // nothing is changed on failure
+    ASSERT_EQ(0.0, calibration.offset[0]);
+    ASSERT_EQ(1.0, calibration.matrix[0][0]);
+}
+
+TEST(MagnetometerCalibration, SaveLoad)
+{
+    char path[] = "/tmp/qmc5883l_calibrationXXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_NE(-1, fd);
+    close(fd);
+
+    sp::MagnetometerCalibration saved;
+    ASSERT_TRUE(sp::fitEllipsoid(makeSamples(500, false, 3.0, 10.0), saved));
+    ASSERT_NE(0.0, saved.temperatureCoefficients[0]);
+    ASSERT_TRUE(sp::saveCalibration(path, saved));
+
+    sp::MagnetometerCalibration loaded;
+    ASSERT_TRUE(sp::loadCalibration(path, loaded));
+    for (size_t i = 0; i < 3; i++)
+    {
+        ASSERT_DOUBLE_EQ(saved.offset[i], loaded.offset[i]);
+        for (size_t j = 0; j < 3; j++)
+        {
+            ASSERT_DOUBLE_EQ(saved.matrix[i][j], loaded.matrix[i][j]);
+        }
+        ASSERT_DOUBLE_EQ(saved.temperatureCoefficients[i], loaded.temperatureCoefficients[i]);
+    }
+    ASSERT_DOUBLE_EQ(saved.referenceTemperature, loaded.referenceTemperature);
+
+    // written before the thermal drift was fitted
+    std::ofstream(path) << "{\"offset\": [1, 2, 3], \"matrix\": [[1, 0, 0], [0, 1, 0], [0, 0, 1]]}\n";
+    ASSERT_TRUE(sp::loadCalibration(path, loaded));
+    ASSERT_DOUBLE_EQ(3.0, loaded.offset[2]);
+    ASSERT_EQ(0.0, loaded.temperatureCoefficients[0]);
+    ASSERT_EQ(0.0, loaded.referenceTemperature);
+    std::ofstream(path) << "{\"offset\": [1, 2, 3], \"matrix\": [[1, 0, 0], [0, 1, 0], [0, 0, 1]], "
+                           "\"temperatureCoefficients\": [1, 2]}\n";
+    ASSERT_FALSE(sp::loadCalibration(path, loaded));
+
+    std::ofstream(path) << "{\"offset\": [1, 2], \"matrix\": [[1, 0, 0], [0, 1, 0], [0, 0, 1]]}\n";
+    ASSERT_FALSE(sp::loadCalibration(path, loaded));
+    std::ofstream(path) << "{\"offset\": [1, 2,";
+    ASSERT_FALSE(sp::loadCalibration(path, loaded));
+    unlink(path);
+    ASSERT_FALSE(sp::loadCalibration(path, loaded));
+    ASSERT_DOUBLE_EQ(1.0, loaded.offset[0]);
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "MagnetometerFilter.hpp"
+#include <gtest/gtest.h>
+
+namespace sp = ship_position;
+
+namespace
+{
+
+sp::MagnetometerData makeSample(int32_t x, int32_t y, int32_t z, uint64_t arrivalNs = 0)
+{
+    sp::MagnetometerData data;
+    data.x = x;
+    data.y = y;
+    data.z = z;
+    data.arrivalNs = arrivalNs;
+    return data;
+}
+
+}
+
+TEST(MagnetometerFilter, ParseType)
+{
+    sp::MagnetometerFilterType type;
+    ASSERT_TRUE(sp::MagnetometerFilter::parseType("median", type));
+    ASSERT_EQ(sp::MagnetometerFilterType::MEDIAN, type);
+    ASSERT_TRUE(sp::MagnetometerFilter::parseType("average", type));
+    ASSERT_EQ(sp::MagnetometerFilterType::MOVING_AVERAGE, type);
+    ASSERT_FALSE(sp::MagnetometerFilter::parseType("kalman", type));
+}
+
+TEST(MagnetometerFilter, MovingAverage)
+{
+    sp::MagnetometerFilter filter(sp::MagnetometerFilterType::MOVING_AVERAGE, 3, 0.0);
+    sp::MagnetometerData data = filter.update(makeSample(10, -10, 0, 123));
+    ASSERT_EQ(10, data.x);
+    ASSERT_EQ(123, data.arrivalNs);
+    data = filter.update(makeSample(20, -20, 0));
+    ASSERT_EQ(15, data.x);
+    ASSERT_EQ(-15, data.y);
+    data = filter.update(makeSample(60, -60, 3));
+    ASSERT_EQ(30, data.x);
+    ASSERT_EQ(-30, data.y);
+    ASSERT_EQ(1, data.z);
+    // 10 leaves the window
+    data = filter.update(makeSample(100, -100, 0));
+    ASSERT_EQ(60, data.x);
+    ASSERT_EQ(-60, data.y);
+}
+
+TEST(MagnetometerFilter, Median)
+{
+    sp::MagnetometerFilter filter(sp::MagnetometerFilterType::MEDIAN, 5, 0.0);
+    const int32_t input[] = {100, 102, 5000, 101, 99, -4000, 103, 98};
+    // medians of the last up to five values
+    const int32_t expected[] = {100, 101, 102, 102, 101, 101, 101, 99};
+    for (size_t i = 0; i < sizeof(input) / sizeof(input[0]); i++)
+    {
+        sp::MagnetometerData data = filter.update(makeSample(input[i], -input[i], 7));
+        ASSERT_EQ(expected[i], data.x) << "sample " << i;
+        ASSERT_EQ(-expected[i], data.y) << "sample " << i;
+        ASSERT_EQ(7, data.z);
+    }
+
+    filter.reset();
+    ASSERT_EQ(1, filter.update(makeSample(1, 1, 1)).x);
+}
+
+TEST(MagnetometerFilter, Exponential)
+{
+    sp::MagnetometerFilter filter(sp::MagnetometerFilterType::EXPONENTIAL, 1, 0.25);
+    ASSERT_EQ(1000, filter.update(makeSample(1000, 0, 0)).x);
+    ASSERT_EQ(1250, filter.update(makeSample(2000, 0, 0)).x);
+    ASSERT_EQ(1438, filter.update(makeSample(2000, 0, 0)).x);
+}
+
+TEST(MagnetometerFilter, None)
+{
+    sp::MagnetometerFilter filter(sp::MagnetometerFilterType::NONE, 5, 0.5);
+    filter.update(makeSample(1000, 0, 0));
+    ASSERT_EQ(-7, filter.update(makeSample(-7, 0, 0)).x);
+}
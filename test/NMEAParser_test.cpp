@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2024 Mikhail Sapozhnikov
+ * Copyright (C) 2024 - 2026 Mikhail Sapozhnikov
  *
  * This file is part of ship-position.
  *
@@ -19,52 +19,124 @@
  */
 
 #include "NMEAParser.hpp"
+#include "NMEAChecksum.hpp"
 #include <gtest/gtest.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace sp = ship_position;
 
+// counts heap allocations made by the current thread
+static thread_local size_t allocations = 0;
+
+void *operator new(std::size_t size)
+{
+    allocations++;
+    void *ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
 class NMEAParserAdapter : public sp::NMEAParser
 {
 public:
-    void split(const std::string &data, const std::string &delimiter, std::vector<std::string> &tokens)
+    std::vector<std::string_view> split(std::string_view data, char delimiter)
     {
-        NMEAParser::split(data, delimiter, tokens);
+        std::string_view tokens[sp::NMEAFields::MAX_FIELDS];
+        size_t count = NMEAParser::split(data, delimiter, tokens, sp::NMEAFields::MAX_FIELDS);
+        return std::vector<std::string_view>(tokens, tokens + count);
     }
+
+    using NMEAParser::parseCoordinates;
+    using NMEAParser::parseDouble;
+    using NMEAParser::parseInt;
 };
 
 TEST(NMEAParser, Split_Simple)
 {
     NMEAParserAdapter parserAdapter;
     std::string data = "text,which,needs,to,be,separated";
-    std::string delimiter = ",";
-    std::vector<std::string> expected = {"text", "which", "needs", "to", "be", "separated"};
-    std::vector<std::string> actual;
-    parserAdapter.split(data, delimiter, actual);
-    ASSERT_EQ(expected, actual);
+    std::vector<std::string_view> expected = {"text", "which", "needs", "to", "be", "separated"};
+    ASSERT_EQ(expected, parserAdapter.split(data, ','));
 }
 
 TEST(NMEAParser, Split_NoDelimiter)
 {
     NMEAParserAdapter parserAdapter;
     std::string data = "text";
-    std::string delimiter = ",";
-    std::vector<std::string> expected = {"text"};
-    std::vector<std::string> actual;
-    parserAdapter.split(data, delimiter, actual);
-    ASSERT_EQ(expected, actual);
+    std::vector<std::string_view> expected = {"text"};
+    ASSERT_EQ(expected, parserAdapter.split(data, ','));
 }
 
 TEST(NMEAParser, Split_EmptyData)
 {
     NMEAParserAdapter parserAdapter;
     std::string data = "";
-    std::string delimiter = ",";
-    std::vector<std::string> expected = {};
-    std::vector<std::string> actual;
-    parserAdapter.split(data, delimiter, actual);
-    ASSERT_EQ(expected, actual);
+    std::vector<std::string_view> expected = {};
+    ASSERT_EQ(expected, parserAdapter.split(data, ','));
+}
+
+TEST(NMEAParser, Split_EmptyFields)
+{
+    NMEAParserAdapter parserAdapter;
+    std::string data = "$GNVTG,,T,,M,";
+    std::vector<std::string_view> expected = {"$GNVTG", "", "T", "", "M", ""};
+    ASSERT_EQ(expected, parserAdapter.split(data, ','));
+}
+
+TEST(NMEAParser, Split_TooManyFields)
+{
+    NMEAParserAdapter parserAdapter;
+    std::string data(100, ',');
+    ASSERT_EQ(sp::NMEAFields::MAX_FIELDS, parserAdapter.split(data, ',').size());
+}
+
+TEST(NMEAParser, Parse_NoAllocations)
+{
+    sp::NMEAParser parser;
+    std::vector<std::string> sentences = {
+        "$GNRMC,170257.00,A,5619.06488,N,04401.12281,E,0.071,,300324,,,A*68",
+        "$GNVTG,,T,,M,0.071,N,0.131,K,A*38",
+        "$GNGGA,170257.00,5619.06488,N,04401.12281,E,1,09,1.36,124.2,M,6.3,M,,*79",
+        "$GNGSA,A,3,02,23,10,14,22,32,21,,,,,,2.67,1.36,2.29*17",
+        "$GPGSV,3,1,09,02,27,297,26,10,72,079,34,14,11,333,27,18,00,120,*79",
+        "$GNGLL,5619.06488,N,04401.12281,E,170257.00,A,A*71"
+    };
+    std::string data;
+    for (auto &sentence : sentences)
+    {
+        data += sentence + "\r\n";
+    }
+
+    sp::GPSInfo gpsInfo;
+    size_t before = allocations;
+    for (auto &sentence : sentences)
+    {
+        parser.parseSentence(sentence, gpsInfo);
+    }
+    ASSERT_EQ(0, allocations - before);
+
+    before = allocations;
+    parser.parse(data, gpsInfo);
+    ASSERT_EQ(0, allocations - before);
+    ASSERT_EQ(9, gpsInfo.numSatellites);
 }
 
 TEST(NMEAParser, Parse_NorthEast)
@@ -90,16 +162,28 @@ $GNGLL,5619.06488,N,04401.12281,E,170257.00,A,A*71
     ASSERT_EQ(44.0187135, gpsInfo.longitude);
     ASSERT_EQ(0.071, gpsInfo.speedKnots);
     ASSERT_EQ(0.131, gpsInfo.speedKm);
+    ASSERT_EQ(124.2, gpsInfo.altitude);
+    ASSERT_EQ(1, gpsInfo.fixQuality);
+    ASSERT_EQ(3, gpsInfo.fixMode);
+    ASSERT_EQ(2.67, gpsInfo.pdop);
+    ASSERT_EQ(1.36, gpsInfo.hdop);
+    ASSERT_EQ(2.29, gpsInfo.vdop);
+    ASSERT_EQ(2024, gpsInfo.utcYear);
+    ASSERT_EQ(3, gpsInfo.utcMonth);
+    ASSERT_EQ(30, gpsInfo.utcDay);
+    ASSERT_EQ(17, gpsInfo.utcHours);
+    ASSERT_EQ(2, gpsInfo.utcMinutes);
+    ASSERT_EQ(57.0, gpsInfo.utcSeconds);
 }
 
 TEST(NMEAParser, Parse_NorthWest)
 {
     sp::NMEAParser parser;
-    std::string data = R"($GNRMC,170257.00,A,5619.06488,N,04401.12281,E,0.071,,300324,,,A*68
-$GNGGA,170259.00,5619.06488,N,04401.12281,W,1,09,1.36,124.2,M,6.3,M,,*79
+    std::string data = R"($GNRMC,170257.00,A,5619.06488,N,04401.12281,W,0.071,,300324,,,A*7A
+$GNGGA,170259.00,5619.06488,N,04401.12281,W,1,09,1.36,124.2,M,6.3,M,,*65
 $GLGSV,3,2,10,77,04,303,,78,17,357,30,79,07,045,,85,48,146,18*69
 $GLGSV,3,3,10,86,74,300,23,87,20,314,*60
-$GNGLL,5619.06488,N,04401.12281,E,170257.00,A,A*71
+$GNGLL,5619.06488,N,04401.12281,W,170257.00,A,A*63
 )";
     sp::GPSInfo gpsInfo;
     parser.parse(data, gpsInfo);
@@ -110,11 +194,11 @@ $GNGLL,5619.06488,N,04401.12281,E,170257.00,A,A*71
 TEST(NMEAParser, Parse_SouthWest)
 {
     sp::NMEAParser parser;
-    std::string data = R"($GNRMC,170257.00,A,5619.06488,N,04401.12281,E,0.071,,300324,,,A*68
-$GNGGA,170259.00,5619.06488,S,04401.12281,W,1,09,1.36,124.2,M,6.3,M,,*79
+    std::string data = R"($GNRMC,170257.00,A,5619.06488,S,04401.12281,W,0.071,,300324,,,A*67
+$GNGGA,170259.00,5619.06488,S,04401.12281,W,1,09,1.36,124.2,M,6.3,M,,*78
 $GLGSV,3,2,10,77,04,303,,78,17,357,30,79,07,045,,85,48,146,18*69
 $GLGSV,3,3,10,86,74,300,23,87,20,314,*60
-$GNGLL,5619.06488,N,04401.12281,E,170257.00,A,A*71
+$GNGLL,5619.06488,S,04401.12281,W,170257.00,A,A*7E
 )";
     sp::GPSInfo gpsInfo;
     parser.parse(data, gpsInfo);
@@ -129,9 +213,311 @@ TEST(NMEAParser, Incomplete_Sentence)
 $GNGGA,170259.00,5619.06488,N,04401.12281)";
     sp::GPSInfo gpsInfo;
     parser.parse(data, gpsInfo);
-    ASSERT_EQ(0, gpsInfo.latitude);
-    ASSERT_EQ(0, gpsInfo.longitude);
+    // the position comes from RMC, the incomplete GGA is ignored
+    ASSERT_EQ(56.317748, gpsInfo.latitude);
+    ASSERT_EQ(44.0187135, gpsInfo.longitude);
     ASSERT_EQ(0, gpsInfo.numSatellites);
     ASSERT_EQ(0, gpsInfo.speedKm);
     ASSERT_EQ(0, gpsInfo.speedKnots);
+}
+
+TEST(NMEAParser, ParseCoordinates)
+{
+    double coordinates = 0.0;
+    ASSERT_TRUE(NMEAParserAdapter::parseCoordinates("5619.06488", "N", coordinates));
+    ASSERT_EQ(56.317748, coordinates);
+    ASSERT_TRUE(NMEAParserAdapter::parseCoordinates("04401.12281", "W", coordinates));
+    ASSERT_EQ(-44.0187135, coordinates);
+    ASSERT_TRUE(NMEAParserAdapter::parseCoordinates("13730.00000", "E", coordinates));
+    ASSERT_EQ(137.5, coordinates);
+    ASSERT_TRUE(NMEAParserAdapter::parseCoordinates("0030.0", "S", coordinates));
+    ASSERT_EQ(-0.5, coordinates);
+    ASSERT_TRUE(NMEAParserAdapter::parseCoordinates("00000.00000", "E", coordinates));
+    ASSERT_EQ(0.0, coordinates);
+}
+
+TEST(NMEAParser, ParseCoordinates_Malformed)
+{
+    double coordinates = 1.0;
+    ASSERT_FALSE(NMEAParserAdapter::parseCoordinates("", "N", coordinates));
+    ASSERT_FALSE(NMEAParserAdapter::parseCoordinates("5619.06488", "", coordinates));
+    ASSERT_FALSE(NMEAParserAdapter::parseCoordinates("5619.06488", "X", coordinates));
+    ASSERT_FALSE(NMEAParserAdapter::parseCoordinates("19.06488", "N", coordinates));
+    ASSERT_FALSE(NMEAParserAdapter::parseCoordinates("5679.06488", "N", coordinates));
+    ASSERT_FALSE(NMEAParserAdapter::parseCoordinates("9119.06488", "N", coordinates));
+    ASSERT_FALSE(NMEAParserAdapter::parseCoordinates("56a9.06488", "N", coordinates));
+    ASSERT_FALSE(NMEAParserAdapter::parseCoordinates("5619.06488*7", "N", coordinates));
+    ASSERT_EQ(1.0, coordinates);
+}
+
+TEST(NMEAParser, ParseNumbers)
+{
+    int i = 7;
+    double d = 7.0;
+    ASSERT_TRUE(NMEAParserAdapter::parseInt("09", i));
+    ASSERT_EQ(9, i);
+    ASSERT_FALSE(NMEAParserAdapter::parseInt("", i));
+    ASSERT_FALSE(NMEAParserAdapter::parseInt("1a", i));
+    ASSERT_EQ(9, i);
+    ASSERT_TRUE(NMEAParserAdapter::parseDouble("0.131", d));
+    ASSERT_EQ(0.131, d);
+    ASSERT_TRUE(NMEAParserAdapter::parseDouble("-12.5", d));
+    ASSERT_EQ(-12.5, d);
+    ASSERT_FALSE(NMEAParserAdapter::parseDouble("A*38", d));
+    ASSERT_FALSE(NMEAParserAdapter::parseDouble("1e5", d));
+    ASSERT_EQ(-12.5, d);
+}
+
+TEST(NMEAParser, Parse_MalformedFields)
+{
+    sp::NMEAParser parser;
+    std::string data = R"($GNGGA,170257.00,5619.06488,N,04401.12281,E,1,09,1.36,124.2,M,6.3,M,,*79
+$GNGGA,170258.00,56X9.06488,N,,E,1,nine,1.36,124.2,M,6.3,M,,*3D
+$GNVTG,,T,,M,fast,N,0..1,K,A*3C
+)";
+    sp::GPSInfo gpsInfo;
+    ASSERT_NO_THROW(parser.parse(data, gpsInfo));
+    ASSERT_EQ(56.317748, gpsInfo.latitude);
+    ASSERT_EQ(44.0187135, gpsInfo.longitude);
+    ASSERT_EQ(9, gpsInfo.numSatellites);
+    ASSERT_EQ(0, gpsInfo.speedKnots);
+    ASSERT_EQ(0, gpsInfo.speedKm);
+}
+
+TEST(NMEAParser, Parse_ChecksumMismatch)
+{
+    sp::NMEAParser parser;
+    std::string data = R"($GNGGA,170257.00,5619.06488,N,04401.12281,E,1,09,1.36,124.2,M,6.3,M,,*79
+$GNGGA,170259.00,5619.06488,S,04401.12281,W,1,09,1.36,124.2,M,6.3,M,,*79
+)";
+    sp::GPSInfo gpsInfo;
+    parser.parse(data, gpsInfo);
+    ASSERT_EQ(56.317748, gpsInfo.latitude);
+    ASSERT_EQ(44.0187135, gpsInfo.longitude);
+}
+
+TEST(NMEAParser, Checksum)
+{
+    std::string data;
+    for (int i = 0; i < 300; i++)
+    {
+        data += static_cast<char>(' ' + (i * 37) % 90);
+    }
+
+    // compare vectorized reduction to plain XOR for all lengths and alignments
+    for (size_t offset = 0; offset < 16; offset++)
+    {
+        for (size_t length = 0; offset + length <= data.size(); length++)
+        {
+            uint8_t expected = 0;
+            for (size_t i = offset; i < offset + length; i++)
+            {
+                expected ^= static_cast<uint8_t>(data[i]);
+            }
+            ASSERT_EQ(expected, sp::nmeaChecksum(data.data() + offset, length));
+        }
+    }
+
+    ASSERT_TRUE(sp::verifyNMEAChecksum("$GNVTG,,T,,M,0.071,N,0.131,K,A*38"));
+    ASSERT_TRUE(sp::verifyNMEAChecksum("$GPGSV,3,3,09,32,50,156,28*4c"));
+    ASSERT_FALSE(sp::verifyNMEAChecksum("$GNVTG,,T,,M,0.071,N,0.131,K,A*39"));
+    ASSERT_FALSE(sp::verifyNMEAChecksum("$GNVTG,,T,,M,0.071,N,0.131,K,A"));
+    ASSERT_FALSE(sp::verifyNMEAChecksum("GNVTG,,T,,M,0.071,N,0.131,K,A*38"));
+    ASSERT_FALSE(sp::verifyNMEAChecksum("$*0"));
+}
+
+TEST(NMEAParser, ParseSentence_RejectsCorrupt)
+{
+    sp::NMEAParser parser;
+    sp::GPSInfo gpsInfo;
+    // a digit of the latitude flipped by line noise
+    parser.parseSentence("$GNGGA,170257.00,5619.96488,N,04401.12281,E,1,09,1.36,124.2,M,6.3,M,,*79", gpsInfo);
+    ASSERT_EQ(0, gpsInfo.latitude);
+    parser.parseSentence("$GNGGA,170257.00,5619.06488,N,04401.12281,E,1,09,1.36,124.2,M,6.3,M,,", gpsInfo);
+    ASSERT_EQ(0, gpsInfo.latitude);
+    parser.parseSentence("$GNGGA,170257.00,5619.06488,N,04401.12281,E,1,09,1.36,124.2,M,6.3,M,,*79", gpsInfo);
+    ASSERT_EQ(56.317748, gpsInfo.latitude);
+
+    const sp::NMEAStatistics &statistics = parser.getStatistics();
+    ASSERT_EQ(1, statistics.counters[0].valid);
+    ASSERT_EQ(2, statistics.counters[0].invalid);
+}
+
+TEST(NMEAParser, Statistics)
+{
+    sp::NMEAParser parser;
+    std::string data = R"($GNRMC,170257.00,A,5619.06488,N,04401.12281,E,0.071,,300324,,,A*68
+$GNVTG,,T,,M,0.071,N,0.131,K,A*38
+$GNGGA,170257.00,5619.06488,N,04401.12281,E,1,09,1.36,124.2,M,6.3,M,,*79
+$GNGSA,A,3,02,23,10,14,22,32,21,,,,,,2.67,1.36,2.29*16
+$GPGSV,3,3,09,32,50,156,28*4C
+$GLGSV,3,3,10,86,74,300,23,87,20,314,*60
+$GPTXT,01,01,02,ANTSTATUS=OK*3B
+$GNGLL,5619.06488,N,04401.12281,E,170257.00,A,A*71
+$GNGGA,170259.00,5619.06488,N,04401.12281)";
+    sp::GPSInfo gpsInfo;
+    parser.parse(data, gpsInfo);
+    parser.parse("$GNZDA,170257.00,30,03,2024,00,00\n", gpsInfo);
+
+    const sp::NMEAStatistics &statistics = parser.getStatistics();
+    auto counters = [&statistics](const std::string &type) -> const sp::NMEASentenceCounters &
+    {
+        for (size_t i = 0; i < sp::NMEAStatistics::NUM_TYPES; i++)
+        {
+            if (type == sp::NMEAStatistics::TYPES[i])
+            {
+                return statistics.counters[i];
+            }
+        }
+        throw std::runtime_error("unknown type");
+    };
+
+    ASSERT_EQ(1, counters("GGA").valid);
+    ASSERT_EQ(0, counters("GGA").invalid);
+    ASSERT_EQ(0, counters("GGA").truncated);
+    ASSERT_EQ(1, counters("RMC").valid);
+    ASSERT_EQ(1, counters("VTG").valid);
+    ASSERT_EQ(0, counters("GSA").valid);
+    ASSERT_EQ(1, counters("GSA").invalid);
+    ASSERT_EQ(2, counters("GSV").valid);
+    ASSERT_EQ(1, counters("GLL").valid);
+    ASSERT_EQ(1, counters("ZDA").truncated);
+    ASSERT_EQ(1, counters("other").valid);
+}
+
+TEST(NMEAParser, Parse_RMC_ZDA)
+{
+    sp::NMEAParser parser;
+    std::string data = R"($GPRMC,083559.00,A,4717.11437,N,00833.91522,E,0.004,77.52,091202,,,A*57
+$GNZDA,235959.50,31,12,2023,00,00*7E
+$GNRMC,000000.00,V,,,,,,,010124,,,N*65
+)";
+    sp::GPSInfo gpsInfo;
+    parser.parse(data, gpsInfo);
+    // void RMC updates time and date but not course
+    ASSERT_EQ(77.52, gpsInfo.courseOverGround);
+    ASSERT_EQ(2024, gpsInfo.utcYear);
+    ASSERT_EQ(1, gpsInfo.utcMonth);
+    ASSERT_EQ(1, gpsInfo.utcDay);
+    ASSERT_EQ(0, gpsInfo.utcHours);
+    ASSERT_EQ(0, gpsInfo.utcMinutes);
+    ASSERT_EQ(0.0, gpsInfo.utcSeconds);
+    // valid RMC sets the position, void RMC leaves it
+    ASSERT_NEAR(47.285240, gpsInfo.latitude, 1e-6);
+    ASSERT_NEAR(8.565254, gpsInfo.longitude, 1e-6);
+
+    parser.parse("$GNZDA,235959.50,31,12,2023,00,00*7E\r\n", gpsInfo);
+    ASSERT_EQ(2023, gpsInfo.utcYear);
+    ASSERT_EQ(12, gpsInfo.utcMonth);
+    ASSERT_EQ(31, gpsInfo.utcDay);
+    ASSERT_EQ(23, gpsInfo.utcHours);
+    ASSERT_EQ(59, gpsInfo.utcMinutes);
+    ASSERT_EQ(59.5, gpsInfo.utcSeconds);
+}
+
+TEST(NMEAParser, Parse_Dispatch)
+{
+    sp::NMEAParser parser;
+    sp::GPSInfo gpsInfo;
+    // GLONASS-only and Galileo talkers are dispatched, proprietary and unknown sentences are ignored
+    parser.parse("$GLGGA,170257.00,5619.06488,N,04401.12281,E,1,05,1.36,124.2,M,6.3,M,,*77\r\n", gpsInfo);
+    ASSERT_EQ(5, gpsInfo.numSatellites);
+    parser.parse("$GAVTG,,T,,M,1.5,N,2.8,K,A*3C\r\n", gpsInfo);
+    ASSERT_EQ(1.5, gpsInfo.speedKnots);
+    parser.parse("$XXGGA,170257.00,5619.06488,N,04401.12281,E,1,07,1.36,124.2,M,6.3,M,,*7E\r\n", gpsInfo);
+    parser.parse("$PUBX,00,170257.00,5619.06488,N,04401.12281,E*0C\r\n", gpsInfo);
+    ASSERT_EQ(5, gpsInfo.numSatellites);
+}
+
+TEST(NMEAParser, Parse_ShortGGA)
+{
+    sp::NMEAParser parser;
+    sp::GPSInfo gpsInfo;
+    gpsInfo.altitude = 10.0;
+    // HDOP without altitude, the missing field is left untouched
+    parser.parse("$GNGGA,170257.00,5619.06488,N,04401.12281,E,1,07,1.36*77\r\n", gpsInfo);
+    ASSERT_NEAR(56.317748, gpsInfo.latitude, 1e-6);
+    ASSERT_EQ(7, gpsInfo.numSatellites);
+    ASSERT_EQ(1.36, gpsInfo.hdop);
+    ASSERT_EQ(10.0, gpsInfo.altitude);
+}
+
+TEST(NMEAParser, Parse_GLL)
+{
+    sp::NMEAParser parser;
+    sp::GPSInfo gpsInfo;
+    parser.parse("$GNGLL,5621.00000,S,04403.00000,W,170301.00,A,A*7F\r\n", gpsInfo);
+    ASSERT_EQ(-56.35, gpsInfo.latitude);
+    ASSERT_EQ(-44.05, gpsInfo.longitude);
+    ASSERT_EQ(17, gpsInfo.utcHours);
+    ASSERT_EQ(3, gpsInfo.utcMinutes);
+    ASSERT_EQ(1.0, gpsInfo.utcSeconds);
+
+    // invalid GLL is ignored
+    parser.parse("$GNGLL,5622.00000,N,04404.00000,E,170302.00,V,N*6F\r\n", gpsInfo);
+    ASSERT_EQ(-56.35, gpsInfo.latitude);
+    ASSERT_EQ(1.0, gpsInfo.utcSeconds);
+}
+
+TEST(NMEAParser, StampsPosition)
+{
+    sp::NMEAParser parser;
+    sp::GPSInfo gpsInfo;
+    gpsInfo.arrivalNs = 5;
+    parser.parse("$GNGGA,170257.00,5619.06488,N,04401.12281,E,1,09,1.36,124.2,M,6.3,M,,*79\r\n", gpsInfo);
+    ASSERT_EQ(5, gpsInfo.positionArrivalNs);
+
+    // no position, no valid position, void RMC
+    gpsInfo.arrivalNs = 6;
+    parser.parse("$GAVTG,,T,,M,1.5,N,2.8,K,A*3C\r\n", gpsInfo);
+    parser.parse("$GNGGA,170300.00,5619.06488,N,04401.12281,E,0,00,99.99,124.2,M,6.3,M,,*46\r\n", gpsInfo);
+    parser.parse("$GNRMC,000000.00,V,,,,,,,010124,,,N*65\r\n", gpsInfo);
+    ASSERT_EQ(5, gpsInfo.positionArrivalNs);
+
+    gpsInfo.arrivalNs = 7;
+    parser.parse("$GNRMC,170257.00,A,5619.06488,N,04401.12281,E,0.071,,300324,,,A*68\r\n", gpsInfo);
+    ASSERT_EQ(7, gpsInfo.positionArrivalNs);
+    gpsInfo.arrivalNs = 8;
+    parser.parse("$GNGLL,5621.00000,S,04403.00000,W,170301.00,A,A*7F\r\n", gpsInfo);
+    ASSERT_EQ(8, gpsInfo.positionArrivalNs);
+}
+
+TEST(NMEAParser, Parse_GSV)
+{
+    sp::NMEAParser parser;
+    std::string data = R"($GPGSV,3,1,09,02,27,297,26,10,72,079,34,14,11,333,27,18,00,120,*79
+$GPGSV,3,2,09,21,44,293,31,22,07,352,27,23,33,074,36,24,19,052,*70
+$GPGSV,3,3,09,32,50,156,28*4C
+$GLGSV,3,1,10,69,12,039,,70,75,070,17,71,46,206,22,72,01,214,*67
+$GLGSV,3,2,10,77,04,303,,78,17,357,30,79,07,045,,85,48,146,18*69
+$GLGSV,3,3,10,86,74,300,23,87,20,314,*60
+)";
+    sp::GPSInfo gpsInfo;
+    parser.parse(data, gpsInfo);
+
+    const sp::SatelliteTable &satellites = parser.getSatellites();
+    ASSERT_EQ(19, satellites.count);
+    ASSERT_EQ(sp::GNSSSystem::GPS, satellites.system[0]);
+    ASSERT_EQ(2, satellites.prn[0]);
+    ASSERT_EQ(27, satellites.elevation[0]);
+    ASSERT_EQ(297, satellites.azimuth[0]);
+    ASSERT_EQ(26, satellites.snr[0]);
+    ASSERT_EQ(-1, satellites.snr[3]);
+    ASSERT_EQ(32, satellites.prn[8]);
+    ASSERT_EQ(sp::GNSSSystem::GLONASS, satellites.system[9]);
+    ASSERT_EQ(69, satellites.prn[9]);
+    ASSERT_EQ(-1, satellites.snr[9]);
+    ASSERT_EQ(87, satellites.prn[18]);
+
+    // new GPS group replaces only GPS satellites
+    parser.parse("$GPGSV,1,1,02,05,10,100,40,07,20,200,41,1*65\r\n", gpsInfo);
+    ASSERT_EQ(12, satellites.count);
+    ASSERT_EQ(sp::GNSSSystem::GLONASS, satellites.system[0]);
+    ASSERT_EQ(sp::GNSSSystem::GPS, satellites.system[10]);
+    ASSERT_EQ(5, satellites.prn[10]);
+    ASSERT_EQ(41, satellites.snr[11]);
+
+    // group, which lost its first part, is not committed
+    parser.parse("$GAGSV,2,2,05,21,44,293,31*54\r\n", gpsInfo);
+    ASSERT_EQ(12, satellites.count);
 }
\ No newline at end of file
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "NMEAStreamParser.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace sp = ship_position;
+
+class NMEAStreamParserTest : public ::testing::Test
+{
+public:
+    NMEAStreamParserTest() :
+        _parser([this](std::string_view sentence, sp::NMEAStreamParser::Status status)
+        {
+            if (status == sp::NMEAStreamParser::Status::VALID)
+            {
+                _sentences.push_back(std::string(sentence));
+            }
+            else if (status == sp::NMEAStreamParser::Status::TRUNCATED)
+            {
+                _truncated.push_back(std::string(sentence));
+            }
+        })
+    {
+    }
+
+protected:
+    void feed(const std::string &data)
+    {
+        size_t pos = 0;
+        while (pos < data.length())
+        {
+            pos += _parser.feed(data.data() + pos, data.length() - pos);
+        }
+    }
+
+    sp::NMEAStreamParser _parser;
+    std::vector<std::string> _sentences;
+    std::vector<std::string> _truncated;
+};
+
+TEST_F(NMEAStreamParserTest, CompleteSentences)
+{
+    feed("$GNVTG,,T,,M,0.071,N,0.131,K,A*38\r\n$GNGLL,5619.06488,N,04401.12281,E,170257.00,A,A*71\r\n");
+    std::vector<std::string> expected = {"$GNVTG,,T,,M,0.071,N,0.131,K,A*38",
+        "$GNGLL,5619.06488,N,04401.12281,E,170257.00,A,A*71"};
+    ASSERT_EQ(expected, _sentences);
+    ASSERT_EQ(0, _parser.checksumErrors());
+    ASSERT_EQ(0, _parser.truncated());
+}
+
+TEST_F(NMEAStreamParserTest, SplitBetweenReads)
+{
+    feed("$GNVTG,,T,,M,0.0");
+    ASSERT_TRUE(_sentences.empty());
+    feed("71,N,0.131,K,A*3");
+    ASSERT_TRUE(_sentences.empty());
+    feed("8\r\n$GNGLL");
+    std::vector<std::string> expected = {"$GNVTG,,T,,M,0.071,N,0.131,K,A*38"};
+    ASSERT_EQ(expected, _sentences);
+}
+
+TEST_F(NMEAStreamParserTest, ByteAtATime)
+{
+    std::string data = "$GNVTG,,T,,M,0.071,N,0.131,K,A*38\r\n$GNVTG,,T,,M,0.071,N,0.131,K,A*38\r\n";
+    for (char c : data)
+    {
+        _parser.feed(&c, 1);
+    }
+    ASSERT_EQ(2, _sentences.size());
+}
+
+TEST_F(NMEAStreamParserTest, GarbageAndTruncated)
+{
+    feed("71,N,0.131,K,A*38\r\n$GNGGA,1702$GNVTG,,T,,M,0.071,N,0.131,K,A*38\r\n$GNVTG,,T\r\n$GNVTG*3Z");
+    std::vector<std::string> expected = {"$GNVTG,,T,,M,0.071,N,0.131,K,A*38"};
+    ASSERT_EQ(expected, _sentences);
+    ASSERT_EQ(3, _parser.truncated());
+    std::vector<std::string> expectedTruncated = {"$GNGGA,1702", "$GNVTG,,T", "$GNVTG*3"};
+    ASSERT_EQ(expectedTruncated, _truncated);
+}
+
+TEST_F(NMEAStreamParserTest, ChecksumMismatch)
+{
+    feed("$GNVTG,,T,,M,0.071,N,0.131,K,A*39\r\n$GNVTG,,T,,M,0.071,N,0.131,K,A*38\r\n");
+    ASSERT_EQ(1, _sentences.size());
+    ASSERT_EQ(1, _parser.checksumErrors());
+}
+
+TEST_F(NMEAStreamParserTest, Overflow)
+{
+    feed("$" + std::string(200, 'A') + "*41\r\n");
+    ASSERT_TRUE(_sentences.empty());
+    ASSERT_EQ(1, _parser.truncated());
+    feed("$GNVTG,,T,,M,0.071,N,0.131,K,A*38\r\n");
+    ASSERT_EQ(1, _sentences.size());
+}
+
+TEST_F(NMEAStreamParserTest, StopsAtSentenceEnd)
+{
+    std::string data = "$GNVTG,,T,,M,0.071,N,0.131,K,A*38\r\n$GNVTG";
+    ASSERT_EQ(33, _parser.feed(data.data(), data.length()));
+    ASSERT_TRUE(_parser.idle());
+    ASSERT_EQ(1, _sentences.size());
+    ASSERT_EQ(data.length() - 33, _parser.feed(data.data() + 33, data.length() - 33));
+    ASSERT_FALSE(_parser.idle());
+}
+
+TEST_F(NMEAStreamParserTest, StopsAtBinaryData)
+{
+    std::string data = "$GNVTG,,T\xb5\x62";
+    ASSERT_EQ(9, _parser.feed(data.data(), data.length()));
+    ASSERT_TRUE(_parser.idle());
+    std::vector<std::string> expectedTruncated = {"$GNVTG,,T"};
+    ASSERT_EQ(expectedTruncated, _truncated);
+}
+
+TEST_F(NMEAStreamParserTest, TruncatedBetweenReads)
+{
+    feed("$GNGGA,17");
+    feed("02$GNVTG,,T,,M,0.071,N,0.131,K,A*38\r\n");
+    std::vector<std::string> expected = {"$GNVTG,,T,,M,0.071,N,0.131,K,A*38"};
+    ASSERT_EQ(expected, _sentences);
+    std::vector<std::string> expectedTruncated = {"$GNGGA,1702"};
+    ASSERT_EQ(expectedTruncated, _truncated);
+}
+
+TEST(NMEAStreamParser, SentenceIsViewIntoChunk)
+{
+    const char *received = nullptr;
+    sp::NMEAStreamParser parser([&received](std::string_view sentence, sp::NMEAStreamParser::Status)
+    {
+        received = sentence.data();
+    });
+
+    std::string data = "\r\n$GNVTG,,T,,M,0.071,N,0.131,K,A*38\r\n";
+    parser.feed(data.data(), data.length());
+    ASSERT_EQ(data.data() + 2, received);
+}
@@ -0,0 +1,297 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "PositionFilter.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+
+namespace sp = ship_position;
+
+namespace
+{
+
+constexpr double METERS_PER_DEGREE = 6371008.8 * M_PI / 180.0;
+constexpr double MPS_PER_KNOT = 1852.0 / 3600.0;
+constexpr double LATITUDE = 56.317748;
+constexpr double LONGITUDE = 44.0187135;
+
+sp::FusionConfig makeConfig()
+{
+    sp::FusionConfig config;
+    config.publishRate = 10.0;
+    config.gpsTimeout = 2.5;
+    config.maxDeadReckoning = 60.0;
+    config.useCompass = true;
+    config.positionNoise = 3.0;
+    config.velocityNoise = 0.2;
+    config.headingNoise = 3.0;
+    config.accelerationNoise = 0.2;
+    config.turnNoise = 2.0;
+    config.currentNoise = 0.01;
+    return config;
+}
+
+// true motion around LATITUDE, LONGITUDE along heading, turning at turnRate, carried by the current
+struct Vessel
+{
+    double north = 0.0;
+    double east = 0.0;
+    // m/s, degrees, degrees per second
+    double speed = 0.0;
+    double heading = 0.0;
+    double turnRate = 0.0;
+    double currentNorth = 0.0;
+    double currentEast = 0.0;
+
+    void move(double dt)
+    {
+        for (int i = 0; i < 100; i++)
+        {
+            double h = heading * M_PI / 180.0;
+            north += (speed * std::cos(h) + currentNorth) * dt / 100.0;
+            east += (speed * std::sin(h) + currentEast) * dt / 100.0;
+            heading = std::fmod(heading + turnRate * dt / 100.0 + 360.0, 360.0);
+        }
+    }
+
+    double latitude() const { return LATITUDE + north / METERS_PER_DEGREE; }
+    double longitude() const { return LONGITUDE + east / (METERS_PER_DEGREE * std::cos(LATITUDE * M_PI / 180.0)); }
+
+    void fix(sp::PositionFilter &filter) const
+    {
+        double h = heading * M_PI / 180.0;
+        double velocityNorth = speed * std::cos(h) + currentNorth;
+        double velocityEast = speed * std::sin(h) + currentEast;
+        double course = std::atan2(velocityEast, velocityNorth) * 180.0 / M_PI;
+        filter.updateGPS(latitude(), longitude(), std::hypot(velocityNorth, velocityEast) / MPS_PER_KNOT,
+            (course < 0.0) ? course + 360.0 : course, 1.0);
+    }
+
+    // meters between the filter's position and the true one
+    double error(const sp::PositionFilter &filter) const
+    {
+        sp::FusedState state;
+        filter.getState(state);
+        double dn = (state.latitude - latitude()) * METERS_PER_DEGREE;
+        double de = (state.longitude - longitude()) * METERS_PER_DEGREE * std::cos(LATITUDE * M_PI / 180.0);
+        return std::hypot(dn, de);
+    }
+};
+
+// moves the vessel and the filter, compass heading every 0.1 s, fix every second if gps is set
+void sail(Vessel &vessel, sp::PositionFilter &filter, double duration, bool gps)
+{
+    for (int i = 1; i <= std::lround(duration * 10.0); i++)
+    {
+        vessel.move(0.1);
+        filter.predict(0.1);
+        filter.updateHeading(vessel.heading);
+        if (gps && (i % 10 == 0))
+        {
+            vessel.fix(filter);
+        }
+    }
+}
+
+}
+
+TEST(PositionFilter, FirstFixInitializes)
+{
+    sp::PositionFilter filter(makeConfig());
+    ASSERT_FALSE(filter.initialized());
+    // nothing to predict from yet
+    filter.predict(1.0);
+    ASSERT_FALSE(filter.initialized());
+
+    ASSERT_TRUE(filter.updateGPS(LATITUDE, LONGITUDE, 10.0, 90.0, 2.0));
+    ASSERT_TRUE(filter.initialized());
+
+    sp::FusedState state;
+    filter.getState(state);
+    ASSERT_TRUE(state.valid);
+    ASSERT_NEAR(LATITUDE, state.latitude, 1e-9);
+    ASSERT_NEAR(LONGITUDE, state.longitude, 1e-9);
+    ASSERT_NEAR(10.0, state.speedKnots, 1e-9);
+    ASSERT_NEAR(90.0, state.courseOverGround, 1e-9);
+    // without a compass the heading is the course
+    ASSERT_NEAR(90.0, state.heading, 1e-9);
+    ASSERT_NEAR(0.0, state.currentKnots, 1e-9);
+    // 3 m at HDOP 1 on both axes
+    ASSERT_NEAR(6.0 * std::sqrt(2.0), state.positionError, 1e-9);
+}
+
+TEST(PositionFilter, CompassBeforeFirstFix)
+{
+    sp::PositionFilter filter(makeConfig());
+    filter.updateHeading(80.0);
+    ASSERT_FALSE(filter.initialized());
+
+    // the velocity across the heading is taken for current
+    filter.updateGPS(LATITUDE, LONGITUDE, 10.0, 90.0, 1.0);
+    ASSERT_NEAR(80.0 * M_PI / 180.0, filter.state(sp::PositionFilter::HEADING), 1e-9);
+    sp::FusedState state;
+    filter.getState(state);
+    ASSERT_NEAR(10.0, state.speedKnots, 1e-9);
+    ASSERT_NEAR(90.0, state.courseOverGround, 1e-9);
+    ASSERT_NEAR(10.0 * std::sin(10.0 * M_PI / 180.0), state.currentKnots, 1e-9);
+    ASSERT_NEAR(170.0, state.currentDirection, 1e-9);
+}
+
+TEST(PositionFilter, PredictsBetweenFixes)
+{
+    Vessel vessel;
+    vessel.speed = 10.0 * MPS_PER_KNOT;
+    vessel.heading = 90.0;
+    sp::PositionFilter filter(makeConfig());
+    vessel.fix(filter);
+    sail(vessel, filter, 30.0, true);
+
+    // half way to the next fix
+    vessel.move(0.5);
+    filter.predict(0.5);
+    EXPECT_LT(vessel.error(filter), 0.5);
+    sp::FusedState state;
+    filter.getState(state);
+    EXPECT_NEAR(10.0, state.speedKnots, 0.05);
+    EXPECT_NEAR(90.0, state.courseOverGround, 0.5);
+    EXPECT_NEAR(90.0, state.heading, 0.5);
+    EXPECT_LT(state.positionError, 3.0);
+}
+
+TEST(PositionFilter, DeadReckonsThroughTurn)
+{
+    Vessel vessel;
+    vessel.speed = 5.0;
+    sp::PositionFilter filter(makeConfig());
+    vessel.fix(filter);
+    sail(vessel, filter, 60.0, true);
+    sp::FusedState before;
+    filter.getState(before);
+
+    // GPS is lost as a 90 degree turn starts, the compass follows it
+    vessel.turnRate = 3.0;
+    sail(vessel, filter, 30.0, false);
+
+    // holding the last fix would be 135 m off, going on straight 110 m
+    EXPECT_LT(vessel.error(filter), 15.0);
+    sp::FusedState state;
+    filter.getState(state);
+    EXPECT_NEAR(90.0, state.heading, 2.0);
+    EXPECT_NEAR(3.0, state.turnRate, 0.5);
+    EXPECT_GT(state.positionError, before.positionError);
+}
+
+TEST(PositionFilter, LearnsCurrent)
+{
+    // heading north through the water, set east over ground
+    Vessel vessel;
+    vessel.speed = 5.0;
+    vessel.currentEast = 1.0;
+    sp::PositionFilter filter(makeConfig());
+    vessel.fix(filter);
+    sail(vessel, filter, 120.0, true);
+
+    EXPECT_NEAR(5.0, filter.state(sp::PositionFilter::SPEED), 0.1);
+    EXPECT_NEAR(0.0, filter.state(sp::PositionFilter::CURRENT_NORTH), 0.1);
+    EXPECT_NEAR(1.0, filter.state(sp::PositionFilter::CURRENT_EAST), 0.1);
+    sp::FusedState state;
+    filter.getState(state);
+    EXPECT_NEAR(std::atan2(1.0, 5.0) * 180.0 / M_PI, state.courseOverGround, 0.5);
+    EXPECT_NEAR(90.0, state.currentDirection, 5.0);
+
+    // the drift goes on without GPS
+    sail(vessel, filter, 20.0, false);
+    EXPECT_LT(vessel.error(filter), 3.0);
+}
+
+TEST(PositionFilter, HeadingWraps)
+{
+    sp::PositionFilter filter(makeConfig());
+    filter.updateGPS(LATITUDE, LONGITUDE, 0.0, 0.0, 1.0);
+    for (int i = 0; i < 50; i++)
+    {
+        filter.predict(0.1);
+        filter.updateHeading((i % 2) ? 359.0 : 1.0);
+    }
+
+    sp::FusedState state;
+    filter.getState(state);
+    double heading = (state.heading > 180.0) ? state.heading - 360.0 : state.heading;
+    EXPECT_NEAR(0.0, heading, 1.0);
+    EXPECT_GE(state.heading, 0.0);
+    EXPECT_LT(state.heading, 360.0);
+}
+
+TEST(PositionFilter, RejectsOutliers)
+{
+    Vessel vessel;
+    vessel.speed = 5.0;
+    sp::PositionFilter filter(makeConfig());
+    vessel.fix(filter);
+    sail(vessel, filter, 30.0, true);
+
+    // a single jump is ignored
+    double jump = 500.0 / METERS_PER_DEGREE;
+    ASSERT_FALSE(filter.updateGPS(vessel.latitude() + jump, vessel.longitude(), 9.7, 0.0, 1.0));
+    EXPECT_LT(vessel.error(filter), 1.0);
+    vessel.fix(filter);
+
+    // a lasting one is believed in the end
+    for (int i = 1; i < sp::PositionFilter::MAX_REJECTED_FIXES; i++)
+    {
+        ASSERT_FALSE(filter.updateGPS(vessel.latitude() + jump, vessel.longitude(), 9.7, 0.0, 1.0));
+    }
+    ASSERT_TRUE(filter.updateGPS(vessel.latitude() + jump, vessel.longitude(), 9.7, 0.0, 1.0));
+    sp::FusedState state;
+    filter.getState(state);
+    EXPECT_NEAR(vessel.latitude() + jump, state.latitude, 1e-9);
+}
+
+TEST(PositionFilter, MovesOrigin)
+{
+    // along the parallel, far beyond the distance the origin is moved at
+    Vessel vessel;
+    vessel.speed = 20.0;
+    vessel.heading = 90.0;
+    sp::PositionFilter filter(makeConfig());
+    vessel.fix(filter);
+    sail(vessel, filter, 1200.0, true);
+
+    ASSERT_GT(vessel.east, 2.0 * sp::PositionFilter::RECENTER_DISTANCE);
+    EXPECT_LT(std::hypot(filter.state(sp::PositionFilter::NORTH), filter.state(sp::PositionFilter::EAST)),
+        sp::PositionFilter::RECENTER_DISTANCE);
+    EXPECT_LT(vessel.error(filter), 1.0);
+}
+
+TEST(PositionFilter, Reset)
+{
+    sp::PositionFilter filter(makeConfig());
+    filter.updateGPS(LATITUDE, LONGITUDE, 10.0, 90.0, 1.0);
+    filter.updateHeading(45.0);
+    filter.reset();
+    ASSERT_FALSE(filter.initialized());
+    sp::FusedState state;
+    filter.getState(state);
+    ASSERT_FALSE(state.valid);
+
+    // the compass heading is kept for the next start
+    filter.updateGPS(LATITUDE, LONGITUDE, 0.0, 0.0, 1.0);
+    ASSERT_NEAR(45.0 * M_PI / 180.0, filter.state(sp::PositionFilter::HEADING), 1e-9);
+}
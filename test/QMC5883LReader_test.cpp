@@ -0,0 +1,232 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "QMC5883LReader.hpp"
+#include "sim/SimulatedQMC5883L.hpp"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+namespace sp = ship_position;
+
+namespace
+{
+
+sp::QMC5883LConfig makeConfig()
+{
+    sp::QMC5883LConfig config;
+    config.devPath = "simulated";
+    config.pollTimeout = 10;
+    config.outputDataRate = 200;
+    config.fieldRange = 2;
+    config.oversampling = 512;
+    config.filter = "none";
+    config.filterWindow = 1;
+    config.filterAlpha = 1.0;
+    config.mountingRotation = 0.0;
+    config.mountingFlipped = false;
+    config.declination = 10.0;
+    config.calibrationFile = "";
+    config.calibrationMinCoverage = 0.75;
+    config.calibrationMaxResidual = 0.015;
+    return config;
+}
+
+}
+
+TEST(QMC5883LReader, DecodeSample)
+{
+    // status first, then X, Y and Z as little endian words, as returned by the block read
+    const uint8_t block[sp::QMC5883LReader::BLOCK_SIZE] = {0x01, 0x09, 0x03, 0xac, 0xff, 0x00, 0x80};
+    int32_t x = 0;
+    int32_t y = 0;
+    int32_t z = 0;
+    sp::QMC5883LReader::decodeSample(block + 1, x, y, z);
+    ASSERT_EQ(777, x);
+    ASSERT_EQ(-84, y);
+    ASSERT_EQ(-32768, z);
+
+    const uint8_t max[6] = {0xff, 0x7f, 0x00, 0x00, 0xff, 0xff};
+    sp::QMC5883LReader::decodeSample(max, x, y, z);
+    ASSERT_EQ(32767, x);
+    ASSERT_EQ(0, y);
+    ASSERT_EQ(-1, z);
+}
+
+TEST(QMC5883LReader, DecodeTemperature)
+{
+    // little endian, 100 LSB per degree C
+    const uint8_t warm[sp::QMC5883LReader::TEMPERATURE_SIZE] = {0x35, 0x0c};
+    ASSERT_DOUBLE_EQ(31.25, sp::QMC5883LReader::decodeTemperature(warm));
+    const uint8_t cold[sp::QMC5883LReader::TEMPERATURE_SIZE] = {0x06, 0xff};
+    ASSERT_DOUBLE_EQ(-2.5, sp::QMC5883LReader::decodeTemperature(cold));
+}
+
+TEST(QMC5883LReader, ControlRegister)
+{
+    sp::QMC5883LConfig config;
+    config.outputDataRate = 10;
+    config.fieldRange = 2;
+    config.oversampling = 512;
+    uint8_t value = 0;
+    ASSERT_TRUE(sp::QMC5883LReader::controlRegister1(config, value));
+    // continuous mode only, as it was hard-coded before
+    ASSERT_EQ(0x01, value);
+
+    config.outputDataRate = 200;
+    config.fieldRange = 8;
+    config.oversampling = 64;
+    ASSERT_TRUE(sp::QMC5883LReader::controlRegister1(config, value));
+    ASSERT_EQ(0xdd, value);
+
+    config.outputDataRate = 100;
+    config.oversampling = 256;
+    ASSERT_TRUE(sp::QMC5883LReader::controlRegister1(config, value));
+    ASSERT_EQ(0x59, value);
+
+    config.outputDataRate = 20;
+    ASSERT_FALSE(sp::QMC5883LReader::controlRegister1(config, value));
+    config.outputDataRate = 50;
+    config.fieldRange = 4;
+    ASSERT_FALSE(sp::QMC5883LReader::controlRegister1(config, value));
+}
+
+TEST(QMC5883LReader, ReadsSimulatedDevice)
+{
+    sp::SimulatedQMC5883LConfig deviceConfig;
+    deviceConfig.track = {{60.0, 0.0, 30.0, 0.0}};
+    deviceConfig.temperature = 31.25;
+    sp::SimulatedQMC5883L device(deviceConfig);
+    sp::QMC5883LConfig config = makeConfig();
+    sp::QMC5883LReader reader(config, device);
+
+    reader.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    reader.stop();
+
+    sp::MagnetometerStatistics statistics;
+    reader.getMagnetometerStatistics(statistics);
+    // 60 measurements were made, a loaded machine may lose some of them
+    uint64_t measurements = device.measurements();
+    EXPECT_GE(measurements, 55);
+    EXPECT_GE(statistics.samples, measurements / 2);
+    EXPECT_LE(statistics.samples, measurements);
+    EXPECT_EQ(0, statistics.readErrors);
+
+    sp::MagnetometerData data;
+    reader.getMagnetometerData(data);
+    EXPECT_EQ(std::lround(2160.0 * std::cos(M_PI / 6.0)), data.x);
+    EXPECT_EQ(1080, data.y);
+    EXPECT_EQ(5760, data.z);
+    EXPECT_DOUBLE_EQ(31.25, data.temperature);
+    EXPECT_GE(data.publishNs, data.arrivalNs);
+    // the last sample is the one published
+    EXPECT_EQ(data.arrivalNs, statistics.lastArrivalNs);
+
+    // not calibrated, nothing to compensate
+    sp::TemperatureCompensation compensation;
+    reader.getTemperatureCompensation(compensation);
+    EXPECT_DOUBLE_EQ(31.25, compensation.temperature);
+    EXPECT_EQ(0.0, compensation.correction[0]);
+    // the thermometer is read with the first sample
+    EXPECT_NE(0, compensation.arrivalNs);
+    EXPECT_LE(compensation.arrivalNs, data.arrivalNs);
+
+    sp::HeadingData heading;
+    reader.getHeading(heading);
+    EXPECT_NEAR(30.0, heading.magneticHeading, 0.05);
+    EXPECT_NEAR(40.0, heading.trueHeading, 0.05);
+}
+
+TEST(QMC5883LReader, CalibrationStopsOnLevelTurns)
+{
+    sp::SimulatedQMC5883LConfig deviceConfig;
+    // a full circle every 3 s
+    deviceConfig.track = {{60.0, 0.0, 0.0, 120.0}};
+    deviceConfig.hardIron[0] = 0.05;
+    deviceConfig.hardIron[1] = -0.03;
+    deviceConfig.noise = 2.0;
+    sp::SimulatedQMC5883L device(deviceConfig);
+    sp::QMC5883LConfig config = makeConfig();
+    config.calibrationMinCoverage = 1.0;
+    sp::QMC5883LReader reader(config, device);
+
+    reader.start();
+    reader.startCalibration();
+    sp::CalibrationStatus status;
+    for (int i = 0; i < 100; i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        reader.getCalibrationStatus(status);
+        if (!status.calibrating)
+        {
+            break;
+        }
+    }
+    // corrected samples have to come in first
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    sp::MagnetometerData data;
+    reader.getMagnetometerData(data);
+    reader.stop();
+
+    ASSERT_FALSE(status.calibrating);
+    ASSERT_TRUE(status.complete);
+    EXPECT_EQ(1.0, status.headingCoverage);
+    // the hard iron of 600 and 360 LSB is gone, the horizontal field is 2160 LSB on every heading
+    EXPECT_NEAR(2160.0, std::hypot(data.x, data.y), 30.0);
+}
+
+TEST(QMC5883LReader, ReadErrors)
+{
+    sp::SimulatedQMC5883LConfig deviceConfig;
+    sp::SimulatedQMC5883L device(deviceConfig);
+    sp::QMC5883LConfig config = makeConfig();
+    sp::QMC5883LReader reader(config, device);
+
+    device.failTransfers(3);
+    reader.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    reader.stop();
+
+    // every failed read is retried after pollTimeout, then reading goes on
+    sp::MagnetometerStatistics statistics;
+    reader.getMagnetometerStatistics(statistics);
+    EXPECT_EQ(3, statistics.readErrors);
+    EXPECT_GT(statistics.samples, 0);
+}
+
+TEST(QMC5883LReader, InitFailure)
+{
+    sp::SimulatedQMC5883LConfig deviceConfig;
+    sp::SimulatedQMC5883L device(deviceConfig);
+    device.failTransfers(1);
+    sp::QMC5883LConfig config = makeConfig();
+    sp::QMC5883LReader reader(config, device);
+
+    reader.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    reader.stop();
+
+    sp::MagnetometerStatistics statistics;
+    reader.getMagnetometerStatistics(statistics);
+    EXPECT_EQ(0, statistics.samples);
+    EXPECT_EQ(0, device.measurements());
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RawRecorder.hpp"
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace sp = ship_position;
+
+class RawRecorderAdapter : public sp::RawRecorder
+{
+public:
+    using sp::RawRecorder::RawRecorder;
+    using sp::RawRecorder::flush;
+};
+
+class RawRecorderTest : public ::testing::Test
+{
+public:
+    virtual void SetUp()
+    {
+        char dir[] = "/tmp/rawrecorder_testXXXXXX";
+        ASSERT_NE(nullptr, mkdtemp(dir));
+        _dir = dir;
+        _path = _dir + "/rawgps.log";
+    }
+
+    virtual void TearDown()
+    {
+        std::filesystem::remove_all(_dir);
+    }
+
+protected:
+    void submit(sp::RawRecorder &recorder, const std::string &data)
+    {
+        sp::RawRecorder::Buffer *buffer = recorder.acquire();
+        ASSERT_NE(nullptr, buffer);
+        memcpy(buffer->data, data.data(), data.length());
+        recorder.submit(buffer, data.length());
+    }
+
+    std::string contents(const std::string &path)
+    {
+        std::ifstream file(path);
+        std::stringstream stream;
+        stream << file.rdbuf();
+        return stream.str();
+    }
+
+    std::string _dir;
+    std::string _path;
+};
+
+TEST_F(RawRecorderTest, RecordsInOrder)
+{
+    RawRecorderAdapter recorder(_path, 64, 0, 0, false);
+    recorder.start();
+    std::string expected;
+    for (int i = 0; i < 200; i++)
+    {
+        std::string data = "$GNGGA," + std::to_string(i) + "\r\n";
+        expected += data;
+        // the writer returns buffers every flush interval
+        sp::RawRecorder::Buffer *buffer;
+        while ((buffer = recorder.acquire()) == nullptr)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        memcpy(buffer->data, data.data(), data.length());
+        recorder.submit(buffer, data.length());
+    }
+    recorder.stop();
+
+    ASSERT_EQ(expected, contents(recorder.segmentPath(1)));
+    ASSERT_EQ(expected.length(), recorder.writtenBytes());
+    ASSERT_EQ(0, recorder.droppedBytes());
+}
+
+TEST_F(RawRecorderTest, RunsOutOfBuffers)
+{
+    RawRecorderAdapter recorder(_path, 64, 0, 0, false);
+    for (size_t i = 0; i < sp::RawRecorder::NUM_BUFFERS; i++)
+    {
+        ASSERT_NE(nullptr, recorder.acquire());
+    }
+    ASSERT_EQ(nullptr, recorder.acquire());
+}
+
+TEST_F(RawRecorderTest, RotationAndRetention)
+{
+    {
+        RawRecorderAdapter recorder(_path, 64, 100, 2, false);
+        for (int i = 0; i < 5; i++)
+        {
+            submit(recorder, std::string(60, '0' + i));
+            ASSERT_TRUE(recorder.flush());
+        }
+        ASSERT_FALSE(recorder.flush());
+
+        ASSERT_FALSE(std::filesystem::exists(recorder.segmentPath(3)));
+        ASSERT_EQ(std::string(60, '3'), contents(recorder.segmentPath(4)));
+        ASSERT_EQ(std::string(60, '4'), contents(recorder.segmentPath(5)));
+    }
+
+    // numbering continues after a restart, so that history is kept
+    RawRecorderAdapter recorder(_path, 64, 100, 2, false);
+    submit(recorder, "$GNVTG");
+    recorder.flush();
+    ASSERT_FALSE(std::filesystem::exists(recorder.segmentPath(4)));
+    ASSERT_EQ(std::string(60, '4'), contents(recorder.segmentPath(5)));
+    ASSERT_EQ("$GNVTG", contents(recorder.segmentPath(6)));
+}
+
+TEST_F(RawRecorderTest, Timestamps)
+{
+    RawRecorderAdapter recorder(_path, 64, 0, 0, true);
+    submit(recorder, "$GNGGA");
+    submit(recorder, "$GNVTG,");
+    recorder.flush();
+
+    std::string data = contents(recorder.segmentPath(1));
+    size_t headerSize = sizeof(sp::RawRecorder::RecordHeader);
+    ASSERT_EQ(8 + 2 * headerSize + 13, data.length());
+    ASSERT_EQ(0, data.compare(0, 8, sp::RawRecorder::TIMESTAMPED_MAGIC, 8));
+
+    sp::RawRecorder::RecordHeader first;
+    sp::RawRecorder::RecordHeader second;
+    memcpy(&first, data.data() + 8, headerSize);
+    memcpy(&second, data.data() + 8 + headerSize + 6, headerSize);
+    ASSERT_EQ(6, first.length);
+    ASSERT_EQ("$GNGGA", data.substr(8 + headerSize, 6));
+    ASSERT_EQ(7, second.length);
+    ASSERT_EQ("$GNVTG,", data.substr(8 + 2 * headerSize + 6));
+    ASSERT_NE(0, first.timestamp);
+    ASSERT_LE(first.timestamp, second.timestamp);
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "SPSCQueue.hpp"
+#include <gtest/gtest.h>
+#include <thread>
+
+namespace sp = ship_position;
+
+TEST(SPSCQueue, FullAndEmpty)
+{
+    sp::SPSCQueue<int, 4> queue;
+    int value;
+    ASSERT_FALSE(queue.pop(value));
+    for (int i = 0; i < 4; i++)
+    {
+        ASSERT_TRUE(queue.push(i));
+    }
+    ASSERT_FALSE(queue.push(4));
+    ASSERT_EQ(4, queue.size());
+
+    ASSERT_TRUE(queue.pop(value));
+    ASSERT_EQ(0, value);
+    ASSERT_TRUE(queue.push(4));
+    for (int i = 1; i < 5; i++)
+    {
+        ASSERT_TRUE(queue.pop(value));
+        ASSERT_EQ(i, value);
+    }
+    ASSERT_FALSE(queue.pop(value));
+}
+
+TEST(SPSCQueue, TwoThreads)
+{
+    constexpr int COUNT = 10000;
+    sp::SPSCQueue<int, 64> queue;
+
+    std::thread producer([&queue]()
+    {
+        for (int i = 0; i < COUNT; )
+        {
+            if (queue.push(i))
+            {
+                i++;
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    // mismatches are only counted here, returning early would leave the producer joinable
+    int expected = 0;
+    int mismatches = 0;
+    while (expected < COUNT)
+    {
+        int value;
+        if (queue.pop(value))
+        {
+            EXPECT_EQ(expected, value);
+            if (value != expected)
+            {
+                mismatches++;
+            }
+            expected++;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    ASSERT_EQ(0, mismatches);
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "SampleRing.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace sp = ship_position;
+
+namespace
+{
+
+struct Sample
+{
+    uint64_t index;
+    uint64_t check[5];
+    uint32_t tail;
+};
+
+Sample makeSample(uint64_t index)
+{
+    Sample sample;
+    sample.index = index;
+    for (uint64_t &check : sample.check)
+    {
+        check = index * 7;
+    }
+    sample.tail = static_cast<uint32_t>(index);
+    return sample;
+}
+
+}
+
+TEST(SampleRing, LatestValues)
+{
+    sp::SampleRing<int, 8> ring;
+    int values[16];
+    ASSERT_EQ(0, ring.read(values, 4));
+
+    for (int i = 0; i < 3; i++)
+    {
+        ring.push(i);
+    }
+    ASSERT_EQ(3, ring.read(values, 16));
+    ASSERT_EQ(0, values[0]);
+    ASSERT_EQ(2, values[2]);
+    ASSERT_EQ(2, ring.read(values, 2));
+    ASSERT_EQ(1, values[0]);
+    ASSERT_EQ(2, values[1]);
+
+    // the ring keeps the last 8 only
+    for (int i = 3; i < 20; i++)
+    {
+        ring.push(i);
+    }
+    ASSERT_EQ(20, ring.pushed());
+    ASSERT_EQ(8, ring.read(values, 16));
+    for (int i = 0; i < 8; i++)
+    {
+        ASSERT_EQ(12 + i, values[i]);
+    }
+}
+
+TEST(SampleRing, ReadersDuringPush)
+{
+    constexpr uint64_t COUNT = 300000;
+    constexpr size_t CAPACITY = 16;
+    sp::SampleRing<Sample, CAPACITY> ring;
+    std::atomic<bool> done(false);
+    std::atomic<int> failures(0);
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; r++)
+    {
+        readers.emplace_back([&ring, &done, &failures]()
+        {
+            Sample samples[CAPACITY];
+            while (!done)
+            {
+                size_t count = ring.read(samples, CAPACITY);
+                for (size_t i = 0; i < count; i++)
+                {
+                    // no torn samples, consecutive and oldest first
+                    const Sample &sample = samples[i];
+                    bool torn = (sample.tail != static_cast<uint32_t>(sample.index));
+                    for (uint64_t check : sample.check)
+                    {
+                        torn = torn || (check != sample.index * 7);
+                    }
+                    if (torn || ((i > 0) && (sample.index != samples[i - 1].index + 1)))
+                    {
+                        failures++;
+                    }
+                }
+            }
+        });
+    }
+
+    for (uint64_t i = 0; i < COUNT; i++)
+    {
+        ring.push(makeSample(i));
+    }
+    done = true;
+    for (std::thread &reader : readers)
+    {
+        reader.join();
+    }
+
+    ASSERT_EQ(0, failures);
+    Sample last;
+    ASSERT_EQ(1, ring.read(&last, 1));
+    ASSERT_EQ(COUNT - 1, last.index);
+}
@@ -0,0 +1,246 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "SensorFusion.hpp"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+namespace sp = ship_position;
+
+namespace
+{
+
+constexpr double METERS_PER_DEGREE = 6371008.8 * M_PI / 180.0;
+constexpr uint64_t SECOND_NS = 1000000000ULL;
+constexpr uint64_t START_NS = 1000 * SECOND_NS;
+
+class FakeGPSReader : public sp::GPSReader
+{
+public:
+    virtual void getGPSInfo(sp::GPSInfo &gpsInfo) { gpsInfo = info; }
+    virtual void getNMEAStatistics(sp::NMEAStatistics &) {}
+    virtual void getSatellites(sp::SatelliteTable &) {}
+
+    sp::GPSInfo info;
+};
+
+class FakeMagnetometerReader : public sp::MagnetometerReader
+{
+public:
+    virtual void getMagnetometerData(sp::MagnetometerData &) {}
+    virtual void getMagnetometerSamples(size_t, std::vector<sp::MagnetometerData> &) {}
+    virtual void getMagnetometerStatistics(sp::MagnetometerStatistics &) {}
+    virtual void getHeading(sp::HeadingData &data) { data = heading; }
+    virtual void getCalibrationStatus(sp::CalibrationStatus &) {}
+    virtual void getTemperatureCompensation(sp::TemperatureCompensation &) {}
+    virtual void startCalibration() {}
+    virtual bool stopCalibration() { return true; }
+
+    sp::HeadingData heading;
+};
+
+class SensorFusionTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        _config.publishRate = 10.0;
+        _config.gpsTimeout = 1.5;
+        _config.maxDeadReckoning = 5.0;
+        _config.useCompass = true;
+        _config.positionNoise = 3.0;
+        _config.velocityNoise = 0.2;
+        _config.headingNoise = 3.0;
+        _config.accelerationNoise = 0.2;
+        _config.turnNoise = 2.0;
+        _config.currentNoise = 0.01;
+    }
+
+    // north at 10 knots, fix every second if gps is set, heading and fusion cycle every 0.1 s
+    void sail(sp::SensorFusion &fusion, int seconds, bool gps)
+    {
+        for (int i = 0; i < seconds * 10; i++)
+        {
+            _tenths++;
+            uint64_t now = START_NS + _tenths * SECOND_NS / 10;
+            if (gps && (_tenths % 10 == 0))
+            {
+                setFix(now);
+            }
+            _magnetometerReader.heading.arrivalNs = now;
+            fusion.cycle(now);
+        }
+    }
+
+    void setFix(uint64_t arrivalNs)
+    {
+        sp::GPSInfo &info = _gpsReader.info;
+        info.fixQuality = 1;
+        info.latitude = latitude(_tenths / 10.0);
+        info.longitude = 44.0;
+        info.speedKnots = 10.0;
+        info.courseOverGround = 0.0;
+        info.hdop = 1.0;
+        // the receiver time is left as it is, fixes are told apart by their stamp only
+        info.arrivalNs = arrivalNs;
+        info.positionArrivalNs = arrivalNs;
+    }
+
+    double latitude(double seconds) const { return 56.0 + seconds * 1852.0 / 360.0 / METERS_PER_DEGREE; }
+
+    sp::FusionConfig _config;
+    FakeGPSReader _gpsReader;
+    FakeMagnetometerReader _magnetometerReader;
+    int _tenths = 0;
+};
+
+}
+
+TEST_F(SensorFusionTest, NothingBeforeFirstFix)
+{
+    sp::SensorFusion fusion(_config, _gpsReader, _magnetometerReader);
+    sail(fusion, 2, false);
+
+    sp::FusedState state;
+    fusion.getFusedState(state);
+    EXPECT_FALSE(state.valid);
+    EXPECT_EQ(START_NS + 2 * SECOND_NS, state.arrivalNs);
+    EXPECT_NE(0, state.publishNs);
+    EXPECT_EQ(0, state.fixArrivalNs);
+
+    sp::FusionStatistics statistics;
+    fusion.getFusionStatistics(statistics);
+    EXPECT_EQ(0, statistics.fixes);
+    EXPECT_EQ(20, statistics.headings);
+}
+
+TEST_F(SensorFusionTest, FusesFixesAndHeadings)
+{
+    sp::SensorFusion fusion(_config, _gpsReader, _magnetometerReader);
+    sail(fusion, 30, true);
+
+    // a fix republished by the other sentences of its epoch is fused once
+    _gpsReader.info.arrivalNs += SECOND_NS / 20;
+    uint64_t now = START_NS + 30 * SECOND_NS + SECOND_NS / 20;
+    fusion.cycle(now);
+
+    sp::FusionStatistics statistics;
+    fusion.getFusionStatistics(statistics);
+    EXPECT_EQ(30, statistics.fixes);
+    EXPECT_EQ(300, statistics.headings);
+    EXPECT_EQ(0, statistics.rejectedFixes);
+    EXPECT_EQ(START_NS + 30 * SECOND_NS, statistics.lastArrivalNs);
+
+    // propagated to the cycle time, past the last fix
+    sp::FusedState state;
+    fusion.getFusedState(state);
+    EXPECT_TRUE(state.valid);
+    EXPECT_FALSE(state.deadReckoning);
+    EXPECT_EQ(now, state.arrivalNs);
+    EXPECT_EQ(START_NS + 30 * SECOND_NS, state.fixArrivalNs);
+    EXPECT_NEAR(latitude(30.05), state.latitude, 0.3 / METERS_PER_DEGREE);
+    EXPECT_NEAR(44.0, state.longitude, 1e-6);
+    EXPECT_NEAR(10.0, state.speedKnots, 0.1);
+    EXPECT_NEAR(0.0, std::fmod(state.heading + 180.0, 360.0) - 180.0, 0.5);
+}
+
+TEST_F(SensorFusionTest, InvalidFixesIgnored)
+{
+    sp::SensorFusion fusion(_config, _gpsReader, _magnetometerReader);
+    // sentences without a valid position don't stamp it
+    setFix(START_NS);
+    _gpsReader.info.fixQuality = 0;
+    _gpsReader.info.positionArrivalNs = 0;
+    fusion.cycle(START_NS);
+
+    sp::FusedState state;
+    fusion.getFusedState(state);
+    EXPECT_FALSE(state.valid);
+}
+
+TEST_F(SensorFusionTest, DeadReckoning)
+{
+    sp::SensorFusion fusion(_config, _gpsReader, _magnetometerReader);
+    sail(fusion, 20, true);
+    sail(fusion, 1, false);
+
+    sp::FusedState state;
+    fusion.getFusedState(state);
+    EXPECT_FALSE(state.deadReckoning);
+
+    // the position goes on north without fixes
+    sail(fusion, 2, false);
+    fusion.getFusedState(state);
+    EXPECT_TRUE(state.valid);
+    EXPECT_TRUE(state.deadReckoning);
+    EXPECT_NEAR(latitude(23.0), state.latitude, 1.0 / METERS_PER_DEGREE);
+
+    // until it is too old to be of use
+    sail(fusion, 3, false);
+    fusion.getFusedState(state);
+    EXPECT_FALSE(state.valid);
+    sp::FusionStatistics statistics;
+    fusion.getFusionStatistics(statistics);
+    EXPECT_EQ(1, statistics.resets);
+
+    // the next fix starts over
+    sail(fusion, 1, true);
+    fusion.getFusedState(state);
+    EXPECT_TRUE(state.valid);
+    EXPECT_FALSE(state.deadReckoning);
+    EXPECT_NEAR(latitude(27.0), state.latitude, 1e-9);
+}
+
+TEST_F(SensorFusionTest, WithoutCompass)
+{
+    _config.useCompass = false;
+    sp::SensorFusion fusion(_config, _gpsReader, _magnetometerReader);
+    _magnetometerReader.heading.trueHeading = 45.0;
+    sail(fusion, 10, true);
+
+    sp::FusionStatistics statistics;
+    fusion.getFusionStatistics(statistics);
+    EXPECT_EQ(10, statistics.fixes);
+    EXPECT_EQ(0, statistics.headings);
+    sp::FusedState state;
+    fusion.getFusedState(state);
+    EXPECT_NEAR(0.0, std::fmod(state.heading + 180.0, 360.0) - 180.0, 0.5);
+}
+
+TEST_F(SensorFusionTest, PublishesAtRate)
+{
+    _config.publishRate = 50.0;
+    sp::SensorFusion fusion(_config, _gpsReader, _magnetometerReader);
+    fusion.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    sp::FusedState first;
+    fusion.getFusedState(first);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    sp::FusedState second;
+    fusion.getFusedState(second);
+    fusion.stop();
+
+    EXPECT_NE(0, first.arrivalNs);
+    // 5 cycles apart, a loaded machine may lose some of them
+    EXPECT_GE(second.arrivalNs - first.arrivalNs, 60000000);
+    EXPECT_LE(second.arrivalNs - first.arrivalNs, 140000000);
+}
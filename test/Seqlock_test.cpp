@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Seqlock.hpp"
+#include "GPSReader.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace sp = ship_position;
+
+namespace
+{
+
+// every field holds the same value, so a torn copy is easy to spot
+struct Sample
+{
+    uint64_t values[37];
+    uint8_t tail;
+};
+
+}
+
+TEST(Seqlock, StoreAndLoad)
+{
+    sp::Seqlock<sp::GPSInfo> seqlock;
+    sp::GPSInfo gpsInfo;
+    seqlock.load(gpsInfo);
+    ASSERT_EQ(0.0, gpsInfo.latitude);
+    ASSERT_EQ(0, seqlock.updates());
+
+    gpsInfo.latitude = 56.317748;
+    gpsInfo.utcSeconds = 57.5;
+    gpsInfo.arrivalNs = 12345;
+    seqlock.store(gpsInfo);
+    ASSERT_EQ(1, seqlock.updates());
+
+    sp::GPSInfo copy;
+    seqlock.load(copy);
+    ASSERT_EQ(56.317748, copy.latitude);
+    ASSERT_EQ(57.5, copy.utcSeconds);
+    ASSERT_EQ(12345, copy.arrivalNs);
+}
+
+TEST(Seqlock, ReadersNeverSeeTornValues)
+{
+    constexpr uint64_t COUNT = 200000;
+    constexpr int NUM_READERS = 4;
+    sp::Seqlock<Sample> seqlock;
+    std::atomic<bool> done(false);
+    std::atomic<int> failures(0);
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < NUM_READERS; r++)
+    {
+        readers.emplace_back([&seqlock, &done, &failures]()
+        {
+            uint64_t last = 0;
+            while (!done)
+            {
+                Sample sample;
+                seqlock.load(sample);
+                for (uint64_t value : sample.values)
+                {
+                    if (value != sample.values[0])
+                    {
+                        failures++;
+                    }
+                }
+                // the writer never goes back in time
+                if ((sample.tail != static_cast<uint8_t>(sample.values[0])) || (sample.values[0] < last))
+                {
+                    failures++;
+                }
+                last = sample.values[0];
+            }
+        });
+    }
+
+    for (uint64_t i = 1; i <= COUNT; i++)
+    {
+        Sample sample;
+        for (uint64_t &value : sample.values)
+        {
+            value = i;
+        }
+        sample.tail = static_cast<uint8_t>(i);
+        seqlock.store(sample);
+    }
+    done = true;
+    for (std::thread &reader : readers)
+    {
+        reader.join();
+    }
+
+    ASSERT_EQ(0, failures);
+    ASSERT_EQ(COUNT, seqlock.updates());
+}
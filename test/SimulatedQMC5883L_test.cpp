@@ -0,0 +1,213 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "sim/SimulatedQMC5883L.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+
+namespace sp = ship_position;
+
+namespace
+{
+
+constexpr uint8_t REG_STATUS = 0x06;
+constexpr uint8_t REG_CONTROL_1 = 0x09;
+constexpr uint8_t REG_CONTROL_2 = 0x0A;
+// continuous mode, 200 Hz, 2 G, OSR 512
+constexpr uint8_t CONTINUOUS_200HZ = 0x0d;
+constexpr uint64_t PERIOD_NS = 5000000;
+
+class SimulatedQMC5883LTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        _config.track = {{10.0, 0.0, 90.0, 0.0}};
+    }
+
+    void start(sp::SimulatedQMC5883L &device)
+    {
+        device.setClock([this]() { return _now; });
+        ASSERT_TRUE(device.writeRegister(REG_CONTROL_2, 0x40));
+        ASSERT_TRUE(device.writeRegister(REG_CONTROL_1, CONTINUOUS_200HZ));
+    }
+
+    // status and data as the reader reads them
+    uint8_t readBlock(sp::SimulatedQMC5883L &device, int16_t &x, int16_t &y, int16_t &z)
+    {
+        uint8_t block[7];
+        EXPECT_EQ(7, device.readRegisters(REG_STATUS, 7, block));
+        x = static_cast<int16_t>(block[1] | (block[2] << 8));
+        y = static_cast<int16_t>(block[3] | (block[4] << 8));
+        z = static_cast<int16_t>(block[5] | (block[6] << 8));
+        return block[0];
+    }
+
+    sp::SimulatedQMC5883LConfig _config;
+    uint64_t _now = 1000000000;
+};
+
+}
+
+TEST_F(SimulatedQMC5883LTest, Registers)
+{
+    sp::SimulatedQMC5883L device(_config);
+    uint8_t value = 0;
+    ASSERT_EQ(1, device.readRegisters(sp::SimulatedQMC5883L::REG_CHIP_ID, 1, &value));
+    ASSERT_EQ(sp::SimulatedQMC5883L::CHIP_ID, value);
+
+    ASSERT_TRUE(device.writeRegister(REG_CONTROL_1, 0x1d));
+    ASSERT_EQ(1, device.readRegisters(REG_CONTROL_1, 1, &value));
+    ASSERT_EQ(0x1d, value);
+
+    // soft reset
+    ASSERT_TRUE(device.writeRegister(REG_CONTROL_2, 0x80));
+    ASSERT_EQ(1, device.readRegisters(REG_CONTROL_1, 1, &value));
+    ASSERT_EQ(0x00, value);
+
+    device.failTransfers(2);
+    ASSERT_FALSE(device.writeRegister(REG_CONTROL_1, 0x1d));
+    ASSERT_EQ(-1, device.readRegisters(REG_STATUS, 1, &value));
+    ASSERT_EQ(EIO, errno);
+    ASSERT_EQ(1, device.readRegisters(REG_STATUS, 1, &value));
+}
+
+TEST_F(SimulatedQMC5883LTest, DataReadyTiming)
+{
+    sp::SimulatedQMC5883L device(_config);
+    std::vector<uint64_t> delays;
+    device.setDataReadCallback([&delays](uint64_t delay) { delays.push_back(delay); });
+    start(device);
+
+    int16_t x;
+    int16_t y;
+    int16_t z;
+    // nothing measured before the first period ends
+    _now += PERIOD_NS - 1;
+    ASSERT_EQ(0, readBlock(device, x, y, z) & 0x01);
+    ASSERT_EQ(0, device.measurements());
+
+    _now += 1;
+    ASSERT_EQ(0x01, readBlock(device, x, y, z));
+    // heading east: north is on the port side
+    ASSERT_NEAR(0, x, 1);
+    ASSERT_EQ(2160, y);
+    ASSERT_EQ(5760, z);
+    ASSERT_EQ(1, delays.size());
+    ASSERT_EQ(0, delays[0]);
+
+    // the data read cleared DRDY
+    _now += 1000;
+    ASSERT_EQ(0x00, readBlock(device, x, y, z));
+    ASSERT_EQ(1, delays.size());
+
+    // two measurements, the first one was overwritten
+    _now += 2 * PERIOD_NS;
+    ASSERT_EQ(0x05, readBlock(device, x, y, z));
+    ASSERT_EQ(3, device.measurements());
+    ASSERT_EQ(2, delays.size());
+    ASSERT_EQ(1000, delays[1]);
+}
+
+TEST_F(SimulatedQMC5883LTest, StatusWithoutData)
+{
+    sp::SimulatedQMC5883L device(_config);
+    start(device);
+    _now += PERIOD_NS;
+
+    // status alone doesn't clear DRDY, data registers do
+    uint8_t status = 0;
+    ASSERT_EQ(1, device.readRegisters(REG_STATUS, 1, &status));
+    ASSERT_EQ(0x01, status);
+    ASSERT_EQ(1, device.readRegisters(REG_STATUS, 1, &status));
+    ASSERT_EQ(0x01, status);
+    uint8_t data[6];
+    ASSERT_EQ(6, device.readRegisters(0x00, 6, data));
+    ASSERT_EQ(1, device.readRegisters(REG_STATUS, 1, &status));
+    ASSERT_EQ(0x00, status);
+}
+
+TEST_F(SimulatedQMC5883LTest, ScriptedHeading)
+{
+    // 10 s north, then a starboard turn of 9 degrees per second for 10 s
+    _config.track = {{10.0, 0.0, 0.0, 0.0}, {10.0, 0.0, 0.0, 9.0}};
+    sp::SimulatedQMC5883L device(_config);
+    ASSERT_EQ(0.0, device.heading(5.0));
+    ASSERT_DOUBLE_EQ(45.0, device.heading(15.0));
+    // repeated from the start
+    ASSERT_EQ(0.0, device.heading(25.0));
+
+    start(device);
+    _now += 15 * 1000000000ULL;
+    int16_t x;
+    int16_t y;
+    int16_t z;
+    readBlock(device, x, y, z);
+    ASSERT_NEAR(45.0, std::atan2(y, x) * 180.0 / M_PI, 0.05);
+}
+
+TEST_F(SimulatedQMC5883LTest, Overflow)
+{
+    _config.hardIron[0] = 3.0;
+    sp::SimulatedQMC5883L device(_config);
+    start(device);
+    _now += PERIOD_NS;
+
+    int16_t x;
+    int16_t y;
+    int16_t z;
+    ASSERT_EQ(0x03, readBlock(device, x, y, z));
+    ASSERT_EQ(INT16_MAX, x);
+
+    // 8 G range, 3000 LSB/G
+    ASSERT_TRUE(device.writeRegister(REG_CONTROL_1, CONTINUOUS_200HZ | 0x10));
+    _now += PERIOD_NS;
+    ASSERT_EQ(0x01, readBlock(device, x, y, z));
+    ASSERT_EQ(9000, x);
+    ASSERT_EQ(1440, z);
+}
+
+TEST_F(SimulatedQMC5883LTest, Temperature)
+{
+    // warming by two degrees a second moves the hard iron on X by 0.01 G, 120 LSB, per degree
+    _config.track = {{60.0, 0.0, 0.0, 0.0}};
+    _config.temperature = 20.0;
+    _config.temperatureRate = 2.0;
+    _config.thermalDrift[0] = 0.01;
+    sp::SimulatedQMC5883L device(_config);
+    ASSERT_DOUBLE_EQ(40.0, device.temperature(10.0));
+
+    start(device);
+    _now += PERIOD_NS;
+    int16_t x;
+    int16_t y;
+    int16_t z;
+    readBlock(device, x, y, z);
+    ASSERT_EQ(2161, x);
+    uint8_t raw[2];
+    ASSERT_EQ(2, device.readRegisters(0x07, 2, raw));
+    ASSERT_EQ(2001, static_cast<int16_t>(raw[0] | (raw[1] << 8)));
+
+    _now += 10 * 1000000000ULL;
+    readBlock(device, x, y, z);
+    ASSERT_EQ(4561, x);
+    ASSERT_EQ(2, device.readRegisters(0x07, 2, raw));
+    ASSERT_EQ(4001, static_cast<int16_t>(raw[0] | (raw[1] << 8)));
+}
@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2026 Mikhail Sapozhnikov
+ *
+ * This file is part of ship-position.
+ *
+ * ship-position is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ship-position is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with ship-position.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "UBXParser.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace sp = ship_position;
+
+namespace
+{
+
+void putU2(std::vector<uint8_t> &payload, size_t offset, uint16_t value)
+{
+    payload[offset] = value & 0xff;
+    payload[offset + 1] = value >> 8;
+}
+
+void putI4(std::vector<uint8_t> &payload, size_t offset, int32_t value)
+{
+    uint32_t v = static_cast<uint32_t>(value);
+    for (int i = 0; i < 4; i++)
+    {
+        payload[offset + i] = (v >> (8 * i)) & 0xff;
+    }
+}
+
+std::vector<uint8_t> makeNavPVT()
+{
+    std::vector<uint8_t> payload(92, 0);
+    putU2(payload, 4, 2026);
+    payload[6] = 10;
+    payload[7] = 16;
+    payload[8] = 17;
+    payload[9] = 2;
+    payload[10] = 57;
+    // valid date and time
+    payload[11] = 0x03;
+    putI4(payload, 16, 250000000);
+    // 3D fix, gnssFixOK
+    payload[20] = 3;
+    payload[21] = 0x01;
+    payload[23] = 9;
+    putI4(payload, 24, 440187135);
+    putI4(payload, 28, -563177480);
+    putI4(payload, 36, 124200);
+    putI4(payload, 60, 5000);
+    putI4(payload, 64, 27050000);
+    putU2(payload, 76, 215);
+    return payload;
+}
+
+}
+
+class UBXParserTest : public ::testing::Test
+{
+public:
+    UBXParserTest() :
+        _parser([this](uint8_t msgClass, uint8_t msgId, const uint8_t *payload, size_t length)
+        {
+            _classes.push_back(msgClass);
+            _ids.push_back(msgId);
+            _payloads.push_back(std::vector<uint8_t>(payload, payload + length));
+        })
+    {
+    }
+
+protected:
+    size_t feed(const std::vector<uint8_t> &data, size_t offset = 0, size_t length = std::string::npos)
+    {
+        length = std::min(length, data.size() - offset);
+        return _parser.feed(reinterpret_cast<const char*>(data.data()) + offset, length);
+    }
+
+    sp::UBXParser _parser;
+    std::vector<uint8_t> _classes;
+    std::vector<uint8_t> _ids;
+    std::vector<std::vector<uint8_t>> _payloads;
+};
+
+TEST_F(UBXParserTest, MakeFrame)
+{
+    // CFG-MSG poll for NAV-PVT, checksum as documented by u-blox
+    std::vector<uint8_t> expected = {0xb5, 0x62, 0x06, 0x01, 0x02, 0x00, 0x01, 0x07, 0x11, 0x3a};
+    ASSERT_EQ(expected, sp::UBXParser::makeFrame(0x06, 0x01, {0x01, 0x07}));
+}
+
+TEST_F(UBXParserTest, SplitBetweenFeeds)
+{
+    std::vector<uint8_t> frame = sp::UBXParser::makeFrame(0x01, 0x07, makeNavPVT());
+    ASSERT_EQ(3, feed(frame, 0, 3));
+    ASSERT_FALSE(_parser.idle());
+    ASSERT_EQ(50, feed(frame, 3, 50));
+    ASSERT_TRUE(_payloads.empty());
+    ASSERT_EQ(frame.size() - 53, feed(frame, 53));
+    ASSERT_TRUE(_parser.idle());
+    ASSERT_EQ(1, _payloads.size());
+    ASSERT_EQ(0x01, _classes[0]);
+    ASSERT_EQ(0x07, _ids[0]);
+    ASSERT_EQ(makeNavPVT(), _payloads[0]);
+    ASSERT_EQ(1, _parser.frames());
+}
+
+TEST_F(UBXParserTest, StopsAtFrameEnd)
+{
+    std::vector<uint8_t> data = sp::UBXParser::makeFrame(0x05, 0x01, {0x06, 0x00});
+    size_t frameLength = data.size();
+    data.push_back('$');
+    ASSERT_EQ(frameLength, feed(data));
+    ASSERT_EQ(1, _payloads.size());
+}
+
+TEST_F(UBXParserTest, NotAFrame)
+{
+    std::vector<uint8_t> data = {0xb5, '$', 'G'};
+    ASSERT_EQ(1, feed(data));
+    ASSERT_TRUE(_parser.idle());
+    ASSERT_TRUE(_payloads.empty());
+}
+
+TEST_F(UBXParserTest, ChecksumError)
+{
+    std::vector<uint8_t> frame = sp::UBXParser::makeFrame(0x01, 0x07, makeNavPVT());
+    frame[20] ^= 0x01;
+    feed(frame);
+    ASSERT_TRUE(_payloads.empty());
+    ASSERT_EQ(1, _parser.checksumErrors());
+    ASSERT_TRUE(_parser.idle());
+}
+
+TEST_F(UBXParserTest, Oversize)
+{
+    std::vector<uint8_t> data = {0xb5, 0x62, 0x01, 0x07, 0xff, 0xff};
+    ASSERT_EQ(data.size(), feed(data));
+    ASSERT_TRUE(_parser.idle());
+    ASSERT_TRUE(_payloads.empty());
+}
+
+TEST(UBXDecode, NavPVT)
+{
+    std::vector<uint8_t> payload = makeNavPVT();
+    sp::GPSInfo gpsInfo;
+    gpsInfo.arrivalNs = 5;
+    ASSERT_TRUE(sp::UBXParser::decodeNavPVT(payload.data(), payload.size(), gpsInfo));
+    ASSERT_EQ(5, gpsInfo.positionArrivalNs);
+
+    ASSERT_NEAR(-56.317748, gpsInfo.latitude, 1e-9);
+    ASSERT_NEAR(44.0187135, gpsInfo.longitude, 1e-9);
+    ASSERT_NEAR(124.2, gpsInfo.altitude, 1e-9);
+    ASSERT_NEAR(9.71922, gpsInfo.speedKnots, 1e-9);
+    ASSERT_NEAR(18.0, gpsInfo.speedKm, 1e-9);
+    ASSERT_NEAR(270.5, gpsInfo.courseOverGround, 1e-9);
+    ASSERT_NEAR(2.15, gpsInfo.pdop, 1e-9);
+    ASSERT_EQ(9, gpsInfo.numSatellites);
+    ASSERT_EQ(1, gpsInfo.fixQuality);
+    ASSERT_EQ(3, gpsInfo.fixMode);
+    ASSERT_EQ(2026, gpsInfo.utcYear);
+    ASSERT_EQ(10, gpsInfo.utcMonth);
+    ASSERT_EQ(16, gpsInfo.utcDay);
+    ASSERT_EQ(17, gpsInfo.utcHours);
+    ASSERT_EQ(2, gpsInfo.utcMinutes);
+    ASSERT_NEAR(57.25, gpsInfo.utcSeconds, 1e-9);
+
+    // no fix: position is kept, fix is reported lost
+    payload[20] = 0;
+    payload[21] = 0;
+    putI4(payload, 28, 0);
+    gpsInfo.arrivalNs = 6;
+    ASSERT_TRUE(sp::UBXParser::decodeNavPVT(payload.data(), payload.size(), gpsInfo));
+    ASSERT_NEAR(-56.317748, gpsInfo.latitude, 1e-9);
+    ASSERT_EQ(5, gpsInfo.positionArrivalNs);
+    ASSERT_EQ(0, gpsInfo.fixQuality);
+    ASSERT_EQ(1, gpsInfo.fixMode);
+
+    ASSERT_FALSE(sp::UBXParser::decodeNavPVT(payload.data(), 91, gpsInfo));
+}
+
+TEST(UBXDecode, NavDOP)
+{
+    std::vector<uint8_t> payload(18, 0);
+    putU2(payload, 6, 215);
+    putU2(payload, 10, 180);
+    putU2(payload, 12, 136);
+    sp::GPSInfo gpsInfo;
+    ASSERT_TRUE(sp::UBXParser::decodeNavDOP(payload.data(), payload.size(), gpsInfo));
+    ASSERT_NEAR(2.15, gpsInfo.pdop, 1e-9);
+    ASSERT_NEAR(1.80, gpsInfo.vdop, 1e-9);
+    ASSERT_NEAR(1.36, gpsInfo.hdop, 1e-9);
+}
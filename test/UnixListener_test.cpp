@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2024 - 2025 Mikhail Sapozhnikov
+ * Copyright (C) 2024 - 2026 Mikhail Sapozhnikov
  *
  * This file is part of ship-position.
  *
@@ -20,6 +20,7 @@
 
 #include "UnixListener.hpp"
 #include "IPCMessages.hpp"
+#include "Clock.hpp"
 #include <gtest/gtest.h>
 #include <sys/un.h>
 #include <sys/socket.h>
@@ -29,6 +30,9 @@ namespace sp = ship_position;
 
 using json = nlohmann::json;
 
+// how old the data of the test readers is
+constexpr uint64_t DATA_AGE_NS = 250000000;
+
 class TestGPSReader : public sp::GPSReader
 {
 public:
@@ -39,6 +43,43 @@ public:
         gpsInfo.longitude = 43.98704;
         gpsInfo.speedKnots = 1.0;
         gpsInfo.speedKm = 1.8;
+        gpsInfo.courseOverGround = 271.5;
+        gpsInfo.altitude = 124.2;
+        gpsInfo.fixQuality = 1;
+        gpsInfo.fixMode = 3;
+        gpsInfo.pdop = 2.67;
+        gpsInfo.hdop = 1.36;
+        gpsInfo.vdop = 2.29;
+        gpsInfo.utcYear = 2024;
+        gpsInfo.utcMonth = 3;
+        gpsInfo.utcDay = 30;
+        gpsInfo.utcHours = 17;
+        gpsInfo.utcMinutes = 2;
+        gpsInfo.utcSeconds = 57.5;
+        gpsInfo.arrivalNs = sp::monotonicNs() - DATA_AGE_NS;
+        gpsInfo.publishNs = gpsInfo.arrivalNs + 1000000;
+    }
+
+    virtual void getNMEAStatistics(sp::NMEAStatistics &statistics)
+    {
+        statistics.counters[0].valid = 120;
+        statistics.counters[0].invalid = 2;
+        statistics.counters[0].truncated = 1;
+    }
+
+    virtual void getSatellites(sp::SatelliteTable &satellites)
+    {
+        satellites.count = 2;
+        satellites.system[0] = sp::GNSSSystem::GPS;
+        satellites.prn[0] = 2;
+        satellites.elevation[0] = 27;
+        satellites.azimuth[0] = 297;
+        satellites.snr[0] = 26;
+        satellites.system[1] = sp::GNSSSystem::BEIDOU;
+        satellites.prn[1] = 11;
+        satellites.elevation[1] = -1;
+        satellites.azimuth[1] = -1;
+        satellites.snr[1] = -1;
     }
 };
 
@@ -50,10 +91,100 @@ public:
         magnetometerData.x = 777;
         magnetometerData.y = 98639;
         magnetometerData.z = -84;
+        magnetometerData.temperature = 31.25;
+        magnetometerData.arrivalNs = sp::monotonicNs() - DATA_AGE_NS;
+        magnetometerData.publishNs = magnetometerData.arrivalNs + 1000;
+    }
+
+    virtual void getMagnetometerSamples(size_t count, std::vector<sp::MagnetometerData> &samples)
+    {
+        for (size_t i = 0; i < std::min<size_t>(count, 3); i++)
+        {
+            sp::MagnetometerData data;
+            data.x = 100 + i;
+            data.y = 200 + i;
+            data.z = 300 + i;
+            data.arrivalNs = sp::monotonicNs() - DATA_AGE_NS + i * 5000000;
+            samples.push_back(data);
+        }
+    }
+
+    virtual void getHeading(sp::HeadingData &heading)
+    {
+        heading.magneticHeading = 271.5;
+        heading.trueHeading = 283.0;
+        heading.arrivalNs = sp::monotonicNs() - DATA_AGE_NS;
+        heading.publishNs = heading.arrivalNs + 1000;
+    }
+
+    virtual void getMagnetometerStatistics(sp::MagnetometerStatistics &statistics)
+    {
+        statistics.samples = 5000;
+        statistics.dropped = 3;
+        statistics.duplicates = 17;
+        statistics.readErrors = 1;
+        statistics.lastArrivalNs = sp::monotonicNs() - DATA_AGE_NS;
+    }
+
+    virtual void getCalibrationStatus(sp::CalibrationStatus &status)
+    {
+        status.calibrating = true;
+        status.complete = false;
+        status.samples = 412;
+        status.coverage = 0.625;
+        status.headingCoverage = 1.0;
+        status.residual = 0.031;
+        status.temperatureSpan = 6.5;
+        status.arrivalNs = sp::monotonicNs() - DATA_AGE_NS;
+    }
+
+    virtual void getTemperatureCompensation(sp::TemperatureCompensation &compensation)
+    {
+        compensation.temperature = 31.25;
+        compensation.coefficients[0] = -12.0;
+        compensation.coefficients[1] = 7.5;
+        compensation.coefficients[2] = 4.0;
+        compensation.referenceTemperature = 21.25;
+        compensation.arrivalNs = sp::monotonicNs() - DATA_AGE_NS;
+        compensation.correction[0] = -120.0;
+        compensation.correction[1] = 75.0;
+        compensation.correction[2] = 40.0;
     }
 
     virtual void startCalibration() {}
-    virtual void stopCalibration() {}
+    virtual bool stopCalibration() { return true; }
+};
+
+class TestFusionReader : public sp::FusionReader
+{
+public:
+    virtual void getFusedState(sp::FusedState &state)
+    {
+        state.valid = true;
+        state.deadReckoning = true;
+        state.latitude = 56.317748;
+        state.longitude = 44.0187135;
+        state.speedKnots = 9.5;
+        state.courseOverGround = 93.0;
+        state.heading = 88.5;
+        state.turnRate = -1.25;
+        state.currentKnots = 0.8;
+        state.currentDirection = 170.0;
+        state.positionError = 12.5;
+        state.headingError = 1.5;
+        state.arrivalNs = sp::monotonicNs() - DATA_AGE_NS;
+        state.fixArrivalNs = state.arrivalNs - 3000000000ULL;
+        state.publishNs = state.arrivalNs + 1000;
+    }
+
+    virtual void getFusionStatistics(sp::FusionStatistics &statistics)
+    {
+        statistics.fixes = 3600;
+        statistics.headings = 36000;
+        statistics.rejectedFixes = 2;
+        statistics.resets = 1;
+        statistics.lastArrivalNs = sp::monotonicNs() - DATA_AGE_NS;
+    }
 };
 
 class UnixListenerTest : public ::testing::Test
@@ -71,6 +202,7 @@ protected:
     sp::UnixListener *_unixListener;
     TestGPSReader _gpsReader;
     TestMagnetometerReader _magnetometerReader;
+    TestFusionReader _fusionReader;
     sp::Log *_log;
 };
 
@@ -81,7 +213,7 @@ UnixListenerTest::UnixListenerTest()
     _ipcConfig.bufSize = 4096;
     _ipcConfig.socketPath = _socketPath;
 
-    _unixListener = new sp::UnixListener(_ipcConfig, _gpsReader, _magnetometerReader);
+    _unixListener = new sp::UnixListener(_ipcConfig, _gpsReader, _magnetometerReader, _fusionReader);
 }
 
 UnixListenerTest::~UnixListenerTest()
@@ -170,6 +302,22 @@ TEST_F(UnixListenerTest, GetGPSData)
     EXPECT_EQ(43.98704, resp.longitude);
     EXPECT_EQ(1.0, resp.speedKnots);
     EXPECT_EQ(1.8, resp.speedKm);
+    EXPECT_EQ(271.5, resp.courseOverGround);
+    EXPECT_EQ(124.2, resp.altitude);
+    EXPECT_EQ(1, resp.fixQuality);
+    EXPECT_EQ(3, resp.fixMode);
+    EXPECT_EQ(2.67, resp.pdop);
+    EXPECT_EQ(1.36, resp.hdop);
+    EXPECT_EQ(2.29, resp.vdop);
+    EXPECT_EQ(2024, resp.utcYear);
+    EXPECT_EQ(3, resp.utcMonth);
+    EXPECT_EQ(30, resp.utcDay);
+    EXPECT_EQ(17, resp.utcHours);
+    EXPECT_EQ(2, resp.utcMinutes);
+    EXPECT_EQ(57.5, resp.utcSeconds);
+    EXPECT_EQ(resp.arrivalNs + 1000000, resp.publishNs);
+    EXPECT_GE(resp.ageMs, DATA_AGE_NS / 1e6);
+    EXPECT_LT(resp.ageMs, DATA_AGE_NS / 1e6 + 1000.0);
 
     close(sockfd);
 }
@@ -217,6 +365,427 @@ TEST_F(UnixListenerTest, GetMagnetometerData)
     EXPECT_EQ(777, resp.x);
     EXPECT_EQ(98639, resp.y);
     EXPECT_EQ(-84, resp.z);
+    EXPECT_DOUBLE_EQ(31.25, resp.temperature);
+    EXPECT_EQ(resp.arrivalNs + 1000, resp.publishNs);
+    EXPECT_GE(resp.ageMs, DATA_AGE_NS / 1e6);
+    EXPECT_LT(resp.ageMs, DATA_AGE_NS / 1e6 + 1000.0);
+
+    close(sockfd);
+}
+
+TEST_F(UnixListenerTest, GetNMEAStatistics)
+{
+    char buf[4096];
+    std::memset(reinterpret_cast<void *>(buf), 0, sizeof(buf));
+
+    int sockfd = connectClient();
+    if (sockfd == -1)
+    {
+        FAIL();
+    }
+
+    sp::IPCRequest rq;
+    rq.cmd = rq.cmdGetNMEAStatistics;
+    json rqJson = rq;
+    std::string rqStr = rqJson.dump();
+
+    if (write(sockfd, rqStr.c_str(), rqStr.length()) == -1)
+    {
+        _log->write(sp::LogLevel::ERROR, "UnixListenerTest failed to write to client socket: %d\n", errno);
+        close(sockfd);
+        FAIL();
+    }
+
+    int numRead = read(sockfd, reinterpret_cast<void *>(buf), 4096);
+    if (numRead == -1)
+    {
+        _log->write(sp::LogLevel::ERROR, "UnixListenerTest failed to read from client socket: %d\n", errno);
+        close(sockfd);
+        FAIL();
+    }
+
+    json respJson = json::parse(buf);
+    sp::NMEAStatisticsResponse resp = respJson.get<sp::NMEAStatisticsResponse>();
+
+    EXPECT_EQ(sp::NMEAStatistics::NUM_TYPES, resp.sentences.size());
+    EXPECT_EQ(120, resp.sentences["GGA"].valid);
+    EXPECT_EQ(2, resp.sentences["GGA"].invalid);
+    EXPECT_EQ(1, resp.sentences["GGA"].truncated);
+    EXPECT_EQ(0, resp.sentences["VTG"].valid);
+    // nothing was received
+    EXPECT_EQ(-1.0, resp.ageMs);
+
+    close(sockfd);
+}
+
+TEST_F(UnixListenerTest, GetSatellites)
+{
+    char buf[4096];
+    std::memset(reinterpret_cast<void *>(buf), 0, sizeof(buf));
+
+    int sockfd = connectClient();
+    if (sockfd == -1)
+    {
+        FAIL();
+    }
+
+    sp::IPCRequest rq;
+    rq.cmd = rq.cmdGetSatellites;
+    json rqJson = rq;
+    std::string rqStr = rqJson.dump();
+
+    if (write(sockfd, rqStr.c_str(), rqStr.length()) == -1)
+    {
+        _log->write(sp::LogLevel::ERROR, "UnixListenerTest failed to write to client socket: %d\n", errno);
+        close(sockfd);
+        FAIL();
+    }
+
+    int numRead = read(sockfd, reinterpret_cast<void *>(buf), 4096);
+    if (numRead == -1)
+    {
+        _log->write(sp::LogLevel::ERROR, "UnixListenerTest failed to read from client socket: %d\n", errno);
+        close(sockfd);
+        FAIL();
+    }
+
+    json respJson = json::parse(buf);
+    sp::SatellitesResponse resp = respJson.get<sp::SatellitesResponse>();
+
+    ASSERT_EQ(2, resp.satellites.size());
+    EXPECT_EQ("GPS", resp.satellites[0].system);
+    EXPECT_EQ(2, resp.satellites[0].prn);
+    EXPECT_EQ(27, resp.satellites[0].elevation);
+    EXPECT_EQ(297, resp.satellites[0].azimuth);
+    EXPECT_EQ(26, resp.satellites[0].snr);
+    EXPECT_EQ("BeiDou", resp.satellites[1].system);
+    EXPECT_EQ(11, resp.satellites[1].prn);
+    EXPECT_EQ(-1, resp.satellites[1].snr);
+
+    close(sockfd);
+}
+TEST_F(UnixListenerTest, GetMagnetometerStatistics)
+{
+    char buf[4096];
+    std::memset(reinterpret_cast<void *>(buf), 0, sizeof(buf));
+
+    int sockfd = connectClient();
+    if (sockfd == -1)
+    {
+        FAIL();
+    }
+
+    sp::IPCRequest rq;
+    rq.cmd = rq.cmdGetMagnetometerStatistics;
+    json rqJson = rq;
+    std::string rqStr = rqJson.dump();
+
+    if (write(sockfd, rqStr.c_str(), rqStr.length()) == -1)
+    {
+        _log->write(sp::LogLevel::ERROR, "UnixListenerTest failed to write to client socket: %d\n", errno);
+        close(sockfd);
+        FAIL();
+    }
+
+    int numRead = read(sockfd, reinterpret_cast<void *>(buf), 4096);
+    if (numRead == -1)
+    {
+        _log->write(sp::LogLevel::ERROR, "UnixListenerTest failed to read from client socket: %d\n", errno);
+        close(sockfd);
+        FAIL();
+    }
+
+    json respJson = json::parse(buf);
+    sp::MagnetometerStatisticsResponse resp = respJson.get<sp::MagnetometerStatisticsResponse>();
+
+    EXPECT_EQ(5000, resp.samples);
+    EXPECT_EQ(3, resp.dropped);
+    EXPECT_EQ(17, resp.duplicates);
+    EXPECT_EQ(1, resp.readErrors);
+    EXPECT_GE(resp.ageMs, DATA_AGE_NS / 1e6);
+    EXPECT_LT(resp.ageMs, DATA_AGE_NS / 1e6 + 1000.0);
 
     close(sockfd);
-}
\ No newline at end of file
+}
+
+TEST_F(UnixListenerTest, GetMagnetometerSamples)
+{
+    char buf[4096];
+    std::memset(reinterpret_cast<void *>(buf), 0, sizeof(buf));
+
+    int sockfd = connectClient();
+    if (sockfd == -1)
+    {
+        FAIL();
+    }
+
+    sp::IPCRequest rq;
+    rq.cmd = rq.cmdGetMagnetometerSamples;
+    rq.count = 2;
+    json rqJson = rq;
+    std::string rqStr = rqJson.dump();
+
+    if (write(sockfd, rqStr.c_str(), rqStr.length()) == -1)
+    {
+        _log->write(sp::LogLevel::ERROR, "UnixListenerTest failed to write to client socket: %d\n", errno);
+        close(sockfd);
+        FAIL();
+    }
+
+    int numRead = read(sockfd, reinterpret_cast<void *>(buf), 4096);
+    if (numRead == -1)
+    {
+        _log->write(sp::LogLevel::ERROR, "UnixListenerTest failed to read from client socket: %d\n", errno);
+        close(sockfd);
+        FAIL();
+    }
+
+    json respJson = json::parse(buf);
+    sp::MagnetometerSamplesResponse resp = respJson.get<sp::MagnetometerSamplesResponse>();
+
+    ASSERT_EQ(2, resp.samples.size());
+    EXPECT_EQ(100, resp.samples[0].x);
+    EXPECT_EQ(301, resp.samples[1].z);
+    EXPECT_GT(resp.samples[0].ageMs, resp.samples[1].ageMs);
+    EXPECT_EQ(resp.samples[1].ageMs, resp.ageMs);
+
+    close(sockfd);
+}
+
+TEST_F(UnixListenerTest, GetHeading)
+{
+    char buf[4096];
+    std::memset(reinterpret_cast<void *>(buf), 0, sizeof(buf));
+
+    int sockfd = connectClient();
+    if (sockfd == -1)
+    {
+        FAIL();
+    }
+
+    sp::IPCRequest rq;
+    rq.cmd = rq.cmdGetHeading;
+    json rqJson = rq;
+    std::string rqStr = rqJson.dump();
+
+    if (write(sockfd, rqStr.c_str(), rqStr.length()) == -1)
+    {
+        _log->write(sp::LogLevel::ERROR, "UnixListenerTest failed to write to client socket: %d\n", errno);
+        close(sockfd);
+        FAIL();
+    }
+
+    int numRead = read(sockfd, reinterpret_cast<void *>(buf), 4096);
+    if (numRead == -1)
+    {
+        _log->write(sp::LogLevel::ERROR, "UnixListenerTest failed to read from client socket: %d\n", errno);
+        close(sockfd);
+        FAIL();
+    }
+
+    json respJson = json::parse(buf);
+    sp::HeadingResponse resp = respJson.get<sp::HeadingResponse>();
+
+    EXPECT_DOUBLE_EQ(271.5, resp.magneticHeading);
+    EXPECT_DOUBLE_EQ(283.0, resp.trueHeading);
+    EXPECT_EQ(resp.arrivalNs + 1000, resp.publishNs);
+    EXPECT_GE(resp.ageMs, DATA_AGE_NS / 1e6);
+    EXPECT_LT(resp.ageMs, DATA_AGE_NS / 1e6 + 1000.0);
+
+    close(sockfd);
+}
+
+TEST_F(UnixListenerTest, GetCalibrationStatus)
+{
+    char buf[4096];
+    std::memset(reinterpret_cast<void *>(buf), 0, sizeof(buf));
+
+    int sockfd = connectClient();
+    if (sockfd == -1)
+    {
+        FAIL();
+    }
+
+    sp::IPCRequest rq;
+    rq.cmd = rq.cmdGetCalibrationStatus;
+    json rqJson = rq;
+    std::string rqStr = rqJson.dump();
+
+    if (write(sockfd, rqStr.c_str(), rqStr.length()) == -1)
+    {
+        _log->write(sp::LogLevel::ERROR, "UnixListenerTest failed to write to client socket: %d\n", errno);
+        close(sockfd);
+        FAIL();
+    }
+
+    int numRead = read(sockfd, reinterpret_cast<void *>(buf), 4096);
+    if (numRead == -1)
+    {
+        _log->write(sp::LogLevel::ERROR, "UnixListenerTest failed to read from client socket: %d\n", errno);
+        close(sockfd);
+        FAIL();
+    }
+
+    json respJson = json::parse(buf);
+    sp::CalibrationStatusResponse resp = respJson.get<sp::CalibrationStatusResponse>();
+
+    EXPECT_TRUE(resp.calibrating);
+    EXPECT_FALSE(resp.complete);
+    EXPECT_EQ(412, resp.samples);
+    EXPECT_DOUBLE_EQ(0.625, resp.coverage);
+    EXPECT_DOUBLE_EQ(1.0, resp.headingCoverage);
+    EXPECT_DOUBLE_EQ(0.031, resp.residual);
+    EXPECT_DOUBLE_EQ(6.5, resp.temperatureSpan);
+    EXPECT_GE(resp.ageMs, DATA_AGE_NS / 1e6);
+    EXPECT_LT(resp.ageMs, DATA_AGE_NS / 1e6 + 1000.0);
+
+    close(sockfd);
+}
+
+TEST_F(UnixListenerTest, GetTemperatureCompensation)
+{
+    char buf[4096];
+    std::memset(reinterpret_cast<void *>(buf), 0, sizeof(buf));
+
+    int sockfd = connectClient();
+    if (sockfd == -1)
+    {
+        FAIL();
+    }
+
+    sp::IPCRequest rq;
+    rq.cmd = rq.cmdGetTemperatureCompensation;
+    json rqJson = rq;
+    std::string rqStr = rqJson.dump();
+
+    if (write(sockfd, rqStr.c_str(), rqStr.length()) == -1)
+    {
+        _log->write(sp::LogLevel::ERROR, "UnixListenerTest failed to write to client socket: %d\n", errno);
+        close(sockfd);
+        FAIL();
+    }
+
+    int numRead = read(sockfd, reinterpret_cast<void *>(buf), 4096);
+    if (numRead == -1)
+    {
+        _log->write(sp::LogLevel::ERROR, "UnixListenerTest failed to read from client socket: %d\n", errno);
+        close(sockfd);
+        FAIL();
+    }
+
+    json respJson = json::parse(buf);
+    sp::TemperatureCompensationResponse resp = respJson.get<sp::TemperatureCompensationResponse>();
+
+    EXPECT_DOUBLE_EQ(31.25, resp.temperature);
+    ASSERT_EQ(3, resp.coefficients.size());
+    EXPECT_DOUBLE_EQ(-12.0, resp.coefficients[0]);
+    EXPECT_DOUBLE_EQ(7.5, resp.coefficients[1]);
+    EXPECT_DOUBLE_EQ(4.0, resp.coefficients[2]);
+    EXPECT_DOUBLE_EQ(21.25, resp.referenceTemperature);
+    ASSERT_EQ(3, resp.correction.size());
+    EXPECT_DOUBLE_EQ(-120.0, resp.correction[0]);
+    EXPECT_DOUBLE_EQ(40.0, resp.correction[2]);
+    EXPECT_GE(resp.ageMs, DATA_AGE_NS / 1e6);
+    EXPECT_LT(resp.ageMs, DATA_AGE_NS / 1e6 + 1000.0);
+
+    close(sockfd);
+}
+
+TEST_F(UnixListenerTest, GetFusedPosition)
+{
+    char buf[4096];
+    std::memset(reinterpret_cast<void *>(buf), 0, sizeof(buf));
+
+    int sockfd = connectClient();
+    if (sockfd == -1)
+    {
+        FAIL();
+    }
+
+    sp::IPCRequest rq;
+    rq.cmd = rq.cmdGetFusedPosition;
+    json rqJson = rq;
+    std::string rqStr = rqJson.dump();
+
+    if (write(sockfd, rqStr.c_str(), rqStr.length()) == -1)
+    {
+        _log->write(sp::LogLevel::ERROR, "UnixListenerTest failed to write to client socket: %d\n", errno);
+        close(sockfd);
+        FAIL();
+    }
+
+    int numRead = read(sockfd, reinterpret_cast<void *>(buf), 4096);
+    if (numRead == -1)
+    {
+        _log->write(sp::LogLevel::ERROR, "UnixListenerTest failed to read from client socket: %d\n", errno);
+        close(sockfd);
+        FAIL();
+    }
+
+    json respJson = json::parse(buf);
+    sp::FusedPositionResponse resp = respJson.get<sp::FusedPositionResponse>();
+
+    EXPECT_TRUE(resp.valid);
+    EXPECT_TRUE(resp.deadReckoning);
+    EXPECT_DOUBLE_EQ(56.317748, resp.latitude);
+    EXPECT_DOUBLE_EQ(44.0187135, resp.longitude);
+    EXPECT_DOUBLE_EQ(9.5, resp.speedKnots);
+    EXPECT_DOUBLE_EQ(93.0, resp.courseOverGround);
+    EXPECT_DOUBLE_EQ(88.5, resp.heading);
+    EXPECT_DOUBLE_EQ(-1.25, resp.turnRate);
+    EXPECT_DOUBLE_EQ(0.8, resp.currentKnots);
+    EXPECT_DOUBLE_EQ(170.0, resp.currentDirection);
+    EXPECT_DOUBLE_EQ(12.5, resp.positionError);
+    EXPECT_DOUBLE_EQ(1.5, resp.headingError);
+    EXPECT_EQ(resp.arrivalNs + 1000, resp.publishNs);
+    EXPECT_GE(resp.ageMs, DATA_AGE_NS / 1e6);
+    EXPECT_GE(resp.fixAgeMs, resp.ageMs + 3000.0);
+    EXPECT_LT(resp.fixAgeMs, resp.ageMs + 4000.0);
+
+    close(sockfd);
+}
+
+
+TEST_F(UnixListenerTest, GetFusionStatistics)
+{
+    char buf[4096];
+    std::memset(reinterpret_cast<void *>(buf), 0, sizeof(buf));
+
+    int sockfd = connectClient();
+    if (sockfd == -1)
+    {
+        FAIL();
+    }
+
+    sp::IPCRequest rq;
+    rq.cmd = rq.cmdGetFusionStatistics;
+    json rqJson = rq;
+    std::string rqStr = rqJson.dump();
+
+    if (write(sockfd, rqStr.c_str(), rqStr.length()) == -1)
+    {
+        _log->write(sp::LogLevel::ERROR, "UnixListenerTest failed to write to client socket: %d\n", errno);
+        close(sockfd);
+        FAIL();
+    }
+
+    int numRead = read(sockfd, reinterpret_cast<void *>(buf), 4096);
+    if (numRead == -1)
+    {
+        _log->write(sp::LogLevel::ERROR, "UnixListenerTest failed to read from client socket: %d\n", errno);
+        close(sockfd);
+        FAIL();
+    }
+
+    json respJson = json::parse(buf);
+    sp::FusionStatisticsResponse resp = respJson.get<sp::FusionStatisticsResponse>();
+
+    EXPECT_EQ(3600, resp.fixes);
+    EXPECT_EQ(36000, resp.headings);
+    EXPECT_EQ(2, resp.rejectedFixes);
+    EXPECT_EQ(1, resp.resets);
+    EXPECT_GE(resp.ageMs, DATA_AGE_NS / 1e6);
+    EXPECT_LT(resp.ageMs, DATA_AGE_NS / 1e6 + 1000.0);
+
+    close(sockfd);
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2024 Mikhail Sapozhnikov
+ * Copyright (C) 2024 - 2026 Mikhail Sapozhnikov
  *
  * This file is part of ship-position.
  *
@@ -37,4 +37,5 @@ int main(int argc, char *argv[])
     sp::Log::release();
 }
 
-void signal_handler(int signum) {}
\ No newline at end of file
+// ShipPosition.cpp refers to the daemon's signal handler, defined in main.cpp
+void signal_handler(int) {}
\ No newline at end of file